@@ -63,7 +63,10 @@ function check_bullet_built()
     # Check for a library that's created when bullet is built   
     fname=$(find "$BULLET_BUILD_DIR" -iname libBulletCollision.* 2>/dev/null)
     if [ -f "$fname" ]; then
-        return $TRUE
+        # Older environments were built with the profiler, rebuild those
+        if grep -q "BT_NO_PROFILE" "$BULLET_BUILD_DIR/CMakeCache.txt" 2>/dev/null; then
+            return $TRUE
+        fi
     fi
     return $FALSE
 }
@@ -158,12 +161,15 @@ function build_bullet()
 
     # Perform the build
     # If you turn double precision on, turn it on in inc.CMakeBullet.txt as well for the NTRT build
+    # BT_NO_PROFILE turns off Bullet's profiler, whose global state cannot
+    # be shared by the threads of tgSimulationPool. It must match the NTRT
+    # build (inc.CMakeBullet.txt), since it changes the layout of DemoApplication
     "$ENV_DIR/bin/cmake" . -G "Unix Makefiles" \
         -DBUILD_SHARED_LIBS=OFF \
         -DBUILD_EXTRAS=ON \
         -DCMAKE_INSTALL_PREFIX="$BULLET_INSTALL_PREFIX" \
-        -DCMAKE_C_FLAGS="-fPIC" \
-        -DCMAKE_CXX_FLAGS="-fPIC" \
+        -DCMAKE_C_FLAGS="-fPIC -DBT_NO_PROFILE" \
+        -DCMAKE_CXX_FLAGS="-fPIC -DBT_NO_PROFILE" \
         -DCMAKE_C_COMPILER="gcc" \
         -DCMAKE_CXX_COMPILER="g++" \
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
@@ -27,6 +27,7 @@
 #include "tgBasicController.h"
 
 #include "core/tgControllable.h"
+#include "core/tgSimulationState.h"
 
 // The C++ Standard Library
 #include <cassert>
@@ -74,4 +75,12 @@ void tgBasicController::setNewSetPoint(double newSetPoint)
 	m_setPoint = newSetPoint;
 }
 
+void tgBasicController::saveState(tgSimulationState& state) const
+{
+	state.write(m_setPoint);
+}
 
+void tgBasicController::restoreState(tgSimulationState& state)
+{
+	m_setPoint = state.read();
+}
@@ -29,6 +29,7 @@
 
 // Forward declarations
 class tgControllable;
+class tgSimulationState;
 
 /**
  * The simplest possible controller. Naively passes its setpoint
@@ -74,6 +75,19 @@ public:
      */
 	virtual void setNewSetPoint(double newSetPoint);
 	
+	/**
+	 * Write the setpoint, for controllers whose observers are asked to
+	 * save their state by tgSimulation::saveState
+	 * @param[in,out] state the state being saved
+	 */
+	virtual void saveState(tgSimulationState& state) const;
+	
+	/**
+	 * Read back what saveState wrote
+	 * @param[in,out] state the state being restored
+	 */
+	virtual void restoreState(tgSimulationState& state);
+	
 	/**
 	 * Return a const pointer to a const tgControllable.
 	 * Current solution to obtaining sensor data (requires casting
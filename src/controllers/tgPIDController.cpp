@@ -28,6 +28,7 @@
 #include "tgPIDController.h"
 
 #include "core/tgControllable.h"
+#include "core/tgSimulationState.h"
 
 // The C++ Standard Library
 #include <stdexcept>
@@ -114,3 +115,19 @@ void tgPIDController::setSensorData(double sensorData)
 	/// @todo - are there any sanity checks we can enforce here?
 	m_sensorData = sensorData;
 }
+
+void tgPIDController::saveState(tgSimulationState& state) const
+{
+	tgBasicController::saveState(state);
+	state.write(m_sensorData);
+	state.write(m_prevError);
+	state.write(m_intError);
+}
+
+void tgPIDController::restoreState(tgSimulationState& state)
+{
+	tgBasicController::restoreState(state);
+	m_sensorData = state.read();
+	m_prevError = state.read();
+	m_intError = state.read();
+}
@@ -132,6 +132,19 @@ public:
 	 */
 	virtual void setSensorData(double sensorData);
 	
+	/**
+	 * Write the setpoint, sensor data and error history
+	 * @param[in,out] state the state being saved
+	 */
+	virtual void saveState(tgSimulationState& state) const;
+	
+	/**
+	 * Read back what saveState wrote, so the integral and derivative
+	 * terms continue from where they were saved
+	 * @param[in,out] state the state being restored
+	 */
+	virtual void restoreState(tgSimulationState& state);
+	
 	/// @todo should we have a getSensorData function? Might make code changes simpler later
 	
 private:
@@ -0,0 +1,258 @@
+/**
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file tgHeightfieldGround.cpp
+ * @brief Contains the implementation of class tgHeightfieldGround
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+//This Module
+#include "tgHeightfieldGround.h"
+
+//Bullet Physics
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btDefaultMotionState.h"
+#include "LinearMath/btTransform.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+// POSIX, for mapping height files
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * Pre-condition: heights points at config.m_nx * config.m_ny values
+     * Post-condition: Returns a heightfield over them, which reads them
+     * in place, and sets center to where its local origin lies relative
+     * to the ground's origin
+     */
+    template <class T>
+    btHeightfieldTerrainShape* createShape(const tgHeightfieldGround::Config& config,
+                                           const T* heights,
+                                           PHY_ScalarType type,
+                                           btVector3& center)
+    {
+        assert(heights);
+        const std::size_t nodeCount = config.m_nx * config.m_ny;
+
+        // One pass over the heights, so a mapped file is read once here
+        T minHeight = heights[0];
+        T maxHeight = heights[0];
+        for (std::size_t i = 1; i < nodeCount; i++)
+        {
+            minHeight = std::min(minHeight, heights[i]);
+            maxHeight = std::max(maxHeight, heights[i]);
+        }
+
+        // Scale the shape rather than the heights, so this works the
+        // same for every type
+        const btScalar heightScale = 1.0;
+        const int upAxis = 1;
+        // Split each quad along the same diagonal as tgHillyGround's triangles
+        const bool flipQuadEdges = true;
+        btHeightfieldTerrainShape* const pShape =
+            new btHeightfieldTerrainShape(static_cast<int>(config.m_nx),
+                                          static_cast<int>(config.m_ny),
+                                          heights,
+                                          heightScale,
+                                          minHeight,
+                                          maxHeight,
+                                          upAxis,
+                                          type,
+                                          flipQuadEdges);
+        pShape->setLocalScaling(btVector3(config.m_gridSpacing,
+                                          config.m_heightScale,
+                                          config.m_gridSpacing));
+        pShape->setMargin(config.m_margin);
+
+        // Bullet puts node i at (i - (m_nx - 1) / 2), we want (i - m_nx / 2)
+        center.setValue(-0.5 * config.m_gridSpacing,
+                        0.5 * (minHeight + maxHeight) * config.m_heightScale,
+                        -0.5 * config.m_gridSpacing);
+        return pShape;
+    }
+}
+
+tgHeightfieldGround::Config::Config(btVector3 eulerAngles,
+        double friction,
+        double restitution,
+        btVector3 origin,
+        std::size_t nx,
+        std::size_t ny,
+        double gridSpacing,
+        double heightScale,
+        double margin) :
+    m_eulerAngles(eulerAngles),
+    m_friction(friction),
+    m_restitution(restitution),
+    m_origin(origin),
+    m_nx(nx),
+    m_ny(ny),
+    m_gridSpacing(gridSpacing),
+    m_heightScale(heightScale),
+    m_margin(margin)
+{
+    assert((m_friction >= 0.0) && (m_friction <= 1.0));
+    assert((m_restitution >= 0.0) && (m_restitution <= 1.0));
+    // Bullet needs at least one quad
+    assert(m_nx > 1);
+    assert(m_ny > 1);
+    assert(m_gridSpacing > 0.0);
+    assert(m_heightScale > 0.0);
+    assert(m_margin >= 0.0);
+}
+
+tgHeightfieldGround::Config
+tgHeightfieldGround::hillyConfig(const tgHillyGround::Config& config)
+{
+    return Config(config.m_eulerAngles,
+                  config.m_friction,
+                  config.m_restitution,
+                  config.m_origin,
+                  config.m_nx,
+                  config.m_ny,
+                  config.m_triangleSize,
+                  1.0,
+                  config.m_margin);
+}
+
+tgHeightfieldGround::tgHeightfieldGround(const tgHillyGround::Config& config) :
+    m_config(hillyConfig(config)),
+    m_heights(config.m_nx * config.m_ny),
+    m_pMapped(NULL),
+    m_mappedSize(0)
+{
+    for (std::size_t i = 0; i < config.m_nx; i++)
+    {
+        for (std::size_t j = 0; j < config.m_ny; j++)
+        {
+            m_heights[i + (j * config.m_nx)] =
+                tgHillyGround::hillHeight(config, i, j);
+        }
+    }
+    pGroundShape = createShape(m_config, &m_heights[0], PHY_FLOAT, m_center);
+}
+
+tgHeightfieldGround::tgHeightfieldGround(const tgHeightfieldGround::Config& config,
+                                         const std::vector<btScalar>& heights) :
+    m_config(config),
+    m_heights(heights),
+    m_pMapped(NULL),
+    m_mappedSize(0)
+{
+    if (m_heights.size() != m_config.m_nx * m_config.m_ny)
+    {
+        throw std::invalid_argument("Heightfield needs nx * ny heights");
+    }
+    // Bullet reads PHY_FLOAT heights as btScalars
+    pGroundShape = createShape(m_config, &m_heights[0], PHY_FLOAT, m_center);
+}
+
+tgHeightfieldGround::tgHeightfieldGround(const tgHeightfieldGround::Config& config,
+                                         const std::string& fileName) :
+    m_config(config),
+    m_pMapped(NULL),
+    m_mappedSize(0)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open heightfield file " + fileName);
+    }
+
+    struct stat info;
+    const std::size_t expectedSize =
+        m_config.m_nx * m_config.m_ny * sizeof(short);
+    if (fstat(fd, &info) != 0 ||
+        static_cast<std::size_t>(info.st_size) != expectedSize)
+    {
+        close(fd);
+        throw std::runtime_error("Heightfield file " + fileName +
+                                 " does not hold nx * ny shorts");
+    }
+
+    void* const pMapped = mmap(NULL, expectedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file is closed
+    close(fd);
+    if (pMapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not map heightfield file " + fileName);
+    }
+
+    m_pMapped = pMapped;
+    m_mappedSize = expectedSize;
+    pGroundShape = createShape(m_config, static_cast<const short*>(m_pMapped),
+                               PHY_SHORT, m_center);
+}
+
+tgHeightfieldGround::~tgHeightfieldGround()
+{
+    // The shape reads the heights until it is gone
+    delete pGroundShape;
+    pGroundShape = NULL;
+
+    if (m_pMapped != NULL)
+    {
+        munmap(m_pMapped, m_mappedSize);
+    }
+}
+
+btRigidBody* tgHeightfieldGround::getGroundRigidBody() const
+{
+    const btScalar mass = 0.0;
+
+    btTransform groundTransform;
+    groundTransform.setIdentity();
+    groundTransform.setOrigin(m_config.m_origin);
+
+    btQuaternion orientation;
+    orientation.setEuler(m_config.m_eulerAngles[0], // Yaw
+                         m_config.m_eulerAngles[1], // Pitch
+                         m_config.m_eulerAngles[2]); // Roll
+    groundTransform.setRotation(orientation);
+
+    // Move the shape's center to where it lies on the grid
+    btTransform centerTransform;
+    centerTransform.setIdentity();
+    centerTransform.setOrigin(m_center);
+    groundTransform = groundTransform * centerTransform;
+
+    // Using motionstate is recommended
+    // It provides interpolation capabilities, and only synchronizes 'active' objects
+    btDefaultMotionState* const pMotionState =
+        new btDefaultMotionState(groundTransform);
+
+    const btVector3 localInertia(0, 0, 0);
+
+    btRigidBody::btRigidBodyConstructionInfo const rbInfo(mass, pMotionState, pGroundShape, localInertia);
+
+    btRigidBody* const pGroundBody = new btRigidBody(rbInfo);
+
+    assert(pGroundBody);
+    return pGroundBody;
+}
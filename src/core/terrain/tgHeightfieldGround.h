@@ -0,0 +1,162 @@
+/**
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef CORE_TERRAIN_TG_HEIGHTFIELD_GROUND_H
+#define CORE_TERRAIN_TG_HEIGHTFIELD_GROUND_H
+
+/**
+ * @file tgHeightfieldGround.h
+ * @brief Contains the definition of class tgHeightfieldGround.
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+#include "tgBulletGround.h"
+#include "tgHillyGround.h"
+
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class btRigidBody;
+
+/**
+ * A ground given by a regular grid of heights, collided against with a
+ * btHeightfieldTerrainShape. Bullet reads the heights where they are
+ * instead of building a vertex array and a BVH, so large grids take a
+ * fraction of the memory of a tgHillyGround and are ready immediately.
+ * The heights are either copied from a vector, or mapped straight from
+ * a file so that they are not copied. Construction reads every height
+ * once to find the lowest and highest, which Bullet needs to center
+ * the shape, so a mapped file is still paged in as a whole then.
+ */
+class tgHeightfieldGround : public tgBulletGround
+{
+    public:
+
+        struct Config
+        {
+            public:
+                Config(btVector3 eulerAngles = btVector3(0.0, 0.0, 0.0),
+                       double friction = 0.5,
+                       double restitution = 0.0,
+                       btVector3 origin = btVector3(0.0, 0.0, 0.0),
+                       std::size_t nx = 50,
+                       std::size_t ny = 50,
+                       double gridSpacing = 5.0,
+                       double heightScale = 1.0,
+                       double margin = 0.05);
+
+                /** Euler angles are specified as yaw pitch and roll */
+                btVector3 m_eulerAngles;
+
+                /** Friction value of the ground, must be between 0 to 1 */
+                btScalar  m_friction;
+
+                /** Restitution coefficient of the ground, must be between 0 to 1 */
+                btScalar  m_restitution;
+
+                /**
+                 * Origin position of the ground. As in tgHillyGround, node
+                 * (i, j) is at x = (i - m_nx / 2) * m_gridSpacing and
+                 * z = (j - m_ny / 2) * m_gridSpacing from here.
+                 */
+                btVector3 m_origin;
+
+                /** Number of nodes in the x-direction, at least 2 */
+                std::size_t m_nx;
+
+                /** Number of nodes in the z-direction, at least 2 */
+                std::size_t m_ny;
+
+                /** Distance between neighbouring nodes along x and z */
+                double m_gridSpacing;
+
+                /** Scale factor from each given or file value to its height */
+                double m_heightScale;
+
+                /** See Bullet documentation on Collision Margin */
+                double m_margin;
+        };
+
+        /**
+         * The same surface as a tgHillyGround with this config, in the
+         * same place
+         */
+        tgHeightfieldGround(const tgHillyGround::Config& config);
+
+        /**
+         * @param[in] config the grid and surface properties
+         * @param[in] heights m_nx * m_ny values, with x varying fastest.
+         * Each height is m_heightScale times its value, as for a file.
+         * Copied, so it may be destroyed afterwards.
+         * @throw std::invalid_argument if there are not m_nx * m_ny heights
+         */
+        tgHeightfieldGround(const tgHeightfieldGround::Config& config,
+                            const std::vector<btScalar>& heights);
+
+        /**
+         * @param[in] config the grid and surface properties
+         * @param[in] fileName a file of exactly m_nx * m_ny native endian
+         * signed 16 bit elevations, with x varying fastest, such as a .r16
+         * export. Each height is m_heightScale times its value. The file
+         * is mapped read only, and must not be changed while this ground
+         * exists. Every elevation is read once, to find the range.
+         * @throw std::runtime_error if the file cannot be mapped, or is
+         * not the size of the grid
+         */
+        tgHeightfieldGround(const tgHeightfieldGround::Config& config,
+                            const std::string& fileName);
+
+        /** Clean up the implementation. Unmaps the file, if any */
+        virtual ~tgHeightfieldGround();
+
+        /**
+         * Setup and return a rigid body based on the collision object
+         */
+        virtual btRigidBody* getGroundRigidBody() const;
+
+    private:
+
+        /** The tgHeightfieldGround::Config that matches a tgHillyGround */
+        static Config hillyConfig(const tgHillyGround::Config& config);
+
+        /** Store the configuration data for use later */
+        Config m_config;
+
+        /** Heights given as a vector; empty when a file is mapped */
+        std::vector<btScalar> m_heights;
+
+        /** The mapping of the height file, or NULL */
+        void* m_pMapped;
+
+        std::size_t m_mappedSize;
+
+        /**
+         * Bullet centers the shape on its bounds. This is where that
+         * center lies relative to m_origin, before rotation.
+         */
+        btVector3 m_center;
+};
+
+#endif  // CORE_TERRAIN_TG_HEIGHTFIELD_GROUND_H
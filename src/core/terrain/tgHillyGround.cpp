@@ -186,14 +186,19 @@ void tgHillyGround::setVertices(btVector3 vertices[]) {
         for (std::size_t j = 0; j < m_config.m_ny; j++)
         {
             const btScalar x = (i - (m_config.m_nx * 0.5)) * m_config.m_triangleSize;
-            const btScalar y = (m_config.m_waveHeight * sin((double)i) * cos((double)j) +
-                    m_config.m_offset);
+            const btScalar y = hillHeight(m_config, i, j);
             const btScalar z = (j - (m_config.m_ny * 0.5)) * m_config.m_triangleSize;
             vertices[i + (j * m_config.m_nx)].setValue(x, y, z);
         }
     }
 }
 
+btScalar tgHillyGround::hillHeight(const Config& config, std::size_t i, std::size_t j)
+{
+    return (config.m_waveHeight * sin((double)i) * cos((double)j) +
+            config.m_offset);
+}
+
 void tgHillyGround::setIndices(int indices[]) {
     int index = 0;
     for (std::size_t i = 0; i < m_config.m_nx - 1; i++)
@@ -120,6 +120,13 @@ class tgHillyGround : public tgBulletGround
          */
         btCollisionShape* hillyCollisionShape();
 
+        /**
+         * The height of the hills at node (i, j), before the ground is
+         * moved to its origin. Shared with tgHeightfieldGround so both
+         * build the same surface.
+         */
+        static btScalar hillHeight(const Config& config, std::size_t i, std::size_t j);
+
     private:  
         /** Store the configuration data for use later */
         Config m_config;
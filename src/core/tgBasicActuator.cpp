@@ -25,9 +25,12 @@
 
 // This Module
 #include "tgBulletSpringCable.h"
+#include "tgBulletSpringCableSolver.h"
 #include "tgBasicActuator.h"
 #include "tgModelVisitor.h"
+#include "tgSimulationState.h"
 #include "tgWorld.h"
+#include "tgWorldBulletPhysicsImpl.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
@@ -44,6 +47,8 @@ void tgBasicActuator::constructorAux()
   // Precondition
     assert(m_pHistory != NULL);
     prevVel = 0.0;
+    m_pCableSolver = NULL;
+    m_pSubstepWorld = NULL;
     if (m_springCable == NULL)
     {
         throw std::invalid_argument("Pointer to tgBulletSpringCable is NULL.");
@@ -85,10 +90,32 @@ void tgBasicActuator::setup(tgWorld& world)
     // This needs to be called here in case the controller needs to cast
     notifySetup();
     tgModel::setup(world);
+
+    tgWorldBulletPhysicsImpl& bulletWorld =
+      (tgWorldBulletPhysicsImpl&)world.implementation();
+    tgBulletSpringCableSolver* const pSolver = bulletWorld.springCableSolver();
+    if (pSolver != NULL && pSolver->add(*this))
+    {
+        m_pCableSolver = pSolver;
+    }
+    else if (bulletWorld.addSubstepCable(m_springCable))
+    {
+        m_pSubstepWorld = &bulletWorld;
+    }
 }
 
 void tgBasicActuator::teardown()
 {
+    if (m_pCableSolver != NULL)
+    {
+        m_pCableSolver->remove(*this);
+        m_pCableSolver = NULL;
+    }
+    if (m_pSubstepWorld != NULL)
+    {
+        m_pSubstepWorld->removeSubstepCable(m_springCable);
+        m_pSubstepWorld = NULL;
+    }
     // Do not notify teardown. The controller has already been deleted.
     tgModel::teardown();
 }
@@ -106,12 +133,36 @@ void tgBasicActuator::step(double dt)
     {   
         // Want to update any controls before applying forces
         notifyStep(dt); 
-        m_springCable->step(dt);
-        logHistory();  
+        // Otherwise the solver does this once every model has stepped
+        if (m_pCableSolver == NULL && m_pSubstepWorld == NULL)
+        {
+            m_springCable->step(dt);
+            logHistory();
+        }
+        else if (m_pSubstepWorld != NULL)
+        {
+            // The cable was stepped before every substep of the last step
+            logHistory();
+        }
         tgModel::step(dt);
     }
 }
 
+void tgBasicActuator::saveState(tgSimulationState& state)
+{
+    state.write(m_preferredLength);
+    tgSpringCableActuator::saveState(state);
+}
+
+void tgBasicActuator::restoreState(tgSimulationState& state)
+{
+    m_preferredLength = state.read();
+    tgSpringCableActuator::restoreState(state);
+    
+    // Postcondition
+    assert(invariant());
+}
+
 void tgBasicActuator::onVisit(const tgModelVisitor& r) const
 {
 #ifndef BT_NO_PROFILE 
@@ -126,11 +177,11 @@ void tgBasicActuator::logHistory()
 
     if (m_config.hist)
     {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_springCable->getVelocity());
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_springCable->getTension());
+        recordHistory(m_springCable->getActualLength(),
+                      m_springCable->getVelocity(),
+                      m_springCable->getDamping(),
+                      m_springCable->getRestLength(),
+                      m_springCable->getTension());
     }
 }
 
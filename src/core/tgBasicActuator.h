@@ -33,12 +33,17 @@
 
 // Forward declarations
 class tgBulletSpringCable;
+class tgBulletSpringCableSolver;
 class tgModelVisitor;
 class tgWorld;
+class tgWorldBulletPhysicsImpl;
 
 // Should always be a child Model of a tgModel
 class tgBasicActuator : public tgSpringCableActuator
 {
+    /** Steps m_springCable and calls logHistory in a batch. */
+    friend class tgBulletSpringCableSolver;
+
 public: 
 
     /**
@@ -59,13 +64,16 @@ public:
     virtual ~tgBasicActuator();
     
     /**
-     * Notifies observers of setup, calls setup on children
+     * Notifies observers of setup, calls setup on children.
+     * Hands the cable to the world's tgBulletSpringCableSolver if it
+     * has one.
      * @param[in] world, the tgWorld the models are being built into
      */
     virtual void setup(tgWorld& world);
     
     /**
-     * Notifies observers of teardown, teardown any children
+     * Notifies observers of teardown, teardown any children, takes the
+     * cable back from the world's tgBulletSpringCableSolver
      */
     virtual void teardown();
     
@@ -73,6 +81,8 @@ public:
      * Step dt forward with the simulation.
      * Notifies observers of step, applies forces to rigid bodies via
      * tgBulletSpringCable, logs history if desired, steps children.
+     * If the cable is batched, the world's solver applies the forces
+     * and logs the history later in tgSimulation::step instead.
      * @param[in] dt, must be >= 0.0
      */    
     virtual void step(double dt);
@@ -85,6 +95,15 @@ public:
      */
     virtual void onVisit(const tgModelVisitor& r) const;
     
+    /**
+     * Saves the preferred length, then everything
+     * tgSpringCableActuator::saveState saves
+     */
+    virtual void saveState(tgSimulationState& state);
+    
+    /** Restores what saveState saved */
+    virtual void restoreState(tgSimulationState& state);
+    
     
     /** Functions for interfacing with higher level controllers */
     /**
@@ -129,6 +148,18 @@ private:
      * Hold the previous value so history can be turned off
      */
     double prevVel;
+
+    /**
+     * The solver that steps our cable, or NULL if we step it ourselves.
+     * Not owned.
+     */
+    tgBulletSpringCableSolver* m_pCableSolver;
+
+    /**
+     * The world that steps our cable before every physics substep, if
+     * the solver cannot batch it, or NULL. Not owned.
+     */
+    tgWorldBulletPhysicsImpl* m_pSubstepWorld;
     
     /**
      * 
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletConstraintSpringCable.cpp
+ * @brief Definition of a spring cable that Bullet's solver integrates implicitly
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "tgBulletConstraintSpringCable.h"
+// This application
+#include "tgBulletSpringCableAnchor.h"
+#include "tgBulletUtil.h"
+#include "tgWorld.h"
+// The Bullet Physics library
+#include "BulletDynamics/ConstraintSolver/btConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * One constraint row along the cable, present only while it is taut.
+     *
+     * The row is soft: its impulse lambda satisfies
+     * J v' + s lambda = erp / dt * (rest - length), where v' is the
+     * velocity after the step. With erp = dt k / (dt k + c) and
+     * s = 1 / (dt (dt k + c)), that is
+     * lambda = -dt (k (stretch + dt J v') + c J v'): an implicit Euler
+     * step of the spring and damper, which is stable at any dt. Rows of
+     * cables sharing a body are solved together, so this holds for the
+     * whole system.
+     *
+     * btSequentialImpulseConstraintSolver converges to
+     * lambda = b / (A (1 + cfm)), with A = J M^-1 J^T, rather than the
+     * b / (A + cfm) of ODE, so the row's cfm is s / A.
+     */
+    class SpringCableConstraint : public btTypedConstraint
+    {
+    public:
+
+        // Not one of Bullet's types, so debug drawing and serialization skip it
+        SpringCableConstraint(const tgBulletSpringCable& cable,
+                              const tgBulletSpringCableAnchor& anchor1,
+                              const tgBulletSpringCableAnchor& anchor2) :
+        btTypedConstraint(MAX_CONSTRAINT_TYPE,
+                          *anchor1.attachedBody, *anchor2.attachedBody),
+        m_cable(cable),
+        m_anchor1(anchor1),
+        m_anchor2(anchor2)
+        {
+        }
+
+        virtual void getInfo1(btConstraintInfo1* info)
+        {
+            const btScalar length =
+                (m_anchor2.getWorldPosition() - m_anchor1.getWorldPosition()).length();
+            // Slack cables push nothing
+            if (length > m_cable.getRestLength())
+            {
+                info->m_numConstraintRows = 1;
+                info->nub = 5;
+            }
+            else
+            {
+                info->m_numConstraintRows = 0;
+                info->nub = 6;
+            }
+        }
+
+        virtual void getInfo2(btConstraintInfo2* info)
+        {
+            const btVector3 dist =
+                m_anchor2.getWorldPosition() - m_anchor1.getWorldPosition();
+            const btScalar length = dist.length();
+            const btVector3 unitVector = dist / length;
+            const btVector3 cross1 = m_anchor1.getRelativePosition().cross(unitVector);
+            const btVector3 cross2 = m_anchor2.getRelativePosition().cross(unitVector);
+
+            // J v is the rate at which the cable stretches
+            for (int i = 0; i < 3; i++)
+            {
+                info->m_J1linearAxis[i] = -unitVector[i];
+                info->m_J1angularAxis[i] = -cross1[i];
+                info->m_J2linearAxis[i] = unitVector[i];
+                info->m_J2angularAxis[i] = cross2[i];
+            }
+
+            // A, computed as the solver computes its inverse
+            const btRigidBody& body1 = *m_anchor1.attachedBody;
+            const btRigidBody& body2 = *m_anchor2.attachedBody;
+            const btScalar invEffectiveMass =
+                body1.getInvMass() + body2.getInvMass() +
+                cross1.dot(body1.getInvInertiaTensorWorld() * cross1) +
+                cross2.dot(body2.getInvInertiaTensorWorld() * cross2);
+
+            const btScalar dt = 1.0 / info->fps;
+            const btScalar k = m_cable.getCoefK();
+            const btScalar c = m_cable.getCoefD();
+            const btScalar erp = dt * k / (dt * k + c);
+            const btScalar softness = 1.0 / (dt * (dt * k + c));
+            // Two static bodies give the solver nothing to move
+            info->cfm[0] = invEffectiveMass > SIMD_EPSILON ?
+                           softness / invEffectiveMass : softness;
+            info->m_constraintError[0] =
+                info->fps * erp * (m_cable.getRestLength() - length);
+
+            // Tension only ever shortens the cable
+            info->m_lowerLimit[0] = -SIMD_INFINITY;
+            info->m_upperLimit[0] = 0.0;
+        }
+
+        /** The spring parameters come from the cable, so there are none */
+        virtual void setParam(int num, btScalar value, int axis = -1)
+        {
+        }
+
+        virtual btScalar getParam(int num, int axis = -1) const
+        {
+            return 0.0;
+        }
+
+    private:
+
+        const tgBulletSpringCable& m_cable;
+
+        const tgBulletSpringCableAnchor& m_anchor1;
+
+        const tgBulletSpringCableAnchor& m_anchor2;
+    };
+}
+
+tgBulletConstraintSpringCable::tgBulletConstraintSpringCable(tgWorld& world,
+                const std::vector<tgBulletSpringCableAnchor*>& anchors,
+                double coefK,
+                double dampingCoefficient,
+                double pretension) :
+tgBulletSpringCable(anchors, coefK, dampingCoefficient, pretension),
+m_world(world),
+m_constraint(NULL)
+{
+    btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
+    // btMLCPSolver ignores each row's cfm, which would make the cable rigid
+    if (dynamicsWorld.getConstraintSolver()->getSolverType() !=
+        BT_SEQUENTIAL_IMPULSE_SOLVER)
+    {
+        throw std::invalid_argument("Constraint spring cables need a "
+                                    "sequential impulse solver");
+    }
+
+    m_constraint = new SpringCableConstraint(*this, *anchor1, *anchor2);
+    // The bodies at either end still collide
+    dynamicsWorld.addConstraint(m_constraint, false);
+}
+
+tgBulletConstraintSpringCable::~tgBulletConstraintSpringCable()
+{
+    btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
+    dynamicsWorld.removeConstraint(m_constraint);
+    delete m_constraint;
+}
+
+void tgBulletConstraintSpringCable::calculateAndApplyForce(double dt)
+{
+    const double currLength = getActualLength();
+
+    m_velocity = (currLength - m_prevLength) / dt;
+    m_damping = currLength > m_restLength ? m_dampingCoefficient * m_velocity : 0.0;
+    m_prevLength = currLength;
+
+    // Constraints alone do not wake sleeping bodies
+    anchor1->attachedBody->activate();
+    anchor2->attachedBody->activate();
+}
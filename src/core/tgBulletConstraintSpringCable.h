@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_CORE_TG_BULLET_CONSTRAINT_SPRING_CABLE_H_
+#define SRC_CORE_TG_BULLET_CONSTRAINT_SPRING_CABLE_H_
+
+/**
+ * @file tgBulletConstraintSpringCable.h
+ * @brief Definition of a spring cable that Bullet's solver integrates implicitly
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// NTRT
+#include "core/tgBulletSpringCable.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward references
+class tgWorld;
+class tgBulletSpringCableAnchor;
+class btTypedConstraint;
+
+/**
+ * A tgBulletSpringCable whose force is a soft, tension-only distance
+ * constraint solved together with the contacts and joints, instead of
+ * an impulse applied before the step.
+ *
+ * The constraint's error reduction and mixing parameters are chosen so
+ * that solving it is an implicit Euler step of the spring and damper.
+ * Explicit cables need a step well under the period of their stiffest
+ * spring; these stay stable at any step, and settle at the same
+ * lengths. Very large steps damp oscillations more than the explicit
+ * model does.
+ *
+ * The world must use tgWorld::Config::eSequentialImpulse, since the
+ * MLCP solvers ignore the softness of a constraint.
+ *
+ * Only the two end anchors are used, so this is not a contact cable.
+ * The tension reported is the spring force at the current length, as
+ * for tgBulletSpringCable.
+ */
+class tgBulletConstraintSpringCable : public tgBulletSpringCable
+{
+public:
+
+    /**
+     * Add the constraint to the world's dynamics world.
+     * @param[in] world the world that owns the anchors' bodies; must
+     * outlive this cable
+     * @param[in] anchors the anchors, deleted with the cable. Only the
+     * first and last are used
+     * @param[in] coefK the stiffness of the spring. Must be positive
+     * @param[in] dampingCoefficient the damping in the spring. Must be
+     * non-negative
+     * @param[in] pretension must be small enough to keep the rest
+     * length positive
+     * @throw std::invalid_argument if the world's solver is not a
+     * sequential impulse solver
+     */
+    tgBulletConstraintSpringCable(tgWorld& world,
+                const std::vector<tgBulletSpringCableAnchor*>& anchors,
+                double coefK,
+                double dampingCoefficient,
+                double pretension = 0.0);
+
+    /** Removes the constraint from the world and deletes it. */
+    virtual ~tgBulletConstraintSpringCable();
+
+private:
+
+    /**
+     * Update the length, velocity and damping for the history. The
+     * force itself is applied by the constraint during the next step.
+     */
+    virtual void calculateAndApplyForce(double dt);
+
+    tgWorld& m_world;
+
+    /** Owned. Reads the rest length from this cable every step. */
+    btTypedConstraint* m_constraint;
+};
+
+#endif  // SRC_CORE_TG_BULLET_CONSTRAINT_SPRING_CABLE_H_
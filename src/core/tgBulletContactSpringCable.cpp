@@ -31,6 +31,7 @@
 #include "tgcreator/tgUtil.h"
 #include "core/tgBulletSpringCableAnchor.h"
 #include "core/tgCast.h"
+#include "core/tgSimulationState.h"
 #include "core/tgBulletUtil.h"
 #include "core/tgWorld.h"
 #include "core/tgWorldBulletPhysicsImpl.h"
@@ -48,6 +49,7 @@
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
+#include <algorithm>	// upper_bound
 #include <iostream>
 #include <cmath>		// abs
 #include <stdexcept>
@@ -68,7 +70,7 @@ m_world(world),
 m_thickness(thickness),
 m_resolution(resolution)
 {
-
+    updateSegmentIndex();
 }
          
 tgBulletContactSpringCable::~tgBulletContactSpringCable()
@@ -76,9 +78,15 @@ tgBulletContactSpringCable::~tgBulletContactSpringCable()
 	btDynamicsWorld& m_dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
 	m_dynamicsWorld.removeCollisionObject(m_ghostObject);
     
+    // Deletes the segment shapes that are currently children
     btCollisionShape* shape = m_ghostObject->getCollisionShape();
     deleteCollisionShape(shape);
     delete m_ghostObject;
+    
+    for (std::size_t i = 0; i < m_shapePool.size(); i++)
+    {
+        delete m_shapePool[i];
+    }
 }
 
 const btScalar tgBulletContactSpringCable::getActualLength() const
@@ -96,6 +104,7 @@ const btScalar tgBulletContactSpringCable::getActualLength() const
 
 void tgBulletContactSpringCable::step(double dt)
 {    
+    updateSegmentIndex();
     updateManifolds();
 #if (0) // Typically causes contacts to be lost
     int numPruned = 1;
@@ -125,6 +134,21 @@ void tgBulletContactSpringCable::step(double dt)
     assert(invariant());
 }
 
+void tgBulletContactSpringCable::restoreState(tgSimulationState& state)
+{
+    tgBulletSpringCable::restoreState(state);
+    
+    // The anchors were placed where the bodies touched the cable before
+    // the restore, so they no longer describe its path
+    for (int i = m_anchors.size() - 1; i >= 0; i--)
+    {
+        deleteAnchor(i);
+    }
+    updateSegmentIndex();
+    
+    assert(invariant());
+}
+
 void tgBulletContactSpringCable::calculateAndApplyForce(double dt)
 {
 #ifndef BT_NO_PROFILE 
@@ -301,8 +325,21 @@ void tgBulletContactSpringCable::updateManifolds()
 					
 					if(rb)
 					{  
+						// The children of the ghost's compound are the
+						// segments, in order, and the anchors haven't changed
+						// since it was built. So the child that was hit is
+						// usually the segment we want.
+						const int segment = directionSign < 0 ? pt.m_index0 : pt.m_index1;
 						
-						int anchorPos = findNearestPastAnchor(pos);
+						int anchorPos;
+						if (segment >= 0 && segment < (int)(m_anchors.size() - 1) && isOnSegment(segment, pos))
+						{
+							anchorPos = segment;
+						}
+						else
+						{
+							anchorPos = findNearestPastAnchor(pos);
+						}
 						assert(anchorPos < (int)(m_anchors.size() - 1));
 						
 						// -1 means findNearestPastAnchor failed
@@ -324,20 +361,29 @@ void tgBulletContactSpringCable::updateManifolds()
 							btScalar lengthA = lineA.length();
 							btScalar lengthB = lineB.length();
 							
-							btScalar mDistB = backAnchor->getManifoldDistance(newAnchor->getManifold()).first;
-							btScalar mDistA = forwardAnchor->getManifoldDistance(newAnchor->getManifold()).first;
+							// Only needed if the contact is close to a neighbour
+							const bool nearB = lengthB <= m_resolution && rb == backAnchor->attachedBody;
+							const bool nearA = lengthA <= m_resolution && rb == forwardAnchor->attachedBody;
+							
+							btScalar mDistB = INFINITY;
+							btScalar mDistA = INFINITY;
+							if (nearA || nearB)
+							{
+								mDistB = backAnchor->getManifoldDistance(newAnchor->getManifold()).first;
+								mDistA = forwardAnchor->getManifoldDistance(newAnchor->getManifold()).first;
+							}
 							
 							//std::cout << "Update Manifolds " << newAnchor->getManifold() << std::endl;
 							
 							bool del = false;	
 										
-							if (lengthB <= m_resolution && rb == backAnchor->attachedBody && mDistB < mDistA)
+							if (nearB && mDistB < mDistA)
 							{
 								if(backAnchor->updateManifold(manifold))
 									del = true;
 									//std::cout << "UpdateB " << mDistB << std::endl;
 							}
-							if (lengthA <= m_resolution && rb == forwardAnchor->attachedBody && (!del || mDistA < mDistB))
+							if (nearA && (!del || mDistA < mDistB))
 							{
 								if (forwardAnchor->updateManifold(manifold))
 									del = true;
@@ -353,6 +399,7 @@ void tgBulletContactSpringCable::updateManifolds()
 							{
 												
 								m_newAnchors.push_back(newAnchor);
+								m_newAnchorArcLengths.push_back(getArcLength(anchorPos, pos));
 							} // If anchor passes distance tests
 						} // If we could find the anchor's position
 					} // If body is a rigid body
@@ -378,10 +425,12 @@ void tgBulletContactSpringCable::updateAnchorList()
 		// Not permanent, sliding contact
 		tgBulletSpringCableAnchor* const newAnchor = m_newAnchors[0];
 		m_newAnchors.erase(m_newAnchors.begin());
+		const btScalar arcLength = m_newAnchorArcLengths[0];
+		m_newAnchorArcLengths.erase(m_newAnchorArcLengths.begin());
 		
 		btVector3 pos1 = newAnchor->getWorldPosition();
 
-		int anchorPos = findNearestPastAnchor(pos1);
+		int anchorPos = findSegmentByArcLength(arcLength, pos1);
 		
 		assert(anchorPos < (int) (m_anchors.size() - 1));
 		
@@ -455,6 +504,12 @@ void tgBulletContactSpringCable::updateAnchorList()
 				m_anchorIt = m_anchors.begin() + anchorPos + 1;
 			    
 				m_anchorIt = m_anchors.insert(m_anchorIt, newAnchor);
+				
+				// Keep the arc lengths sorted, even if the contact was
+				// placed by the fallback search
+				const btScalar newArcLength = btMin(btMax(arcLength,
+					m_anchorArcLengths[anchorPos]), m_anchorArcLengths[anchorPos + 1]);
+				m_anchorArcLengths.insert(m_anchorArcLengths.begin() + anchorPos + 1, newArcLength);
 
 #if (1) // Keeps the energy down very well
                 if (getActualLength() > m_prevLength + 2.0 * m_resolution)
@@ -689,15 +744,16 @@ void tgBulletContactSpringCable::updateCollisionObject()
 	btDispatcher* m_dispatcher = tgBulletUtil::worldToDynamicsWorld(m_world).getDispatcher();
 	btBroadphaseInterface* const m_overlappingPairCache = tgBulletUtil::worldToDynamicsWorld(m_world).getBroadphase();
 	
-    // Clear the existing child shapes
     btCompoundShape* m_compoundShape = tgCast::cast<btCollisionShape, btCompoundShape> (m_ghostObject->getCollisionShape());
-    clearCompoundShape(m_compoundShape);
+    
+    std::size_t n = m_anchors.size();
+    
+    // Only add or remove children if the number of anchors changed
+    const bool resized = resizeSegmentShapes(m_compoundShape, n - 1);
     
     btVector3 maxes(anchor2->getWorldPosition());
     btVector3 mins(anchor1->getWorldPosition());
     
-    std::size_t n = m_anchors.size();
-    
     for (std::size_t i = 0; i < n; i++)
     {
         btVector3 worldPos = m_anchors[i]->getWorldPosition();
@@ -714,9 +770,6 @@ void tgBulletContactSpringCable::updateCollisionObject()
         }
     }
     btVector3 center = (maxes + mins)/2.0;
-    
-    btVector3 from = anchor1->getWorldPosition();
-	btVector3 to = anchor2->getWorldPosition();
 	
     for (std::size_t i = 0; i < n-1; i++)
     {
@@ -727,13 +780,19 @@ void tgBulletContactSpringCable::updateCollisionObject()
         btTransform t = tgUtil::getTransform(pos2, pos1);
         t.setOrigin(t.getOrigin() - center);
         
+        // Segment shapes have a half height of one, so scaling sets the
+        // half length. Never scale to zero, since Bullet divides by the
+        // old scaling the next time it is changed.
         btScalar length = (pos2 - pos1).length() / 2.0;
+        length = btMax(length, SIMD_EPSILON);
 		
         /// @todo - seriously examine box vs cylinder shapes
-        btCylinderShape* box = new btCylinderShape(btVector3(m_thickness, length, m_thickness));
+        m_segmentShapes[i]->setLocalScaling(btVector3(1.0, length, 1.0));
         
-        m_compoundShape->addChildShape(t, box);
+        // Recalculate the compound's bounds once, after the loop
+        m_compoundShape->updateChildTransform(i, t, false);
     }
+    m_compoundShape->recalculateLocalAabb();
     // Default margin is 0.04, so larger than default thickness. Behavior is better with larger margin
     //m_compoundShape->setMargin(m_thickness);
     
@@ -741,11 +800,60 @@ void tgBulletContactSpringCable::updateCollisionObject()
     transform.setOrigin(center);
     transform.setRotation(btQuaternion::getIdentity());
     
-    m_ghostObject->setCollisionShape (m_compoundShape);
     m_ghostObject->setWorldTransform(transform);
 	
-	// Delete the existing contacts in bullet to prevent sticking - may exacerbate problems with rotations
-	m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+    // Contacts cached by the compound's child algorithms belong to
+    // particular segments. If segments were added or removed, delete the
+    // existing contacts in bullet to prevent sticking - may exacerbate
+    // problems with rotations. Otherwise each segment has only moved a
+    // little, and Bullet refreshes the cached points itself.
+    if (resized)
+    {
+        m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+    }
+}
+
+bool tgBulletContactSpringCable::resizeSegmentShapes(btCompoundShape* pShape, std::size_t numSegments)
+{
+    // Anything else in the compound (e.g. the builder's initial shape)
+    // isn't one of ours, so start from scratch
+    if ((std::size_t) pShape->getNumChildShapes() != m_segmentShapes.size())
+    {
+        clearCompoundShape(pShape);
+        m_segmentShapes.clear();
+    }
+    
+    if (m_segmentShapes.size() == numSegments)
+    {
+        return false;
+    }
+    
+    // Remove from the end, so the remaining children keep their indices
+    while (m_segmentShapes.size() > numSegments)
+    {
+        pShape->removeChildShapeByIndex(pShape->getNumChildShapes() - 1);
+        m_shapePool.push_back(m_segmentShapes.back());
+        m_segmentShapes.pop_back();
+    }
+    
+    while (m_segmentShapes.size() < numSegments)
+    {
+        btCylinderShape* segment;
+        if (m_shapePool.empty())
+        {
+            segment = new btCylinderShape(btVector3(m_thickness, 1.0, m_thickness));
+        }
+        else
+        {
+            segment = m_shapePool.back();
+            m_shapePool.pop_back();
+        }
+        // Placed and sized by updateCollisionObject
+        pShape->addChildShape(btTransform::getIdentity(), segment);
+        m_segmentShapes.push_back(segment);
+    }
+    
+    return true;
 }
 
 void tgBulletContactSpringCable::deleteCollisionShape(btCollisionShape* pShape)
@@ -799,6 +907,7 @@ bool tgBulletContactSpringCable::deleteAnchor(int i)
 	{
 		delete m_anchors[i];
 		m_anchors.erase(m_anchors.begin() + i);
+		m_anchorArcLengths.erase(m_anchorArcLengths.begin() + i);
 		return true;
 	}
 	else
@@ -949,6 +1058,86 @@ int tgBulletContactSpringCable::findNearestPastAnchor(btVector3& pos)
 
 }
 
+void tgBulletContactSpringCable::updateSegmentIndex()
+{
+    const std::size_t n = m_anchors.size();
+    m_anchorArcLengths.resize(n);
+    
+    btScalar arcLength = 0.0;
+    btVector3 prev = m_anchors[0]->getWorldPosition();
+    m_anchorArcLengths[0] = 0.0;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        btVector3 current = m_anchors[i]->getWorldPosition();
+        arcLength += (current - prev).length();
+        m_anchorArcLengths[i] = arcLength;
+        prev = current;
+    }
+}
+
+bool tgBulletContactSpringCable::isOnSegment(std::size_t i, const btVector3& pos) const
+{
+    assert(i + 1 < m_anchors.size());
+    
+    const btVector3 back = m_anchors[i]->getWorldPosition();
+    const btVector3 forward = m_anchors[i + 1]->getWorldPosition();
+    const btVector3 line = forward - back;
+    
+    // Same test as anchorCompare, from both ends
+    const btScalar along = line.dot(pos);
+    return line.dot(back) < along && along <= line.dot(forward);
+}
+
+btScalar tgBulletContactSpringCable::getArcLength(std::size_t i, const btVector3& pos) const
+{
+    assert(i + 1 < m_anchors.size());
+    
+    const btVector3 back = m_anchors[i]->getWorldPosition();
+    const btVector3 line = m_anchors[i + 1]->getWorldPosition() - back;
+    const btScalar length = line.length();
+    
+    btScalar along = 0.0;
+    if (length > 0.0)
+    {
+        along = btMin(btMax(line.dot(pos - back) / length, btScalar(0.0)), length);
+    }
+    
+    return m_anchorArcLengths[i] + along;
+}
+
+int tgBulletContactSpringCable::findSegmentByArcLength(btScalar arcLength, btVector3& pos)
+{
+    assert(m_anchorArcLengths.size() == m_anchors.size());
+    const std::size_t n = m_anchors.size() - 1;
+    
+    // The first anchor past arcLength ends the segment
+    std::size_t i = std::upper_bound(m_anchorArcLengths.begin(),
+                                     m_anchorArcLengths.end(),
+                                     arcLength) - m_anchorArcLengths.begin();
+    i = (i == 0) ? 0 : i - 1;
+    if (i >= n)
+    {
+        i = n - 1;
+    }
+    
+    // Anchors may have slid since the arc lengths were computed, so
+    // also try the neighbouring segments before giving up
+    if (isOnSegment(i, pos))
+    {
+        return i;
+    }
+    else if (i + 1 < n && isOnSegment(i + 1, pos))
+    {
+        return i + 1;
+    }
+    else if (i > 0 && isOnSegment(i - 1, pos))
+    {
+        return i - 1;
+    }
+    
+    return findNearestPastAnchor(pos);
+}
+
 tgBulletContactSpringCable::anchorCompare::anchorCompare(const tgBulletSpringCableAnchor* m1, const tgBulletSpringCableAnchor* m2) :
 ma1(m1),
 ma2(m2)
@@ -989,5 +1178,7 @@ bool tgBulletContactSpringCable::invariant(void) const
     m_thickness >= 0.0 &&
     m_resolution > 0 &&
     m_ghostObject != NULL &&
-    m_newAnchors.size() == 0);
+    m_newAnchors.size() == 0 &&
+    m_newAnchorArcLengths.size() == 0 &&
+    m_anchorArcLengths.size() == m_anchors.size());
 }
@@ -42,6 +42,7 @@ class tgBulletSpringCableAnchor;
 class btRigidBody;
 class btCollisionShape;
 class btCompoundShape;
+class btCylinderShape;
 class btPairCachingGhostObject;
 class btDynamicsWorld;
 
@@ -113,6 +114,12 @@ public:
      */
     virtual const btScalar getActualLength() const;
     
+    /**
+     * Restores the base class state, then removes every contact anchor.
+     * The contacts at the restored positions are found again on the next step.
+     */
+    virtual void restoreState(tgSimulationState& state);
+    
 private:
     
     /**
@@ -179,12 +186,23 @@ private:
     void pruneAnchors();
     
     /**
-     * Uses m_anchors to update the collision shape of the m_ghostObject
-     * Also resets the broadphase's pairCache after collision object
-     * is changed.
+     * Uses m_anchors to update the collision shape of the m_ghostObject.
+     * Existing segment shapes are moved and resized in place; shapes are
+     * only added to or removed from the compound when the number of
+     * anchors changes, and only then is the broadphase's pairCache reset.
      */
     void updateCollisionObject();
     
+    /**
+     * Make the compound hold exactly numSegments children from
+     * m_segmentShapes, taking shapes from and returning them to
+     * m_shapePool.
+     * @param[in] pShape the ghost object's compound shape
+     * @param[in] numSegments the number of segments between anchors
+     * @return true if any child was added or removed
+     */
+    bool resizeSegmentShapes(btCompoundShape* pShape, std::size_t numSegments);
+    
     /**
      * Deletes a collision shape and it's child shapes
      * @param[in] pShape the btCollisionShape to be deleted
@@ -218,6 +236,36 @@ private:
      */
     int findNearestPastAnchor(btVector3& pos);
     
+    /**
+     * Recompute the arc length of the cable at each anchor. Called once
+     * per step, before any contacts are placed.
+     */
+    void updateSegmentIndex();
+    
+    /**
+     * Check whether pos lies between anchors i and i + 1, measured along
+     * the line between them
+     * @param[in] i the index of the segment's first anchor
+     * @param[in] pos the position of the contact or anchor in question
+     */
+    bool isOnSegment(std::size_t i, const btVector3& pos) const;
+    
+    /**
+     * Project pos onto the segment starting at anchor i
+     * @return the arc length of the projected point along the cable
+     */
+    btScalar getArcLength(std::size_t i, const btVector3& pos) const;
+    
+    /**
+     * Place a point with a known arc length on its segment using a
+     * binary search of m_anchorArcLengths. Falls back to
+     * findNearestPastAnchor if the segment found does not contain pos.
+     * @param[in] arcLength the arc length of pos along the cable
+     * @param[in] pos the position of the contact or anchor in question
+     * @return the index of the relevant anchor, or -1 on failure
+     */
+    int findSegmentByArcLength(btScalar arcLength, btVector3& pos);
+    
     /**
      * An iterator over a list of tgBulletSpringCableAnchors. Used to insert new
      * anchors during updateAnchorList()
@@ -230,6 +278,32 @@ private:
      */
     std::vector<tgBulletSpringCableAnchor*> m_newAnchors;
     
+    /**
+     * The arc length along the cable at which each of m_newAnchors was
+     * found
+     */
+    std::vector<btScalar> m_newAnchorArcLengths;
+    
+    /**
+     * The arc length along the cable at each anchor, in the same order
+     * as m_anchors. Recomputed by updateSegmentIndex each step, and kept
+     * in step with insertions and deletions in between, so it is always
+     * sorted even while anchors slide.
+     */
+    std::vector<btScalar> m_anchorArcLengths;
+    
+    /**
+     * The shapes currently in the ghost object's compound, one per
+     * segment, in the same order as the segments. Owned by the compound.
+     */
+    std::vector<btCylinderShape*> m_segmentShapes;
+    
+    /**
+     * Segment shapes that were removed when anchors were deleted, kept
+     * for reuse when anchors are added again. We own these.
+     */
+    std::vector<btCylinderShape*> m_shapePool;
+    
     /**
      * A reference to the dynamics world so that we can track the
      * contact points in the broadphase's pairCache and remove
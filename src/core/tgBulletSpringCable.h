@@ -46,6 +46,9 @@ class tgBulletSpringCableAnchor;
  */
 class tgBulletSpringCable : public tgSpringCable
 {
+    /** Reads the anchors and steps the cable's state in a batch. */
+    friend class tgBulletSpringCableSolver;
+
 public: 
     /**
      * The only constructor. Takes a list of anchors, a coefficient
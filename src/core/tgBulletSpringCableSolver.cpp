@@ -0,0 +1,284 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletSpringCableSolver.cpp
+ * @brief Contains the definitions of members of class tgBulletSpringCableSolver
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "tgBulletSpringCableSolver.h"
+// This application
+#include "tgBasicActuator.h"
+#include "tgBulletSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+#include "tgCast.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace
+{
+    /** Remove entry i of v by moving the last entry into its place. */
+    template <class T>
+    void swapRemove(std::vector<T>& v, std::size_t i)
+    {
+        v[i] = v.back();
+        v.pop_back();
+    }
+
+    template <class T>
+    void swapRemove(btAlignedObjectArray<T>& v, std::size_t i)
+    {
+        v.swap(i, v.size() - 1);
+        v.pop_back();
+    }
+}
+
+tgBulletSpringCableSolver::tgBulletSpringCableSolver() :
+m_bodiesValid(true)
+{
+}
+
+bool tgBulletSpringCableSolver::add(tgBasicActuator& actuator)
+{
+    tgBulletSpringCable* const cable =
+        tgCast::cast<tgSpringCable, tgBulletSpringCable>(actuator.m_springCable);
+
+    // Subclasses such as tgBulletContactSpringCable move their anchors
+    if (cable == NULL || typeid(*cable) != typeid(tgBulletSpringCable))
+    {
+        return false;
+    }
+
+    const tgBulletSpringCableAnchor* const anchor1 = cable->anchor1;
+    const tgBulletSpringCableAnchor* const anchor2 = cable->anchor2;
+    if (anchor1->sliding || anchor2->sliding)
+    {
+        return false;
+    }
+
+    btRigidBody* const body1 = anchor1->attachedBody;
+    btRigidBody* const body2 = anchor2->attachedBody;
+
+    m_actuators.push_back(&actuator);
+    m_cables.push_back(cable);
+    m_bodies1.push_back(body1);
+    m_bodies2.push_back(body2);
+    m_localPos1.push_back(body1->getWorldTransform().inverse() *
+                          anchor1->getWorldPosition());
+    m_localPos2.push_back(body2->getWorldTransform().inverse() *
+                          anchor2->getWorldPosition());
+    m_coefK.push_back(cable->getCoefK());
+    m_dampingCoefficient.push_back(cable->getCoefD());
+
+    m_bodiesValid = false;
+    return true;
+}
+
+void tgBulletSpringCableSolver::remove(tgBasicActuator& actuator)
+{
+    const std::vector<tgBasicActuator*>::iterator it =
+        std::find(m_actuators.begin(), m_actuators.end(), &actuator);
+    if (it == m_actuators.end())
+    {
+        return;
+    }
+
+    const std::size_t i = it - m_actuators.begin();
+    swapRemove(m_actuators, i);
+    swapRemove(m_cables, i);
+    swapRemove(m_bodies1, i);
+    swapRemove(m_bodies2, i);
+    swapRemove(m_localPos1, i);
+    swapRemove(m_localPos2, i);
+    swapRemove(m_coefK, i);
+    swapRemove(m_dampingCoefficient, i);
+
+    // A body may be deleted once none of our cables use it
+    m_bodiesValid = false;
+}
+
+void tgBulletSpringCableSolver::indexBodies()
+{
+    const std::size_t n = m_cables.size();
+    std::map<btRigidBody*, std::size_t> index;
+
+    m_bodies.clear();
+    m_bodyIndex1.resize(n);
+    m_bodyIndex2.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const std::pair<std::map<btRigidBody*, std::size_t>::iterator, bool> r1 =
+            index.insert(std::make_pair(m_bodies1[i], m_bodies.size()));
+        if (r1.second)
+        {
+            m_bodies.push_back(m_bodies1[i]);
+        }
+        m_bodyIndex1[i] = r1.first->second;
+
+        const std::pair<std::map<btRigidBody*, std::size_t>::iterator, bool> r2 =
+            index.insert(std::make_pair(m_bodies2[i], m_bodies.size()));
+        if (r2.second)
+        {
+            m_bodies.push_back(m_bodies2[i]);
+        }
+        m_bodyIndex2[i] = r2.first->second;
+    }
+
+    const int numBodies = static_cast<int>(m_bodies.size());
+    m_transforms.resize(numBodies);
+    m_linearImpulse.resize(numBodies);
+    m_angularImpulse.resize(numBodies);
+
+    const int numCables = static_cast<int>(n);
+    m_restLength.resize(n);
+    m_prevLength.resize(n);
+    m_length.resize(n);
+    m_velocity.resize(n);
+    m_damping.resize(n);
+    m_magnitude.resize(n);
+    m_relPos1.resize(numCables);
+    m_relPos2.resize(numCables);
+    m_dist.resize(numCables);
+
+    m_bodiesValid = true;
+}
+
+void tgBulletSpringCableSolver::solve(double dt, bool updateHistory)
+{
+#ifndef BT_NO_PROFILE
+    BT_PROFILE("tgBulletSpringCableSolver::solve");
+#endif //BT_NO_PROFILE
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive!");
+    }
+
+    if (!m_bodiesValid)
+    {
+        indexBodies();
+    }
+
+    const std::size_t numCables = m_cables.size();
+    const std::size_t numBodies = m_bodies.size();
+
+    // Gather: one transform per body, and the state controllers change
+    for (std::size_t b = 0; b < numBodies; b++)
+    {
+        m_transforms[b] = m_bodies[b]->getWorldTransform();
+    }
+    for (std::size_t i = 0; i < numCables; i++)
+    {
+        const tgBulletSpringCable* const cable = m_cables[i];
+        m_restLength[i] = cable->m_restLength;
+        m_prevLength[i] = cable->m_prevLength;
+    }
+
+    // Geometry
+    for (std::size_t i = 0; i < numCables; i++)
+    {
+        const btTransform& tr1 = m_transforms[m_bodyIndex1[i]];
+        const btTransform& tr2 = m_transforms[m_bodyIndex2[i]];
+        m_relPos1[i] = tr1.getBasis() * m_localPos1[i];
+        m_relPos2[i] = tr2.getBasis() * m_localPos2[i];
+        m_dist[i] = (tr2.getOrigin() + m_relPos2[i]) -
+                    (tr1.getOrigin() + m_relPos1[i]);
+        m_length[i] = m_dist[i].length();
+    }
+
+    // Tensions, the same arithmetic as tgBulletSpringCable::calculateAndApplyForce
+    for (std::size_t i = 0; i < numCables; i++)
+    {
+        const double currLength = m_length[i];
+        const double magnitude = m_coefK[i] * (currLength - m_restLength[i]);
+        const double velocity = (currLength - m_prevLength[i]) / dt;
+        double damping = m_dampingCoefficient[i] * velocity;
+        if (std::abs(magnitude) < std::abs(damping))
+        {
+            damping = (damping > 0.0 ? magnitude : -magnitude);
+        }
+        m_velocity[i] = velocity;
+        m_damping[i] = damping;
+        // Slack cables push nothing
+        m_magnitude[i] = currLength > m_restLength[i] ? magnitude + damping : 0.0;
+    }
+
+    // Scatter: sum the impulses on each body
+    for (std::size_t b = 0; b < numBodies; b++)
+    {
+        m_linearImpulse[b].setZero();
+        m_angularImpulse[b].setZero();
+    }
+    for (std::size_t i = 0; i < numCables; i++)
+    {
+        const btVector3 impulse =
+            m_dist[i] * (m_magnitude[i] * dt / m_length[i]);
+
+        const std::size_t b1 = m_bodyIndex1[i];
+        const btVector3 impulse1 = impulse * m_bodies[b1]->getLinearFactor();
+        m_linearImpulse[b1] += impulse;
+        m_angularImpulse[b1] += m_relPos1[i].cross(impulse1);
+
+        const std::size_t b2 = m_bodyIndex2[i];
+        const btVector3 impulse2 = -impulse * m_bodies[b2]->getLinearFactor();
+        m_linearImpulse[b2] -= impulse;
+        m_angularImpulse[b2] += m_relPos2[i].cross(impulse2);
+    }
+    for (std::size_t b = 0; b < numBodies; b++)
+    {
+        btRigidBody* const body = m_bodies[b];
+        body->activate();
+        // As in btRigidBody::applyImpulse
+        if (body->getInvMass() != 0.0)
+        {
+            body->applyCentralImpulse(m_linearImpulse[b]);
+            body->applyTorqueImpulse(m_angularImpulse[b]);
+        }
+    }
+
+    // Write back, so the cables and actuators look as if they stepped
+    for (std::size_t i = 0; i < numCables; i++)
+    {
+        tgBulletSpringCable* const cable = m_cables[i];
+        cable->m_prevLength = m_length[i];
+        cable->m_velocity = m_velocity[i];
+        cable->m_damping = m_damping[i];
+    }
+    if (updateHistory)
+    {
+        logHistory();
+    }
+}
+
+void tgBulletSpringCableSolver::logHistory()
+{
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        m_actuators[i]->logHistory();
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BULLET_SPRING_CABLE_SOLVER_H
+#define TG_BULLET_SPRING_CABLE_SOLVER_H
+
+/**
+ * @file tgBulletSpringCableSolver.h
+ * @brief Contains the definition of class tgBulletSpringCableSolver
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btRigidBody;
+class tgBasicActuator;
+class tgBulletSpringCable;
+
+/**
+ * Applies the forces of many tgBulletSpringCables in one pass, instead
+ * of each tgBasicActuator stepping its own cable.
+ * Anchor bodies and offsets, stiffness and damping are kept in
+ * contiguous arrays. Each solve reads every body's transform once,
+ * computes all tensions in a loop over plain arrays, and applies one
+ * summed impulse per body. The results match stepping each cable,
+ * up to rounding.
+ * Owned by tgWorldBulletPhysicsImpl when tgWorld::Config::batchSpringCables
+ * is set, and stepped by tgSimulation::step after the models, so that
+ * controllers have already set the rest lengths. With physics substeps,
+ * it is stepped before every substep instead.
+ * Only cables with two fixed anchors are batched; contact cables
+ * keep stepping themselves, or are stepped by the world before every
+ * substep.
+ */
+class tgBulletSpringCableSolver
+{
+public:
+
+    tgBulletSpringCableSolver();
+
+    /**
+     * Batch the cable of this actuator from now on. Called by
+     * tgBasicActuator::setup once the anchor bodies exist.
+     * @param[in] actuator the actuator, which must call remove before
+     * it or its cable is destroyed
+     * @return false if the cable cannot be batched, in which case the
+     * actuator must keep stepping it
+     */
+    bool add(tgBasicActuator& actuator);
+
+    /**
+     * Stop batching the cable of this actuator. Does nothing if it was
+     * not added.
+     * @param[in] actuator the actuator
+     */
+    void remove(tgBasicActuator& actuator);
+
+    /**
+     * Compute and apply the forces of every batched cable, then update
+     * each cable's state and, optionally, its actuator's history.
+     * @param[in] dt the time since the previous solve, must be positive
+     * @param[in] updateHistory false when solving a physics substep, so
+     * that the history is logged once per step by logHistory
+     * @throw std::invalid_argument if dt is not positive
+     */
+    void solve(double dt, bool updateHistory = true);
+
+    /**
+     * Log the history of every batched actuator.
+     */
+    void logHistory();
+
+    /**
+     * @return the number of batched cables
+     */
+    std::size_t size() const
+    {
+        return m_actuators.size();
+    }
+
+private:
+
+    /**
+     * Rebuild the table of distinct bodies after cables were added or
+     * removed.
+     */
+    void indexBodies();
+
+    // One entry per cable
+
+    std::vector<tgBasicActuator*> m_actuators;
+
+    std::vector<tgBulletSpringCable*> m_cables;
+
+    /** The bodies the two ends are attached to. */
+    std::vector<btRigidBody*> m_bodies1;
+
+    std::vector<btRigidBody*> m_bodies2;
+
+    /** Indices into m_bodies, valid once m_bodiesValid is set. */
+    std::vector<std::size_t> m_bodyIndex1;
+
+    std::vector<std::size_t> m_bodyIndex2;
+
+    /** The anchor positions in the frame of their body. */
+    btAlignedObjectArray<btVector3> m_localPos1;
+
+    btAlignedObjectArray<btVector3> m_localPos2;
+
+    std::vector<double> m_coefK;
+
+    std::vector<double> m_dampingCoefficient;
+
+    // Per-cable scratch, sized once and reused every solve
+
+    std::vector<double> m_restLength;
+
+    std::vector<double> m_prevLength;
+
+    std::vector<double> m_length;
+
+    std::vector<double> m_velocity;
+
+    std::vector<double> m_damping;
+
+    std::vector<double> m_magnitude;
+
+    /** The anchor positions relative to their body's center of mass. */
+    btAlignedObjectArray<btVector3> m_relPos1;
+
+    btAlignedObjectArray<btVector3> m_relPos2;
+
+    /** From the first anchor to the second. */
+    btAlignedObjectArray<btVector3> m_dist;
+
+    // One entry per distinct body
+
+    std::vector<btRigidBody*> m_bodies;
+
+    btAlignedObjectArray<btTransform> m_transforms;
+
+    btAlignedObjectArray<btVector3> m_linearImpulse;
+
+    btAlignedObjectArray<btVector3> m_angularImpulse;
+
+    bool m_bodiesValid;
+};
+
+#endif // TG_BULLET_SPRING_CABLE_SOLVER_H
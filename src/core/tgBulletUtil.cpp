@@ -41,6 +41,17 @@ btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld,
                                            const btTransform& startTransform, 
                                            btCollisionShape* shape)
 {
+    btRigidBody* body = createRigidBody(mass, startTransform, shape);
+
+    dynamicsWorld->addRigidBody(body);
+
+    return body;
+}
+
+btRigidBody* tgBulletUtil::createRigidBody(float mass,
+                                           const btTransform& startTransform,
+                                           btCollisionShape* shape)
+{
 
     btAssert((!shape || shape->getShapeType() != INVALID_SHAPE_PROXYTYPE));
 
@@ -71,8 +82,6 @@ btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld,
     body->setWorldTransform(startTransform);
 #endif//
 
-    dynamicsWorld->addRigidBody(body);
-
     return body;
 }
 
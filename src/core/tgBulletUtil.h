@@ -46,6 +46,16 @@ public:
                                         float mass, 
                                         const btTransform& startTransform, 
                                         btCollisionShape* shape);
+
+    /**
+     * Same as createRigidBody above, but the body is not added to any
+     * world. Touches no shared state, so it may be called from several
+     * threads at once for different shapes.
+     */
+    static btRigidBody* createRigidBody(float mass,
+                                        const btTransform& startTransform,
+                                        btCollisionShape* shape);
+
     /**
      * Assuming that world has a tgWorldBulletPhysicsImpl, return
      * its dynamics world.
@@ -28,7 +28,9 @@
 // The NTRT Core libary
 #include "core/tgBulletSpringCable.h"
 #include "core/tgModelVisitor.h"
+#include "core/tgSimulationState.h"
 #include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
@@ -81,6 +83,7 @@ void tgKinematicActuator::constructorAux()
   // Precondition
     assert(m_pHistory != NULL);
     prevVel = 0.0;
+    m_pSubstepWorld = NULL;
     if (m_springCable == NULL)
     {
         throw std::invalid_argument("Pointer to tgBulletSpringCable is NULL.");
@@ -124,10 +127,23 @@ void tgKinematicActuator::setup(tgWorld& world)
     // This needs to be called here in case the controller needs to cast
     notifySetup();
     tgModel::setup(world);
+
+    // The motor still steps once per call, and the cable once per substep
+    tgWorldBulletPhysicsImpl& bulletWorld =
+      (tgWorldBulletPhysicsImpl&)world.implementation();
+    if (bulletWorld.addSubstepCable(m_springCable))
+    {
+        m_pSubstepWorld = &bulletWorld;
+    }
 }
 
 void tgKinematicActuator::teardown()
 {
+    if (m_pSubstepWorld != NULL)
+    {
+        m_pSubstepWorld->removeSubstepCable(m_springCable);
+        m_pSubstepWorld = NULL;
+    }
     // Do not notify teardown. The controller has already been deleted.
     tgModel::teardown();
 }
@@ -147,7 +163,11 @@ void tgKinematicActuator::step(double dt)
         notifyStep(dt); 
         // Adjust rest length based on muscle dynamics
         integrateRestLength(dt);
-        m_springCable->step(dt);
+        // With physics substeps, the world steps the cable
+        if (m_pSubstepWorld == NULL)
+        {
+            m_springCable->step(dt);
+        }
         logHistory();  
         tgModel::step(dt);
     }
@@ -156,6 +176,27 @@ void tgKinematicActuator::step(double dt)
     m_desiredTorque = 0.0;
 }
 
+void tgKinematicActuator::saveState(tgSimulationState& state)
+{
+    state.write(m_motorVel);
+    state.write(m_motorAcc);
+    state.write(m_desiredTorque);
+    state.write(m_appliedTorque);
+    tgSpringCableActuator::saveState(state);
+}
+
+void tgKinematicActuator::restoreState(tgSimulationState& state)
+{
+    m_motorVel = state.read();
+    m_motorAcc = state.read();
+    m_desiredTorque = state.read();
+    m_appliedTorque = state.read();
+    tgSpringCableActuator::restoreState(state);
+    
+    // Postcondition
+    assert(invariant());
+}
+
 void tgKinematicActuator::onVisit(const tgModelVisitor& r) const
 {
 #ifndef BT_NO_PROFILE 
@@ -170,11 +211,11 @@ void tgKinematicActuator::logHistory()
 
     if (m_config.hist)
     {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_motorVel);
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_appliedTorque);
+        recordHistory(m_springCable->getActualLength(),
+                      m_motorVel,
+                      m_springCable->getDamping(),
+                      m_springCable->getRestLength(),
+                      m_appliedTorque);
     }
 }
     
@@ -35,6 +35,7 @@
 class tgBulletSpringCable;
 class tgModelVisitor;
 class tgWorld;
+class tgWorldBulletPhysicsImpl;
 
 // Should always be a child Model of a tgModel
 class tgKinematicActuator : public tgSpringCableActuator
@@ -137,6 +138,15 @@ public:
      */
     virtual void onVisit(const tgModelVisitor& r) const;
     
+    /**
+     * Saves the motor velocity, acceleration and torques, then everything
+     * tgSpringCableActuator::saveState saves
+     */
+    virtual void saveState(tgSimulationState& state);
+    
+    /** Restores what saveState saved */
+    virtual void restoreState(tgSimulationState& state);
+    
     /**
      * Functions for interfacing with muscle2P, and higher level controllers
      */
@@ -189,6 +199,12 @@ private:
      * Hold the previous value so history can be turned off
      */
     double prevVel;
+
+    /**
+     * The world that steps our cable before every physics substep, or
+     * NULL if we step it ourselves. Not owned.
+     */
+    tgWorldBulletPhysicsImpl* m_pSubstepWorld;
     
     /**
      * Units of rad/sec
@@ -30,20 +30,25 @@
 // The C++ Standard Library
 #include <stdexcept>
 
-tgModel::tgModel()
+tgModel::tgModel() :
+m_pParent(NULL),
+m_descendantsValid(false)
 {
   // Postcondition
   assert(invariant());
 }
 
 tgModel::tgModel(const tgTags& tags) :
-        tgTaggable(tags)
+        tgTaggable(tags),
+        m_pParent(NULL),
+        m_descendantsValid(false)
 {
   assert(invariant());
 }
 
 tgModel::~tgModel()
 {
+  clearDescendantIndex();
   const size_t n = m_children.size();
   for (size_t i = 0; i < n; ++i)
   {
@@ -73,6 +78,7 @@ void tgModel::teardown()
     delete m_children[i];
   }
   m_children.clear();
+  invalidateDescendantIndex();
   //Clear the markers
   this->m_markers.clear();
 
@@ -119,6 +125,31 @@ void tgModel::onVisit(const tgModelVisitor& r) const
   assert(invariant());
 }
 
+void tgModel::saveState(tgSimulationState& state)
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    tgModel * const pChild = m_children[i];
+    assert(pChild != NULL);
+    pChild->saveState(state);
+  }
+}
+
+void tgModel::restoreState(tgSimulationState& state)
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    tgModel * const pChild = m_children[i];
+    assert(pChild != NULL);
+    pChild->restoreState(state);
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
 void tgModel::addChild(tgModel* pChild)
 {
   // Preconditoin
@@ -132,7 +163,7 @@ void tgModel::addChild(tgModel* pChild)
   } 
   else 
   {
-    const std::vector<tgModel*> descendants = getDescendants();
+    const std::vector<tgModel*>& descendants = getCachedDescendants();
     if (std::find(descendants.begin(), descendants.end(), pChild) !=
     descendants.end())
     {
@@ -141,6 +172,8 @@ void tgModel::addChild(tgModel* pChild)
   }
 
   m_children.push_back(pChild);
+  pChild->m_pParent = this;
+  invalidateDescendantIndex();
 
   // Postcondition
   assert(invariant());
@@ -169,18 +202,51 @@ std::string tgModel::toString(std::string prefix) const
  */
 std::vector<tgModel*> tgModel::getDescendants() const
 {
-  std::vector<tgModel*> result;
-  const size_t n = m_children.size();
-  for (std::size_t i = 0; i < n; i++)
+  return getCachedDescendants();
+}
+
+const std::vector<tgModel*>& tgModel::getCachedDescendants() const
+{
+  if (!m_descendantsValid)
   {
-    tgModel* const pChild = m_children[i];
-    assert(pChild != NULL);
-    result.push_back(pChild);
-    // Recursion
-    const std::vector<tgModel*> cd = pChild->getDescendants();
-    result.insert(result.end(), cd.begin(), cd.end());
+    m_descendants.clear();
+    const size_t n = m_children.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+      tgModel* const pChild = m_children[i];
+      assert(pChild != NULL);
+      m_descendants.push_back(pChild);
+      // Recursion, which also fills the child's own list
+      const std::vector<tgModel*>& cd = pChild->getCachedDescendants();
+      m_descendants.insert(m_descendants.end(), cd.begin(), cd.end());
+    }
+    m_descendantsValid = true;
+  }
+  return m_descendants;
+}
+
+void tgModel::invalidateDescendantIndex()
+{
+  for (tgModel* pModel = this; pModel != NULL; pModel = pModel->m_pParent)
+  {
+    pModel->clearDescendantIndex();
+  }
+}
+
+void tgModel::clearDescendantIndex() const
+{
+  for (TypeIndex::iterator it = m_typeIndex.begin(); it != m_typeIndex.end(); ++it)
+  {
+    delete it->second;
+  }
+  m_typeIndex.clear();
+  for (TagIndex::iterator it = m_tagIndex.begin(); it != m_tagIndex.end(); ++it)
+  {
+    delete it->second;
   }
-  return result;
+  m_tagIndex.clear();
+  m_descendants.clear();
+  m_descendantsValid = false;
 }
 
 /**
@@ -33,10 +33,15 @@
 #include "tgSenseable.h"
 // The C++ Standard Library
 #include <iostream>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 // Forward declarations
 class tgModelVisitor;
+class tgSimulationState;
 class tgWorld;
 class abstractMarker;
 
@@ -98,6 +103,22 @@ public:
     */
     virtual void onVisit(const tgModelVisitor& r) const;
 
+    /**
+     * Write the state of this model and its descendants that the world
+     * does not hold, such as cable rest lengths and controller state.
+     * Rigid bodies are saved by the world. Subclasses with state of
+     * their own should write it and then call this.
+     * @param[in,out] state the state being saved
+     */
+    virtual void saveState(tgSimulationState& state);
+
+    /**
+     * Read back what saveState wrote, in the same order.
+     * @param[in,out] state the state being restored
+     * @throw std::runtime_error if state has too few values
+     */
+    virtual void restoreState(tgSimulationState& state);
+
     /**
     * Add a sub-model to this model.
     * The model takes ownership of the child sub-model and is responsible for
@@ -151,6 +172,55 @@ public:
      */
     std::vector<tgModel*> getDescendants() const;
 
+    /**
+     * Get the descendants of type T from an index kept by this model.
+     * Unlike find and getDescendants this does not allocate, except the
+     * first time each type is asked for after the tree below this model
+     * changes, so controllers can call it every step.
+     * @return the descendants that are a T, in the order of
+     * getDescendants; valid until addChild or teardown is called on this
+     * model or a descendant
+     */
+    template <typename T>
+    const std::vector<T*>& findCached() const
+    {
+        const std::type_info* const key = &typeid(T);
+        const TypeIndex::const_iterator it = m_typeIndex.find(key);
+        if (it != m_typeIndex.end())
+        {
+            return static_cast<const DescendantView<T>*>(it->second)->items;
+        }
+        DescendantView<T>* const pView = new DescendantView<T>();
+        pView->items = tgCast::filter<tgModel, T>(getCachedDescendants());
+        m_typeIndex[key] = pView;
+        return pView->items;
+    }
+
+    /**
+     * Get the descendants of type T that match tagSearch, from the same
+     * index as findCached<T>().
+     * Tags added to a descendant after it was indexed are not seen.
+     * @param[in] tagSearch a std::string that contains the desired tags
+     * @return the matching descendants, in the order of getDescendants;
+     * valid until addChild or teardown is called on this model or a
+     * descendant
+     */
+    template <typename T>
+    const std::vector<T*>& findCached(const std::string& tagSearch) const
+    {
+        const TagIndexKey key(&typeid(T), tagSearch);
+        const TagIndex::const_iterator it = m_tagIndex.find(key);
+        if (it != m_tagIndex.end())
+        {
+            return static_cast<const DescendantView<T>*>(it->second)->items;
+        }
+        DescendantView<T>* const pView = new DescendantView<T>();
+        pView->items =
+            tgCast::find<tgModel, T>(tgTagSearch(tagSearch), getCachedDescendants());
+        m_tagIndex[key] = pView;
+        return pView->items;
+    }
+
     const std::vector<abstractMarker>& getMarkers() const;
 
     void addMarker(abstractMarker a);
@@ -165,11 +235,91 @@ public:
 
 private:
 
+    /**
+     * A list of descendants of one type, owned by the index.
+     * The base class lets views of different types share a map.
+     */
+    struct DescendantViewBase
+    {
+        virtual ~DescendantViewBase() { }
+    };
+
+    template <typename T>
+    struct DescendantView : public DescendantViewBase
+    {
+        std::vector<T*> items;
+    };
+
+    /** Orders type_info objects, whose addresses may differ between libraries. */
+    struct TypeInfoLess
+    {
+        bool operator()(const std::type_info* a, const std::type_info* b) const
+        {
+            return a->before(*b);
+        }
+    };
+
+    typedef std::pair<const std::type_info*, std::string> TagIndexKey;
+
+    struct TagIndexKeyLess
+    {
+        bool operator()(const TagIndexKey& a, const TagIndexKey& b) const
+        {
+            if (a.first->before(*b.first)) return true;
+            if (b.first->before(*a.first)) return false;
+            return a.second < b.second;
+        }
+    };
+
+    typedef std::map<const std::type_info*, DescendantViewBase*, TypeInfoLess> TypeIndex;
+
+    typedef std::map<TagIndexKey, DescendantViewBase*, TagIndexKeyLess> TagIndex;
+
+    /**
+     * All descendants in depth first order, built on first use.
+     * @return the same as getDescendants, without copying
+     */
+    const std::vector<tgModel*>& getCachedDescendants() const;
+
+    /**
+     * Drop the index of this model and of every ancestor, since each of
+     * them lists this model's descendants.
+     */
+    void invalidateDescendantIndex();
+
+    /** Delete the views and descendant list of this model only. */
+    void clearDescendantIndex() const;
+
     /** Integrity predicate. */
     bool invariant() const;
 
+    // Not copyable: the indexes own their views, and the children
+    // point back to this model.
+    tgModel(const tgModel&);
+    tgModel& operator=(const tgModel&);
+
 private:
 
+    /**
+     * The model this is a child of, or NULL. Set by addChild, and used
+     * to invalidate the indexes of ancestors.
+     */
+    tgModel* m_pParent;
+
+    /**
+     * The cached result of getDescendants. Only valid if
+     * m_descendantsValid is true.
+     */
+    mutable std::vector<tgModel*> m_descendants;
+
+    mutable bool m_descendantsValid;
+
+    /** Views for findCached<T>(), owned by this model. */
+    mutable TypeIndex m_typeIndex;
+
+    /** Views for findCached<T>(tagSearch), owned by this model. */
+    mutable TagIndex m_tagIndex;
+
     /**
      * The collection of child models.
      * @note This could be an std::set, but std::vector is more convenient for
@@ -27,6 +27,9 @@
  * $Id$
  */
 
+// Forward declarations
+class tgSimulationState;
+
 /**
  * A mixin class which makes its derived class the Subject in the Obsever
  * design pattern. These are typically controllers.
@@ -66,6 +69,23 @@ public:
      */    
     virtual void onTeardown(Subject& subject) { }
     
+    /**
+     * Notify the observers when tgSimulation::saveState is called.
+     * Observers with state that changes during a run, such as elapsed
+     * time, should write it here so that restoring continues the run.
+     * @param[in,out] subject the subject being observed
+     * @param[in,out] state the state being saved
+     */
+    virtual void onSaveState(Subject& subject, tgSimulationState& state) { }
+    
+    /**
+     * Notify the observers when tgSimulation::restoreState is called.
+     * Read back exactly what onSaveState wrote, in the same order.
+     * @param[in,out] subject the subject being observed
+     * @param[in,out] state the state being restored
+     */
+    virtual void onRestoreState(Subject& subject, tgSimulationState& state) { }
+    
 };
    
 #endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RANDOM_STREAM_H
+#define TG_RANDOM_STREAM_H
+
+/**
+ * @file tgRandomStream.h
+ * @brief Contains the definition of class tgRandomStream
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+
+/**
+ * A counter-based random number generator: the n-th number of a stream
+ * is a hash of the stream's key and n, so it does not depend on what
+ * any other stream has drawn.
+ *
+ * Give a run one seed, and derive a substream for everything that draws
+ * numbers: one per generation for mutation, one per episode for terrain
+ * and controller noise. An episode then sees the same numbers whichever
+ * worker runs it and in whatever order, so a run is reproducible at any
+ * number of workers. Handing several candidates the same episode stream
+ * evaluates them on common random numbers, which removes the noise they
+ * share from the comparison.
+ *
+ * The hash is the finalizer of SplitMix64. Streams are cheap to copy,
+ * and a copy continues from the same counter.
+ */
+class tgRandomStream
+{
+public:
+
+    typedef unsigned long long result_type;
+
+    /**
+     * @param[in] seed the key of the stream, typically the run's seed
+     */
+    explicit tgRandomStream(result_type seed = 0) :
+    m_key(mix(seed)),
+    m_counter(0)
+    {
+    }
+
+    /**
+     * An independent stream derived from this one's key. Does not
+     * depend on, or change, how many numbers this stream has drawn.
+     * @param[in] id e.g. a generation or episode number
+     */
+    tgRandomStream substream(result_type id) const
+    {
+        tgRandomStream s;
+        s.m_key = mix(m_key ^ mix(id + goldenGamma));
+        return s;
+    }
+
+    /** The next 64 random bits */
+    result_type operator()()
+    {
+        m_counter++;
+        return mix(m_key + m_counter * goldenGamma);
+    }
+
+    /** Uniform on [0, 1), with 53 random bits */
+    double uniform()
+    {
+        return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /** Uniform on [a, b) */
+    double uniform(double a, double b)
+    {
+        return a + (b - a) * uniform();
+    }
+
+    /**
+     * Uniform on 0 to n - 1
+     * @param[in] n must be positive
+     */
+    std::size_t index(std::size_t n)
+    {
+        return static_cast<std::size_t>(uniform() * n);
+    }
+
+    /**
+     * Normally distributed, by the Box-Muller transform. Always draws
+     * two numbers, so the counter does not depend on earlier calls.
+     */
+    double normal(double mean, double stdDev)
+    {
+        const double u1 = 1.0 - uniform(); // (0, 1], so the log is finite
+        const double u2 = uniform();
+        return mean + stdDev * std::sqrt(-2.0 * std::log(u1)) *
+                      std::cos(2.0 * M_PI * u2);
+    }
+
+    /** A seed for generators that take 32 bits, such as srand */
+    unsigned int seed32()
+    {
+        return static_cast<unsigned int>((*this)() >> 32);
+    }
+
+    /** The number of 64 bit numbers drawn so far */
+    result_type getCounter() const
+    {
+        return m_counter;
+    }
+
+    static result_type min()
+    {
+        return 0;
+    }
+
+    static result_type max()
+    {
+        return ~result_type(0);
+    }
+
+private:
+
+    static result_type mix(result_type z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    static const result_type goldenGamma = 0x9e3779b97f4a7c15ULL;
+
+    result_type m_key;
+
+    result_type m_counter;
+};
+
+#endif // TG_RANDOM_STREAM_H
@@ -50,7 +50,7 @@ tgSimulation::tgSimulation(tgSimView& view) :
 
 tgSimulation::~tgSimulation()
 {
-    teardown();
+    teardown(false);
     m_view.releaseFromSimulation();
     for (std::size_t i = 0; i < m_models.size(); i++)
     {
@@ -90,8 +90,25 @@ void tgSimulation::addObstacle(tgModel* pObstacle)
     }
     else
     {
-
-        pObstacle->setup(m_view.world());
+        tgWorld& world = m_view.world();
+        if (world.keepsStaticLayer())
+        {
+            world.beginStaticLayer();
+            try
+            {
+                pObstacle->setup(world);
+            }
+            catch (...)
+            {
+                world.endStaticLayer();
+                throw;
+            }
+            world.endStaticLayer();
+        }
+        else
+        {
+            pObstacle->setup(world);
+        }
         m_obstacles.push_back(pObstacle);
     }
 
@@ -136,7 +153,7 @@ void tgSimulation::onVisit(const tgModelVisitor& r) const
 void tgSimulation::reset()
 {
 
-    teardown();
+    teardown(m_view.world().keepsStaticLayer());
 
     m_view.setup();
     for (std::size_t i = 0; i != m_models.size(); i++)
@@ -153,13 +170,15 @@ void tgSimulation::reset()
       m_dataManagers[i]->setup();
     }
     
-    // Don't need to set up obstacles since they will be added after this
+    // Don't need to set up obstacles since they will be added after this,
+    // or were kept in the world's static layer
 }
 
 void tgSimulation::reset(tgGround* newGround)
 {
 
-    teardown();
+    // The obstacles sat on the old ground
+    teardown(false);
     
     // This will reset the world twice (once in teardown, once here), but that shouldn't hurt anything
     m_view.world().reset(newGround);
@@ -182,6 +201,61 @@ void tgSimulation::reset(tgGround* newGround)
     // Don't need to set up obstacles since they were just added
 }
 
+tgSimulationState tgSimulation::saveState() const
+{
+    tgSimulationState state;
+    saveState(state);
+    return state;
+}
+
+void tgSimulation::saveState(tgSimulationState& state) const
+{
+    state.clear();
+    m_view.world().saveState(state);
+
+    state.write(m_models.size());
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        m_models[i]->saveState(state);
+    }
+    state.write(m_obstacles.size());
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        m_obstacles[i]->saveState(state);
+    }
+}
+
+void tgSimulation::restoreState(tgSimulationState& state)
+{
+    state.rewind();
+    m_view.world().restoreState(state);
+
+    if (static_cast<std::size_t>(state.read()) != m_models.size())
+    {
+        throw std::runtime_error("Simulation state was saved with a different number of models");
+    }
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        m_models[i]->restoreState(state);
+    }
+    if (static_cast<std::size_t>(state.read()) != m_obstacles.size())
+    {
+        throw std::runtime_error("Simulation state was saved with a different number of obstacles");
+    }
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        m_obstacles[i]->restoreState(state);
+    }
+
+    if (!state.atEnd())
+    {
+        throw std::runtime_error("Simulation state has more values than the simulation needs");
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
 /**
  * @note This is not inlined because it depends on the definition of tgSimView.
  */
@@ -217,6 +291,10 @@ void tgSimulation::step(double dt) const
             m_obstacles[i]->step(dt);
         }
 
+        // Apply the cable forces the world batches, now that the
+        // controllers have set the rest lengths
+        m_view.world().stepSpringCables(dt);
+
 	// Step the data managers
 	for (std::size_t i = 0; i < m_dataManagers.size(); i++) {
 	  m_dataManagers[i]->step(dt);
@@ -224,7 +302,7 @@ void tgSimulation::step(double dt) const
     }
 }
   
-void tgSimulation::teardown()
+void tgSimulation::teardown(bool keepObstacles)
 {
     const size_t n = m_models.size();
     for (std::size_t i = 0; i < n; i++)
@@ -235,7 +313,7 @@ void tgSimulation::teardown()
         pModel->teardown();
     }
     
-    while(m_obstacles.size() != 0)
+    while(!keepObstacles && m_obstacles.size() != 0)
     {
         tgModel * const pModel = m_obstacles.back();
         assert(pModel != NULL);
@@ -246,7 +324,7 @@ void tgSimulation::teardown()
         delete pModel;
         m_obstacles.pop_back();
     }
-    assert(m_obstacles.empty());
+    assert(keepObstacles || m_obstacles.empty());
 
     // Similar to the models and obstacles, tear down the data managers.
     const size_t num_DM = m_dataManagers.size(); //why not in the loop gaurd?...
@@ -259,7 +337,15 @@ void tgSimulation::teardown()
     
     // Reset the world after the models - models need world info for
     // their onTeardown() functions
-    m_view.world().reset();
+    if (keepObstacles)
+    {
+        // Keeps the obstacles' bodies and shapes in its static layer
+        m_view.world().reset();
+    }
+    else
+    {
+        m_view.world().rebuild();
+    }
     // Postcondition
     assert(invariant());
 }
@@ -26,6 +26,8 @@
  * $Id$
  */
 
+// This application
+#include "tgSimulationState.h"
 // The C++ Standard Library
 #include <iostream>
 #include <vector>
@@ -84,7 +86,10 @@ public:
     
     /**
      * Add an obstacle to the simulation.
-     * Obstacles are deleted upon reset.
+     * Obstacles are deleted upon reset, unless the world keeps a static
+     * layer (tgWorld::Config::persistentStaticLayer), in which case its
+     * bodies and shapes are added to that layer and it is kept until a
+     * reset with a new ground.
      * @param[in] pObstacle a pointer to a tgModel representing an obstacle;
      * an exception is thrown if it is NULL
      * @throw std::invalid_argument if pModel is NULL
@@ -108,7 +113,8 @@ public:
     /**
      * Calls teardown, then calls setup on the view, finally
      * calls setup on the models
-     * Will delete and remake the dynamics world
+     * Will delete and remake the dynamics world, or only clear what the
+     * models added if the world keeps a static layer
      */
     void reset();
 
@@ -117,9 +123,43 @@ public:
      * then calls setup on the view, finally
      * calls setup on the models
      * Will delete and remake the dynamics world, the previous
-     * ground will be deleted
+     * ground and the obstacles will be deleted
      */
     void reset(tgGround* newGround);
+
+    /**
+     * Take a snapshot of the world and every model and obstacle,
+     * including the controllers attached to them. Unlike reset, this
+     * does not rebuild anything, so it is cheap enough to call at
+     * every episode boundary, or to branch several rollouts from one
+     * warmed up state.
+     * @note Only what overrides saveState is captured. Models save
+     * their children, but a controller's state is saved only if its
+     * model forwards to it (with notifySaveState) and the controller
+     * implements onSaveState; any other controller keeps running from
+     * where it was. The render timer of the tgSimView and the state of
+     * data managers are never saved. Bullet's contact and solver caches
+     * are rebuilt rather than saved, so a run with contacts continues
+     * from a restore as it would after the caches were cleared.
+     * @return the snapshot, for restoreState
+     */
+    tgSimulationState saveState() const;
+
+    /**
+     * Same as saveState(), but reuses the memory already in state.
+     * @param[out] state replaced by the snapshot
+     */
+    void saveState(tgSimulationState& state) const;
+
+    /**
+     * Put the world, models, obstacles and controllers back the way they
+     * were when state was saved. The same state can be restored any number
+     * of times. Data managers are not restored, and keep logging.
+     * @param[in,out] state a snapshot from saveState() of this simulation,
+     * with no reset or added model since; only its read position changes
+     * @throw std::runtime_error if state does not match this simulation
+     */
+    void restoreState(tgSimulationState& state);
     
     /**
      * Returns a reference to the world
@@ -130,8 +170,10 @@ public:
     
     /**
      * Calls teardown on all of the models and reset on the world
+     * @param[in] keepObstacles true to keep the obstacles and only reset
+     * the world, false to delete them and rebuild the world
      */
-    void teardown();
+    void teardown(bool keepObstacles);
 
     /** Integrity predicate. */
     bool invariant() const;
@@ -149,7 +191,8 @@ private:
     std::vector<tgModel*> m_models;
     
     /**
-     * Obstacles are models that are deleted after one simulation
+     * Obstacles are models that are deleted after one simulation,
+     * unless the world keeps a static layer.
      * This allows their presence or absence to be controlled by
      * main.
      * All pointers should be non-NULL
@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSimulationPool.cpp
+ * @brief Contains the definitions of members of class tgSimulationPool
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "tgSimulationPool.h"
+// This application
+#include "tgSimulation.h"
+#include "tgSimView.h"
+#include "tgWorld.h"
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+// Every episode would write Bullet's global profiler from its own thread
+#ifndef BT_NO_PROFILE
+#error "tgSimulationPool needs Bullet and NTRT built with BT_NO_PROFILE"
+#endif
+
+tgSimulationPool::tgSimulationPool(EpisodeFactory& factory,
+                                    std::size_t nThreads,
+                                    double stepSize) :
+m_factory(factory),
+m_nThreads(nThreads > 0 ? nThreads :
+            (boost::thread::hardware_concurrency() > 0 ?
+                boost::thread::hardware_concurrency() : 1)),
+m_stepSize(stepSize),
+m_steps(0),
+m_queues(m_nThreads),
+m_pErrorMutex(new boost::mutex())
+{
+    if (stepSize <= 0.0)
+    {
+        delete m_pErrorMutex;
+        throw std::invalid_argument("stepSize is not positive");
+    }
+    
+    for (std::size_t i = 0; i < m_nThreads; i++)
+    {
+        m_queueMutexes.push_back(new boost::mutex());
+    }
+    
+    // Postcondition
+    assert(invariant());
+}
+
+tgSimulationPool::~tgSimulationPool()
+{
+    for (std::size_t i = 0; i < m_queueMutexes.size(); i++)
+    {
+        delete m_queueMutexes[i];
+    }
+    delete m_pErrorMutex;
+}
+
+std::vector<std::vector<double> > tgSimulationPool::run(std::size_t nEpisodes,
+                                                        int steps)
+{
+    if (steps <= 0)
+    {
+        throw std::invalid_argument("steps is not positive");
+    }
+    
+    m_steps = steps;
+    m_results.assign(nEpisodes, std::vector<double>());
+    m_errors.clear();
+    
+    // Deal the episodes out round robin, so each worker starts on
+    // a different part of the batch
+    for (std::size_t i = 0; i < nEpisodes; i++)
+    {
+        m_queues[i % m_nThreads].push_back(i);
+    }
+    
+    boost::thread_group workers;
+    for (std::size_t i = 0; i < m_nThreads; i++)
+    {
+        workers.create_thread(boost::bind(&tgSimulationPool::work, this, i));
+    }
+    workers.join_all();
+    
+    if (!m_errors.empty())
+    {
+        throw std::runtime_error(m_errors[0]);
+    }
+    
+    // Postcondition
+    assert(invariant());
+    
+    return m_results;
+}
+
+void tgSimulationPool::work(std::size_t worker)
+{
+    std::size_t episode = 0;
+    while (takeEpisode(worker, episode))
+    {
+        try
+        {
+            runEpisode(episode);
+        }
+        catch (std::exception& e)
+        {
+            boost::mutex::scoped_lock lock(*m_pErrorMutex);
+            m_errors.push_back(e.what());
+        }
+    }
+}
+
+bool tgSimulationPool::takeEpisode(std::size_t worker, std::size_t& episode)
+{
+    for (std::size_t i = 0; i < m_nThreads; i++)
+    {
+        const std::size_t victim = (worker + i) % m_nThreads;
+        boost::mutex::scoped_lock lock(*m_queueMutexes[victim]);
+        std::deque<std::size_t>& queue = m_queues[victim];
+        if (queue.empty())
+        {
+            continue;
+        }
+        // Own work in order, stolen work from the far end
+        if (victim == worker)
+        {
+            episode = queue.front();
+            queue.pop_front();
+        }
+        else
+        {
+            episode = queue.back();
+            queue.pop_back();
+        }
+        return true;
+    }
+    // Nothing is ever added during a run, so empty queues stay empty
+    return false;
+}
+
+void tgSimulationPool::runEpisode(std::size_t episode)
+{
+    tgWorld* const pWorld = m_factory.createWorld(episode);
+    if (pWorld == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgWorld");
+    }
+    
+    // renderRate only matters for graphics, keep it equal to stepSize
+    tgSimView* const pView = new tgSimView(*pWorld, m_stepSize, m_stepSize);
+    tgSimulation* const pSimulation = new tgSimulation(*pView);
+    
+    try
+    {
+        m_factory.populate(*pSimulation, episode);
+        try
+        {
+            pSimulation->run(m_steps);
+        }
+        catch (std::runtime_error& e)
+        {
+            // Nothing to do here, the controller will score the episode
+        }
+    }
+    catch (...)
+    {
+        delete pSimulation;
+        delete pView;
+        delete pWorld;
+        throw;
+    }
+    
+    // Teardown happens here, which is when the controllers score
+    delete pSimulation;
+    delete pView;
+    delete pWorld;
+    
+    m_results[episode] = m_factory.collect(episode);
+}
+
+bool tgSimulationPool::invariant() const
+{
+    return (m_nThreads > 0) &&
+            (m_stepSize > 0.0) &&
+            (m_queues.size() == m_nThreads) &&
+            (m_queueMutexes.size() == m_nThreads);
+}
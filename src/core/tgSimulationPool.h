@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SIMULATION_POOL_H
+#define TG_SIMULATION_POOL_H
+
+/**
+ * @file tgSimulationPool.h
+ * @brief Contains the definition of class tgSimulationPool
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+class tgWorld;
+
+namespace boost
+{
+    class mutex;
+}
+
+/**
+ * Runs independent episodes concurrently, each in its own tgWorld,
+ * tgSimView and tgSimulation. Every worker thread owns at most one
+ * world at a time, so nothing in Bullet is shared between threads.
+ * Episodes are dealt out to per-thread queues and idle threads steal
+ * from the back of the others' queues, so uneven episode lengths
+ * (early explosions, different terrains) still keep every core busy.
+ *
+ * @note Bullet's built-in profiler (BT_PROFILE) uses global state, so
+ * Bullet and NTRT are built with BT_NO_PROFILE defined (see
+ * setup_bullet.sh and inc.CMakeBullet.txt). This class does not compile
+ * without it.
+ */
+class tgSimulationPool
+{
+public:
+    
+    /**
+     * Builds the contents of one episode. All functions are called from
+     * worker threads, possibly for several episodes at once, so
+     * implementations must not share mutable state between episodes
+     * without their own locking.
+     */
+    class EpisodeFactory
+    {
+    public:
+        
+        virtual ~EpisodeFactory() { }
+        
+        /**
+         * Create the world for an episode, including its ground.
+         * @param[in] episode the index of the episode
+         * @return a new tgWorld, owned by the pool from then on
+         */
+        virtual tgWorld* createWorld(std::size_t episode) = 0;
+        
+        /**
+         * Add models (with their controllers attached), obstacles and
+         * data managers to the episode's simulation.
+         * @param[in,out] simulation the episode's simulation
+         * @param[in] episode the index of the episode
+         */
+        virtual void populate(tgSimulation& simulation, std::size_t episode) = 0;
+        
+        /**
+         * Return the result of an episode. Called after the simulation
+         * has been destroyed (and so torn down), which is when
+         * controllers compute their scores. Free any controllers that
+         * were created for the episode here.
+         * @param[in] episode the index of the episode
+         * @return the scores of the episode
+         */
+        virtual std::vector<double> collect(std::size_t episode) = 0;
+    };
+    
+    /**
+     * The only constructor.
+     * @param[in] factory creates the worlds, models and controllers
+     * @param[in] nThreads the number of worker threads, 0 to use one per
+     * hardware thread
+     * @param[in] stepSize the physics timestep of every episode; must be
+     * positive
+     * @throw std::invalid_argument if stepSize is not positive
+     */
+    tgSimulationPool(EpisodeFactory& factory,
+                    std::size_t nThreads = 0,
+                    double stepSize = 1.0/1000.0);
+    
+    ~tgSimulationPool();
+    
+    /**
+     * Run episodes 0 to nEpisodes - 1 and wait for all of them.
+     * A std::runtime_error while stepping (such as an explosion) ends
+     * that episode early; the controller is expected to score it.
+     * @param[in] nEpisodes the number of episodes to run
+     * @param[in] steps the number of steps in each episode; must be
+     * positive
+     * @return the scores of each episode, indexed by episode
+     * @throw std::invalid_argument if steps is not positive
+     * @throw std::runtime_error if an episode could not be built or
+     * scored; the remaining episodes still run
+     */
+    std::vector<std::vector<double> > run(std::size_t nEpisodes, int steps);
+    
+    /** The number of worker threads used by run() */
+    std::size_t getNumThreads() const { return m_nThreads; }
+    
+private:
+    
+    /** The body of one worker thread */
+    void work(std::size_t worker);
+    
+    /**
+     * Take the next episode, first from the front of this worker's own
+     * queue, then from the back of another worker's.
+     * @return false when every queue is empty
+     */
+    bool takeEpisode(std::size_t worker, std::size_t& episode);
+    
+    /** Build, run and score one episode */
+    void runEpisode(std::size_t episode);
+    
+    /** Integrity predicate. */
+    bool invariant() const;
+    
+private:
+    
+    EpisodeFactory& m_factory;
+    
+    const std::size_t m_nThreads;
+    
+    const double m_stepSize;
+    
+    /** Steps per episode for the current call to run() */
+    int m_steps;
+    
+    /** One queue of episode indices per worker */
+    std::vector<std::deque<std::size_t> > m_queues;
+    
+    /** Guards m_queues[i]. Pointers to keep boost out of this header. */
+    std::vector<boost::mutex*> m_queueMutexes;
+    
+    /** Results by episode. Each slot is only written by one worker. */
+    std::vector<std::vector<double> > m_results;
+    
+    /** Messages of episodes that failed outside of stepping */
+    std::vector<std::string> m_errors;
+    
+    /** Guards m_errors */
+    boost::mutex* m_pErrorMutex;
+};
+
+#endif  // TG_SIMULATION_POOL_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSimulationState.cpp
+ * @brief Contains the definitions of members of class tgSimulationState
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "tgSimulationState.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+tgSimulationState::tgSimulationState() :
+m_position(0)
+{
+}
+
+void tgSimulationState::write(double value)
+{
+    m_values.push_back(value);
+}
+
+void tgSimulationState::write(const std::deque<double>& values)
+{
+    m_values.push_back(values.size());
+    m_values.insert(m_values.end(), values.begin(), values.end());
+}
+
+double tgSimulationState::read()
+{
+    if (atEnd())
+    {
+        throw std::runtime_error("Simulation state has fewer values than the simulation needs");
+    }
+    return m_values[m_position++];
+}
+
+void tgSimulationState::read(std::deque<double>& values)
+{
+    const std::size_t n = static_cast<std::size_t>(read());
+    if (n > m_values.size() - m_position)
+    {
+        throw std::runtime_error("Simulation state has fewer values than the simulation needs");
+    }
+    const std::vector<double>::const_iterator first = m_values.begin() + m_position;
+    values.assign(first, first + n);
+    m_position += n;
+}
+
+void tgSimulationState::rewind()
+{
+    m_position = 0;
+}
+
+bool tgSimulationState::atEnd() const
+{
+    return m_position == m_values.size();
+}
+
+std::size_t tgSimulationState::size() const
+{
+    return m_values.size();
+}
+
+void tgSimulationState::clear()
+{
+    m_values.clear();
+    m_position = 0;
+}
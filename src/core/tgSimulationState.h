@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SIMULATION_STATE_H
+#define TG_SIMULATION_STATE_H
+
+/**
+ * @file tgSimulationState.h
+ * @brief Contains the definition of class tgSimulationState
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * A snapshot of a running simulation, made by tgSimulation::saveState()
+ * and put back by tgSimulation::restoreState().
+ * The world, the models and their controllers write their state as a
+ * sequence of numbers, and read it back in the same order on restore.
+ * Since nothing records what each number means, a state can only be
+ * restored into the simulation that saved it, with no reset in between.
+ */
+class tgSimulationState
+{
+public:
+
+    /** Construct an empty state. */
+    tgSimulationState();
+
+    /**
+     * Append a value.
+     * @param[in] value the value
+     */
+    void write(double value);
+
+    /**
+     * Append a sequence, preceded by its length.
+     * @param[in] values the sequence
+     */
+    void write(const std::deque<double>& values);
+
+    /**
+     * Return the next value, in the order they were written.
+     * @return the next value
+     * @throw std::runtime_error if every value has been read, which
+     * means the simulation does not match the one that was saved
+     */
+    double read();
+
+    /**
+     * Replace values with the next sequence written by write(const std::deque<double>&).
+     * @param[out] values the sequence
+     * @throw std::runtime_error if there are too few values left
+     */
+    void read(std::deque<double>& values);
+
+    /**
+     * Start reading again from the first value.
+     */
+    void rewind();
+
+    /**
+     * @return true if every value has been read
+     */
+    bool atEnd() const;
+
+    /**
+     * @return the number of values written
+     */
+    std::size_t size() const;
+
+    /**
+     * Remove every value.
+     */
+    void clear();
+
+private:
+
+    /** The values in the order they were written. */
+    std::vector<double> m_values;
+
+    /** The index of the next value to read. */
+    std::size_t m_position;
+};
+
+#endif  // TG_SIMULATION_STATE_H
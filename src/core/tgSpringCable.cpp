@@ -25,6 +25,7 @@
 // This module
 #include "tgSpringCable.h"
 #include "tgSpringCableAnchor.h"
+#include "tgSimulationState.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -76,3 +77,19 @@ void tgSpringCable::setRestLength( const double newRestLength)
     
     m_restLength = newRestLength;
 }
+
+void tgSpringCable::saveState(tgSimulationState& state) const
+{
+    state.write(m_restLength);
+    state.write(m_prevLength);
+    state.write(m_velocity);
+    state.write(m_damping);
+}
+
+void tgSpringCable::restoreState(tgSimulationState& state)
+{
+    m_restLength = state.read();
+    m_prevLength = state.read();
+    m_velocity = state.read();
+    m_damping = state.read();
+}
@@ -30,6 +30,7 @@
 #include <vector>
 
 // Forward references
+class tgSimulationState;
 class tgSpringCableAnchor;
 
 /**
@@ -78,6 +79,19 @@ public:
      */
     virtual void setRestLength( const double newRestLength); 
     
+    /**
+     * Write the rest length, previous length, velocity and damping
+     * for tgSimulation::saveState
+     * @param[in,out] state the state being saved
+     */
+    virtual void saveState(tgSimulationState& state) const;
+    
+    /**
+     * Read back what saveState wrote
+     * @param[in,out] state the state being restored
+     */
+    virtual void restoreState(tgSimulationState& state);
+    
     /**
      * Pure virtual funciton, returns the actual length of the spring
      * cable
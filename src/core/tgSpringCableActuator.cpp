@@ -25,9 +25,11 @@
 
 // This Module
 #include "tgSpringCableActuator.h"
+#include "tgSimulationState.h"
 #include "tgSpringCable.h"
 #include "tgWorld.h"
 // The C++ Standard Library
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <stdexcept>
@@ -44,7 +46,10 @@ tgSpringCableActuator::Config::Config(double s,
                    double mnRL,
 		   double rot,
    	           bool moveCPA,
-		   bool moveCPB) :
+		   bool moveCPB,
+		   HistoryMode hMode,
+		   std::size_t hCap,
+		   std::size_t hInt) :
   stiffness(s),
   damping(d),
   pretension(p),
@@ -55,7 +60,10 @@ tgSpringCableActuator::Config::Config(double s,
   minRestLength(mnRL),
   rotation(rot),
   moveCablePointAToEdge(moveCPA),
-  moveCablePointBToEdge(moveCPB)
+  moveCablePointBToEdge(moveCPB),
+  histMode(hMode),
+  histCapacity(hCap),
+  histInterval(hInt)
 {
     ///@todo is this the right place for this, or the constructor of this class?
     if (s < 0.0)
@@ -112,6 +120,30 @@ void tgSpringCableActuator::constructorAux()
     {
         throw std::invalid_argument("Starting rest length is negative.");
     }
+    else if (m_config.histMode == HISTORY_RING && m_config.histCapacity == 0)
+    {
+        throw std::invalid_argument("History capacity is zero.");
+    }
+    else if (m_config.histMode == HISTORY_DECIMATE && m_config.histInterval == 0)
+    {
+        throw std::invalid_argument("History interval is zero.");
+    }
+}
+
+tgSpringCableActuator::SpringCableActuatorHistory::SpringCableActuatorHistory() :
+    numSamples(0),
+    energySpent(0.0),
+    minTension(0.0),
+    maxTension(0.0),
+    tensionSum(0.0),
+    lastTension(0.0),
+    lastRestLength(0.0)
+{
+}
+
+double tgSpringCableActuator::SpringCableActuatorHistory::meanTension() const
+{
+    return numSamples > 0 ? tensionSum / numSamples : 0.0;
 }
 tgSpringCableActuator::tgSpringCableActuator(tgSpringCable* springCable,
                     const tgTags& tags,
@@ -159,6 +191,54 @@ void tgSpringCableActuator::step(double dt)
     }
 }
 
+void tgSpringCableActuator::saveState(tgSimulationState& state)
+{
+    m_springCable->saveState(state);
+    state.write(m_restLength);
+    state.write(m_prevVelocity);
+    
+    const SpringCableActuatorHistory& hist = *m_pHistory;
+    state.write(hist.lastLengths);
+    state.write(hist.restLengths);
+    state.write(hist.dampingHistory);
+    state.write(hist.lastVelocities);
+    state.write(hist.tensionHistory);
+    state.write(hist.numSamples);
+    state.write(hist.energySpent);
+    state.write(hist.minTension);
+    state.write(hist.maxTension);
+    state.write(hist.tensionSum);
+    state.write(hist.lastTension);
+    state.write(hist.lastRestLength);
+    
+    notifySaveState(state);
+    tgModel::saveState(state);
+}
+
+void tgSpringCableActuator::restoreState(tgSimulationState& state)
+{
+    m_springCable->restoreState(state);
+    m_restLength = state.read();
+    m_prevVelocity = state.read();
+    
+    SpringCableActuatorHistory& hist = *m_pHistory;
+    state.read(hist.lastLengths);
+    state.read(hist.restLengths);
+    state.read(hist.dampingHistory);
+    state.read(hist.lastVelocities);
+    state.read(hist.tensionHistory);
+    hist.numSamples = static_cast<std::size_t>(state.read());
+    hist.energySpent = state.read();
+    hist.minTension = state.read();
+    hist.maxTension = state.read();
+    hist.tensionSum = state.read();
+    hist.lastTension = state.read();
+    hist.lastRestLength = state.read();
+    
+    notifyRestoreState(state);
+    tgModel::restoreState(state);
+}
+
 const double tgSpringCableActuator::getStartLength() const
 {
     return m_startLength;
@@ -189,6 +269,60 @@ const tgSpringCableActuator::SpringCableActuatorHistory& tgSpringCableActuator::
     return *m_pHistory;
 }
 
+void tgSpringCableActuator::recordHistory(double length, double velocity,
+                                          double damping, double restLength,
+                                          double tension)
+{
+    SpringCableActuatorHistory& hist = *m_pHistory;
+    
+    // Aggregates see every sample
+    if (hist.numSamples == 0)
+    {
+        hist.minTension = tension;
+        hist.maxTension = tension;
+    }
+    else
+    {
+        //TODO: examine this assumption - free spinning motor may require more power
+        double motorSpeed = restLength - hist.lastRestLength;
+        if (motorSpeed > 0)
+        {
+            motorSpeed = 0;
+        }
+        hist.energySpent += hist.lastTension * motorSpeed;
+        
+        hist.minTension = std::min(hist.minTension, tension);
+        hist.maxTension = std::max(hist.maxTension, tension);
+    }
+    hist.tensionSum += tension;
+    hist.lastTension = tension;
+    hist.lastRestLength = restLength;
+    hist.numSamples++;
+    
+    if (m_config.histMode == HISTORY_AGGREGATE ||
+        (m_config.histMode == HISTORY_DECIMATE &&
+         (hist.numSamples - 1) % m_config.histInterval != 0))
+    {
+        return;
+    }
+    
+    hist.lastLengths.push_back(length);
+    hist.lastVelocities.push_back(velocity);
+    hist.dampingHistory.push_back(damping);
+    hist.restLengths.push_back(restLength);
+    hist.tensionHistory.push_back(tension);
+    
+    if (m_config.histMode == HISTORY_RING &&
+        hist.tensionHistory.size() > m_config.histCapacity)
+    {
+        hist.lastLengths.pop_front();
+        hist.lastVelocities.pop_front();
+        hist.dampingHistory.pop_front();
+        hist.restLengths.pop_front();
+        hist.tensionHistory.pop_front();
+    }
+}
+
 bool tgSpringCableActuator::invariant() const
 {
     return
@@ -32,8 +32,10 @@
 #include "tgControllable.h"
 #include "tgSubject.h"
 
+#include <cstddef>
 #include <deque> // For history
 // Forward declarations
+class tgSimulationState;
 class tgWorld;
 class tgSpringCable;
 
@@ -48,6 +50,22 @@ class tgSpringCableActuator : public tgModel, public tgControllable,
 {
 public: 
     
+    /**
+     * What is kept when Config::hist is on. Running aggregates
+     * (energy, min/max/mean tension) are kept in every mode.
+     */
+    enum HistoryMode
+    {
+        /** Every sample, for the whole run. */
+        HISTORY_FULL,
+        /** Only the last Config::histCapacity samples. */
+        HISTORY_RING,
+        /** Every Config::histInterval-th sample, starting with the first. */
+        HISTORY_DECIMATE,
+        /** No samples, only the running aggregates. */
+        HISTORY_AGGREGATE
+    };
+    
     struct Config
     {
     public:
@@ -66,7 +84,10 @@ public:
         double mnRL = 0.1,
 	double rot = 0,
 	bool moveCPA = true,
-	bool moveCPB = true);
+	bool moveCPB = true,
+	HistoryMode hMode = HISTORY_FULL,
+	std::size_t hCap = 1000,
+	std::size_t hInt = 10);
       
       /**
        * Scale parameters that depend on the length of the simulation.
@@ -105,6 +126,24 @@ public:
        * in deque objects. Useful for computing the energy of a trial.
        */
       bool hist;
+      
+      /**
+       * How much history to keep when hist is true. Long learning trials
+       * should use anything but HISTORY_FULL, since full history grows
+       * by one sample per step.
+       */
+      HistoryMode histMode;
+      
+      /**
+       * The number of samples kept by HISTORY_RING. Must be positive.
+       */
+      std::size_t histCapacity;
+      
+      /**
+       * HISTORY_DECIMATE keeps one sample out of this many.
+       * Must be positive.
+       */
+      std::size_t histInterval;
               
       // Motor model parameters
       /**
@@ -195,6 +234,40 @@ public:
         
         /** Tension history. */
         std::deque<double> tensionHistory;
+        
+        SpringCableActuatorHistory();
+        
+        /**
+         * The running aggregates below include every sample, whatever
+         * the history mode.
+         */
+        
+        /** Number of samples logged, kept or not. */
+        std::size_t numSamples;
+        
+        /**
+         * Energy spent by the motor: the sum over samples of the previous
+         * tension times the shortening of the rest length. This is the
+         * sum that controllers previously computed from tensionHistory
+         * and restLengths, and so is negative or zero.
+         */
+        double energySpent;
+        
+        /** Smallest tension seen. */
+        double minTension;
+        
+        /** Largest tension seen. */
+        double maxTension;
+        
+        /** Sum of all tensions, for meanTension(). */
+        double tensionSum;
+        
+        /** Tension and rest length of the latest sample. */
+        double lastTension;
+        double lastRestLength;
+        
+        /** @return the mean tension, or 0 before any samples */
+        double meanTension() const;
     };
 
     /** Deletes history and spring cable instantiation */
@@ -209,6 +282,15 @@ public:
     /** Just calls tgModel::step(dt) - steps any children */
     virtual void step(double dt);
     
+    /**
+     * Saves the spring cable, rest length, history and the state of
+     * any controllers attached to this actuator, then any children
+     */
+    virtual void saveState(tgSimulationState& state);
+    
+    /** Restores what saveState saved */
+    virtual void restoreState(tgSimulationState& state);
+    
     /**
      * Functions for interfacing with tgSpringCable
      */
@@ -312,6 +394,14 @@ protected:
      * history is off.
      */
     double m_prevVelocity;
+    /**
+     * Add one sample to m_pHistory according to m_config.histMode.
+     * Child classes call this from their logHistory functions when
+     * m_config.hist is on.
+     */
+    void recordHistory(double length, double velocity, double damping,
+                       double restLength, double tension);
+    
 private:
 
     /**
@@ -77,6 +77,20 @@ public:
      * were attached.
      */
     void notifyTeardown();
+
+    /**
+     * Call tgObserver<T>::onSaveState() on all observers in the order in which
+     * they were attached.
+     * @param[in,out] state the state being saved
+     */
+    void notifySaveState(tgSimulationState& state);
+
+    /**
+     * Call tgObserver<T>::onRestoreState() on all observers in the order in
+     * which they were attached.
+     * @param[in,out] state the state being restored
+     */
+    void notifyRestoreState(tgSimulationState& state);
     
 private:
 
@@ -129,5 +143,27 @@ void tgSubject<Subject>::notifyTeardown()
         if (pObserver) { pObserver->onTeardown(static_cast<Subject&>(*this)); }
     }
 }
+
+template <typename Subject> 
+void tgSubject<Subject>::notifySaveState(tgSimulationState& state)
+{
+        const std::size_t n = m_observers.size();
+    for (std::size_t i = 0; i < n; ++i) 
+    {
+        tgObserver<Subject>* const pObserver = m_observers[i];
+        if (pObserver) { pObserver->onSaveState(static_cast<Subject&>(*this), state); }
+    }
+}
+
+template <typename Subject> 
+void tgSubject<Subject>::notifyRestoreState(tgSimulationState& state)
+{
+        const std::size_t n = m_observers.size();
+    for (std::size_t i = 0; i < n; ++i) 
+    {
+        tgObserver<Subject>* const pObserver = m_observers[i];
+        if (pObserver) { pObserver->onRestoreState(static_cast<Subject&>(*this), state); }
+    }
+}
 #endif  // TG_SUBJECT_H
 
@@ -43,7 +43,12 @@
 */
 
 /**
- * Represents a search to be performed on a tgTaggable
+ * Represents a search to be performed on a tgTaggable.
+ * The search string is split and its tags interned once, on
+ * construction, so matching only compares sorted integer ids.
+ * Unlike the string queries of tgTags, this does add the tags to the
+ * table, since a search is often made before anything has the tags it
+ * looks for, as in tgBuildSpec.
  */
 class tgTagSearch
 {
@@ -77,10 +82,18 @@ public:
      */
     bool matches(const tgTags& parentTags, const tgTags& tags)
     {
-        // @todo: make sure this works correctly...
-        tgTags s(parentTags);
-        s.append(tags);
-        return matches(s);
+        const std::vector<int>& search = m_search.getIds();
+        const std::vector<int>& parentIds = parentTags.getIds();
+        const std::vector<int>& ids = tags.getIds();
+        for (std::size_t i = 0; i < search.size(); i++)
+        {
+            if (!std::binary_search(ids.begin(), ids.end(), search[i]) &&
+                !std::binary_search(parentIds.begin(), parentIds.end(), search[i]))
+            {
+                return false;
+            }
+        }
+        return true;
     }
     
     /**
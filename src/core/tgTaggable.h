@@ -71,6 +71,16 @@ public:
         return m_tags.contains(tags);
     }
     
+    /**
+     * Same as hasAllTags(std::string), for a search from
+     * tgTags::lookupAll, so searching many taggables only splits the
+     * search once.
+     */
+    bool hasAllTags(const std::vector<int>& sortedIds) const
+    {
+        return m_tags.contains(sortedIds);
+    }
+    
     bool hasAnyTags(const std::string tags)
     {
         return m_tags.containsAny(tags);
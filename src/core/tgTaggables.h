@@ -64,8 +64,10 @@ public:
     std::vector<T*> find(std::string tags) 
     {
         std::vector<T*> result;
+        // Split the search once, rather than for every element
+        const std::vector<int> search = tgTags::lookupAll(tags);
         for(int i = 0; i < m_elements.size(); i++) {
-            if(_taggable(&m_elements[i])->hasAllTags(tags)) {
+            if(_taggable(&m_elements[i])->hasAllTags(search)) {
                 result.push_back(&(m_elements[i]));
             }
         }
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTags.cpp
+ * @brief Contains the process-wide tag table used by tgTags
+ * @author Ryan Adams
+ * $Id$
+ */
+
+// This module
+#include "tgTags.h"
+// Boost
+#include <boost/thread/mutex.hpp>
+// The C++ Standard Library
+#include <map>
+
+namespace
+{
+    // Function statics, so that tgTags at namespace scope in other files
+    // can be built during static initialization
+    boost::mutex& tableMutex()
+    {
+        static boost::mutex mutex;
+        return mutex;
+    }
+
+    std::map<std::string, int>& table()
+    {
+        static std::map<std::string, int> ids;
+        return ids;
+    }
+}
+
+int tgTags::intern(const std::string& tag)
+{
+    boost::mutex::scoped_lock lock(tableMutex());
+    std::map<std::string, int>& ids = table();
+    const std::map<std::string, int>::const_iterator it = ids.find(tag);
+    if (it != ids.end())
+    {
+        return it->second;
+    }
+    const int id = static_cast<int>(ids.size());
+    ids.insert(std::make_pair(tag, id));
+    return id;
+}
+
+int tgTags::lookup(const std::string& tag)
+{
+    boost::mutex::scoped_lock lock(tableMutex());
+    const std::map<std::string, int>& ids = table();
+    const std::map<std::string, int>::const_iterator it = ids.find(tag);
+    return it == ids.end() ? -1 : it->second;
+}
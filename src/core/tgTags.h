@@ -29,6 +29,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -41,6 +42,13 @@ struct tgTagException : public tgException
    tgTagException(std::string ss) : tgException(ss) {}
 };
 
+/**
+ * An ordered list of unique tags.
+ * Each tag is also interned into a process-wide table, and the tags are
+ * kept as a sorted set of their integer ids, so comparing two tgTags
+ * compares integers rather than strings. Queries only look tags up, so
+ * only tags that some tgTags holds are ever added to the table.
+ */
 class tgTags
 {
 public:
@@ -52,13 +60,27 @@ public:
     
     bool contains(const std::string& space_separated_tags) const
     {
-        const std::deque<std::string> tags = splitTags(space_separated_tags);
-        return contains(tags);
+        return contains(lookupAll(space_separated_tags));
     }
 
+    /**
+     * Whether every id in sortedIds is one of ours. Does not allocate.
+     * @param[in] sortedIds ids from lookupAll(), sorted. An id of -1
+     * is never ours, so a search with an unknown tag matches nothing.
+     */
+    bool contains(const std::vector<int>& sortedIds) const
+    {
+        return std::includes(m_ids.begin(), m_ids.end(),
+                             sortedIds.begin(), sortedIds.end());
+    }
+
+    /**
+     * Whether every tag in tags is one of ours. Does not allocate.
+     */
     bool contains(const tgTags& tags) const
     {
-        return contains(tags.getTags());
+        return std::includes(m_ids.begin(), m_ids.end(),
+                             tags.m_ids.begin(), tags.m_ids.end());
     }
         
     bool containsAny(const std::string& space_separated_tags)
@@ -69,7 +91,18 @@ public:
 
     bool containsAny(const tgTags& tags) 
     {
-        return containsAny(tags.getTags());
+        std::vector<int>::const_iterator mine = m_ids.begin();
+        std::vector<int>::const_iterator theirs = tags.m_ids.begin();
+        while (mine != m_ids.end() && theirs != tags.m_ids.end()) {
+            if (*mine < *theirs) {
+                ++mine;
+            } else if (*theirs < *mine) {
+                ++theirs;
+            } else {
+                return true;
+            }
+        }
+        return false;
     }
 
     void append(const std::string& space_separated_tags)
@@ -187,11 +220,6 @@ public:
         return true;
     }
 
-    std::deque<std::string>& getTags()
-    {
-        return m_tags;
-    }
-
     const std::deque<std::string>& getTags() const
     {
         return m_tags;
@@ -206,15 +234,59 @@ public:
     }
 
     /**
-     * Return a non-const reference to the tag that is indexed by the
-     * int key. It must be in m_tags.
+     * Return the ids of our tags, sorted, as given by intern().
+     */
+    const std::vector<int>& getIds() const
+    {
+        return m_ids;
+    }
+
+    /**
+     * Return the id of a tag in the process-wide tag table, adding it if
+     * this is the first time the tag has been seen. Safe to call from
+     * several threads.
+     * @param[in] tag a single tag
+     * @return the tag's id, the same for the life of the process
+     */
+    static int intern(const std::string& tag);
+
+    /**
+     * Return the id of a tag without adding it to the table, so that
+     * searching for arbitrary strings does not grow it. Safe to call
+     * from several threads.
+     * @param[in] tag a single tag
+     * @return the tag's id, or -1 if no tgTags has ever held the tag
+     */
+    static int lookup(const std::string& tag);
+
+    /**
+     * Look up each tag of a search string. Unlike the constructor, tags
+     * are not validated, since a search for an invalid tag simply
+     * matches nothing.
+     * @param[in] space_separated_tags the tags to look for
+     * @return the sorted ids of the tags, for contains(const std::vector<int>&),
+     * with -1 first if any tag is unknown
+     */
+    static std::vector<int> lookupAll(const std::string& space_separated_tags)
+    {
+        const std::deque<std::string> tags = splitTags(space_separated_tags);
+        std::vector<int> ids;
+        ids.reserve(tags.size());
+        for(std::size_t i = 0; i < tags.size(); i++) {
+            ids.push_back(lookup(tags[i]));
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return ids;
+    }
+
+    /**
+     * Return a const reference to the tag that is indexed by the
+     * int key. It must be in m_tags. Tags can only be changed through
+     * append, prepend and remove, which keep the ids in step.
      * @param[in] key the key of the tag to retrieve
      * @reeturn a const reference to the tag that is indexed by key
      */
-    std::string& operator[](int key) { 
-        return m_tags[key]; 
-    }
-    
     const std::string& operator[](int key) const { 
         return m_tags[key]; 
     }
@@ -224,13 +296,16 @@ public:
      */
     bool operator==(const tgTags& rhs)
     {
-        return rhs.asSet() == asSet(); 
+        return rhs.m_ids == m_ids; 
     }
 
     tgTags& operator+=(const tgTags& rhs)
     {
         const std::deque<std::string>& other = rhs.getTags();
         m_tags.insert(m_tags.end(), other.begin(), other.end());
+        for(std::size_t i = 0; i < rhs.m_ids.size(); i++) {
+            insertId(rhs.m_ids[i]);
+        }
         return *this;
     }
 
@@ -244,7 +319,7 @@ private:
         if(!isValid(tag)) {
             throw tgTagException("Invalid tag '" + tag + "' - tags must be alphanumeric and may not be castable to int.");
         }
-        if(!containsOne(tag)) {
+        if(insertId(intern(tag))) {
             m_tags.push_back(tag);
         }
     }
@@ -257,7 +332,7 @@ private:
     }
     
     void prependOne(std::string tag) {
-        if(isValid(tag) && !containsOne(tag)) {
+        if(isValid(tag) && insertId(intern(tag))) {
             m_tags.push_front(tag);
         }
     }
@@ -288,12 +363,37 @@ private:
     /**
      * Check whether we contain a tag that is known to be valid
      */
-    bool containsOne(std::string tag) const {
-        return (std::find(m_tags.begin(), m_tags.end(), tag) != m_tags.end());
+    bool containsOne(const std::string& tag) const {
+        const int id = lookup(tag);
+        return id >= 0 && std::binary_search(m_ids.begin(), m_ids.end(), id);
     }
     
     void removeOne(std::string tag) {
+        const int id = lookup(tag);
+        if(id < 0) {
+            // Never interned, so none of ours
+            return;
+        }
         m_tags.erase(std::remove(m_tags.begin(), m_tags.end(), tag), m_tags.end());
+        const std::vector<int>::iterator it =
+            std::lower_bound(m_ids.begin(), m_ids.end(), id);
+        if(it != m_ids.end() && *it == id) {
+            m_ids.erase(it);
+        }
+    }
+    
+    /**
+     * Add an id to m_ids, keeping it sorted.
+     * @return false if the id was already there
+     */
+    bool insertId(int id) {
+        const std::vector<int>::iterator it =
+            std::lower_bound(m_ids.begin(), m_ids.end(), id);
+        if(it != m_ids.end() && *it == id) {
+            return false;
+        }
+        m_ids.insert(it, id);
+        return true;
     }
     
     void remove(std::deque<std::string> tags) {
@@ -303,6 +403,9 @@ private:
     }
     
     std::deque<std::string> m_tags;
+    
+    /** The interned ids of m_tags, sorted and without duplicates. */
+    std::vector<int> m_ids;
 };
 
 /**
@@ -34,7 +34,15 @@
 
 tgWorld::Config::Config(double g, double ws) :
 gravity(g),
-worldSize(ws)
+worldSize(ws),
+batchSpringCables(false),
+physicsSubsteps(1),
+solverType(eDantzigMLCP),
+solverIterations(10),
+splitImpulse(true),
+broadphaseType(eAxisSweep),
+maxHandles(16384),
+persistentStaticLayer(false)
 {
   if (ws <= 0.0)
   {
@@ -88,6 +96,21 @@ tgWorld::~tgWorld()
 }
 
 void tgWorld::reset()
+{
+  if (m_config.persistentStaticLayer)
+  {
+    m_pImpl->resetDynamics();
+  }
+  else
+  {
+    rebuild();
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgWorld::rebuild()
 {
   delete m_pImpl;
   m_pImpl = new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround);
@@ -99,8 +122,8 @@ void tgWorld::reset(const tgWorld::Config& config)
 {
   // Update the config
   m_config = config;
-  // Reset as usual
-  reset();
+  // The static layer was built for the old config
+  rebuild();
 
   // Postcondition
   assert(invariant());
@@ -112,8 +135,18 @@ void tgWorld::reset(tgGround * ground)
     
     m_pGround = ground;
     
-    // Reset as usual
-    reset();
+    // The static layer was built on the old ground
+    rebuild();
+}
+
+void tgWorld::beginStaticLayer()
+{
+  m_pImpl->beginStaticLayer();
+}
+
+void tgWorld::endStaticLayer()
+{
+  m_pImpl->endStaticLayer();
 }
 
 void tgWorld::step(double dt) const
@@ -129,6 +162,28 @@ void tgWorld::step(double dt) const
   }
 }
 
+void tgWorld::stepSpringCables(double dt) const
+{
+  if (dt <= 0.0)
+  {
+    throw std::invalid_argument("dt is not postive");
+  }
+  else
+  {
+    m_pImpl->stepSpringCables(dt);
+  }
+}
+
+void tgWorld::saveState(tgSimulationState& state) const
+{
+  m_pImpl->saveState(state);
+}
+
+void tgWorld::restoreState(tgSimulationState& state)
+{
+  m_pImpl->restoreState(state);
+}
+
 // Add a function that returns the amount of gravity in the world.
 // This is useful for calculating the forces applied by rigid bodies
 // inside models (e.g., ForcePlateModel.)
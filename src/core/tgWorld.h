@@ -29,6 +29,7 @@
 // Forward declarations
 class tgWorldImpl;
 class tgGround;
+class tgSimulationState;
 
 /**
  * Represents the world in which the Tensegrities operate, including
@@ -44,6 +45,26 @@ public:
    */
   struct Config
   {
+    /** The constraint solvers Bullet offers for contacts and joints. */
+    enum SolverType
+    {
+      /** btMLCPSolver with a btDantzigSolver: exact, and slowest on contacts */
+      eDantzigMLCP,
+      /** btMLCPSolver with a btSolveProjectedGaussSeidel */
+      ePGSMLCP,
+      /** btSequentialImpulseConstraintSolver: iterative, and fastest */
+      eSequentialImpulse
+    };
+
+    /** The broadphase collision detectors Bullet offers. */
+    enum BroadphaseType
+    {
+      /** btAxisSweep3, bounded by worldSize and maxHandles */
+      eAxisSweep,
+      /** btDbvtBroadphase, unbounded and quick to add and remove bodies */
+      eDbvt
+    };
+
 	Config(double g = 9.81, double ws = 1000);
     /**
      * Gravitational acceleration.
@@ -56,6 +77,63 @@ public:
      * the length of one side of the detection cube. Must be positive.
      */
     double worldSize;
+    /**
+     * Whether a tgBulletSpringCableSolver applies the forces of all
+     * basic spring cables in one pass per step, instead of each
+     * tgBasicActuator stepping its own cable. Defaults to false.
+     */
+    bool batchSpringCables;
+    /**
+     * The number of physics steps per call to step, so that the models,
+     * controllers and data managers run at a lower rate than the
+     * physics. Above 1, spring cables are batched as if
+     * batchSpringCables were set, and their forces are applied before
+     * every substep. Cables that cannot be batched, such as contact
+     * cables and those of tgKinematicActuator, are stepped one by one
+     * before every substep, while their motors step once per call.
+     * Other actuators that apply forces from their own step, such as
+     * tgCompressionSpringActuator with its tgBulletCompressionSpring
+     * or tgBulletUnidirComprSpr, are not registered for substeps: they
+     * still apply one force per call, held for the whole outer dt.
+     * Give them a hook like tgWorldBulletPhysicsImpl::addSubstepCable
+     * before raising this for models that rely on them.
+     * Must be positive. Defaults to 1.
+     */
+    int physicsSubsteps;
+    /**
+     * The constraint solver. Defaults to eDantzigMLCP.
+     */
+    SolverType solverType;
+    /**
+     * Iterations of the solver per step, which trade speed for
+     * accuracy in ePGSMLCP and eSequentialImpulse. Must be positive.
+     * Defaults to 10, as in Bullet.
+     */
+    int solverIterations;
+    /**
+     * Whether penetrations are resolved separately from velocities,
+     * so that bodies pushed apart do not gain energy. Defaults to
+     * true, as in Bullet.
+     */
+    bool splitImpulse;
+    /**
+     * The broadphase. Defaults to eAxisSweep.
+     */
+    BroadphaseType broadphaseType;
+    /**
+     * The most collision objects an eAxisSweep broadphase can hold.
+     * Must be positive. Above 32766, a bt32BitAxisSweep3 is used.
+     * Defaults to 16384.
+     */
+    int maxHandles;
+
+    /**
+     * Whether reset keeps a static layer of the ground and the
+     * obstacles, with their bodies and collision shapes, and clears
+     * only what the models added. Saves rebuilding the broadphase and
+     * terrain BVHs every episode. Defaults to false.
+     */
+    bool persistentStaticLayer;
   };
 
   /** Construct with the default configuration. */
@@ -78,9 +156,18 @@ public:
   /** Delete the implementation. */
   ~tgWorld();
 
-  /** Replace the implementation. */
+  /**
+   * Replace the implementation. With Config::persistentStaticLayer,
+   * only remove and delete what is not in the static layer, and put
+   * the static layer back where it started.
+   */
   void reset();
 
+  /**
+   * Replace the implementation, including any static layer.
+   */
+  void rebuild();
+
   /**
    * Replace the implementation with a new config.
    * @param[in] config configuration POD
@@ -92,14 +179,49 @@ public:
    * @param[in] ground the new ground
    */
   void reset(tgGround* ground);
+
+  /**
+   * Add what is added to the world from now until endStaticLayer to
+   * the static layer. Called by tgSimulation::addObstacle.
+   */
+  void beginStaticLayer();
+
+  /**
+   * Stop adding to the static layer.
+   */
+  void endStaticLayer();
     
   /**
-   * Advance the simulation.
+   * Advance the simulation, in Config::physicsSubsteps equal steps.
    * @param[in] dt the number of seconds since the previous call;
    * std::invalid_argument is thrown if dt is not positive 
    */
   void step(double dt) const;
 
+  /**
+   * Apply the forces of the cables batched by the implementation, if
+   * any. Called by tgSimulation::step after the models have stepped.
+   * @param[in] dt the number of seconds since the previous call;
+   * std::invalid_argument is thrown if dt is not positive
+   */
+  void stepSpringCables(double dt) const;
+
+  /**
+   * Save the position, orientation and velocity of every body in the
+   * world. Called by tgSimulation::saveState.
+   * @param[in,out] state the state being saved
+   */
+  void saveState(tgSimulationState& state) const;
+
+  /**
+   * Put every body back where saveState found it.
+   * Called by tgSimulation::restoreState.
+   * @param[in,out] state the state being restored
+   * @throw std::runtime_error if bodies were added or removed since
+   * the save, including by a reset
+   */
+  void restoreState(tgSimulationState& state);
+
   /**
    * Return a pointer to the implementation.
    * @return a pointer to the implementation; may be NULL.
@@ -114,6 +236,14 @@ public:
    * Returns the level of gravity in this world.
    */
   double getWorldGravity() const;
+
+  /**
+   * Whether reset keeps the static layer.
+   */
+  bool keepsStaticLayer() const
+  {
+    return m_config.persistentStaticLayer;
+  }
  
 private:
 
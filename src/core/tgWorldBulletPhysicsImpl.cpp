@@ -28,7 +28,10 @@
 #include "tgWorldBulletPhysicsImpl.h"
 // This application
 #include "tgWorld.h"
+#include "tgBulletSpringCableSolver.h"
 #include "tgCast.h"
+#include "tgSimulationState.h"
+#include "tgSpringCable.h"
 #include "terrain/tgBulletGround.h"
 #include "terrain/tgEmptyGround.h"
 // The Bullet Physics library
@@ -43,6 +46,9 @@
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "BulletDynamics/MLCPSolvers/btDantzigSolver.h"
+#include "BulletDynamics/MLCPSolvers/btSolveProjectedGaussSeidel.h"
+#include "BulletDynamics/MLCPSolvers/btMLCPSolver.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btDefaultMotionState.h"
@@ -55,15 +61,24 @@
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 
-#define MLCP_SOLVER
+// The C++ Standard Library
+#include <algorithm>
+#include <set>
+#include <stdexcept>
 
-#ifdef MLCP_SOLVER
-
-#include "BulletDynamics/MLCPSolvers/btDantzigSolver.h"
-#include "BulletDynamics/MLCPSolvers/btSolveProjectedGaussSeidel.h"
-#include "BulletDynamics/MLCPSolvers/btMLCPSolver.h"
-
-#endif //MLCP_SOLVER
+namespace
+{
+    /**
+     * Bullet's internal tick callback when there are physics substeps.
+     * The world's user info is the tgWorldBulletPhysicsImpl.
+     */
+    void solveSpringCables(btDynamicsWorld* world, btScalar timeStep)
+    {
+        tgWorldBulletPhysicsImpl* const pImpl =
+            static_cast<tgWorldBulletPhysicsImpl*>(world->getWorldUserInfo());
+        pImpl->stepSubstepCables(timeStep);
+    }
+}
 
 /**
  * Helper class to bundle objects that have the same life cycle, so they can be
@@ -72,80 +87,130 @@
 class IntermediateBuildProducts
 {
     public:
-        IntermediateBuildProducts(double worldSize) : 
-            corner1 (-worldSize,-worldSize, -worldSize),
-            corner2 (worldSize, worldSize, worldSize),
+        IntermediateBuildProducts(const tgWorld::Config& config) : 
+            corner1 (-config.worldSize,-config.worldSize, -config.worldSize),
+            corner2 (config.worldSize, config.worldSize, config.worldSize),
             dispatcher(&collisionConfiguration),
             ghostCallback(),
-#ifndef   MLCP_SOLVER       
-	#if (1) // More acc broadphase - remeber the comma (consider doing ifndef)
-				broadphase(corner1, corner2, 16384)
-	#endif // Broadphase
-#else
-			broadphase(corner1, corner2, 16384),
-			solver(&mlcp)
-#endif //MLCP_SOLVER  
-			
+            broadphase(NULL),
+            mlcp(NULL),
+            solver(NULL)
+  {
+      // Check everything before allocating anything
+      if (config.physicsSubsteps <= 0)
+      {
+          throw std::invalid_argument("physicsSubsteps is not positive");
+      }
+      if (config.solverIterations <= 0)
+      {
+          throw std::invalid_argument("solverIterations is not positive");
+      }
+      if (config.broadphaseType == tgWorld::Config::eAxisSweep &&
+          config.maxHandles <= 0)
+      {
+          throw std::invalid_argument("maxHandles is not positive");
+      }
+      
+      switch (config.broadphaseType)
+      {
+      case tgWorld::Config::eAxisSweep:
+          // btAxisSweep3 indexes two edges per handle in 16 bits, and
+          // asserts fewer than 32767 handles
+          if (config.maxHandles <= 32766)
+          {
+              broadphase = new btAxisSweep3(corner1, corner2, config.maxHandles);
+          }
+          else
+          {
+              broadphase = new bt32BitAxisSweep3(corner1, corner2, config.maxHandles);
+          }
+          break;
+      case tgWorld::Config::eDbvt:
+          broadphase = new btDbvtBroadphase();
+          break;
+      default:
+          throw std::invalid_argument("Unknown broadphase type");
+      }
+      broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+      
+      switch (config.solverType)
+      {
+      case tgWorld::Config::eDantzigMLCP:
+          mlcp = new btDantzigSolver();
+          solver = new btMLCPSolver(mlcp);
+          break;
+      case tgWorld::Config::ePGSMLCP:
+          mlcp = new btSolveProjectedGaussSeidel();
+          solver = new btMLCPSolver(mlcp);
+          break;
+      case tgWorld::Config::eSequentialImpulse:
+          solver = new btSequentialImpulseConstraintSolver();
+          break;
+      default:
+          delete broadphase;
+          throw std::invalid_argument("Unknown solver type");
+      }
+  }
+  
+  ~IntermediateBuildProducts()
   {
-	  broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+      delete solver;
+      delete mlcp;
+      delete broadphase;
   }
+  
   const btVector3 corner1;
   const btVector3 corner2;
   btSoftBodyRigidBodyCollisionConfiguration collisionConfiguration;
   btCollisionDispatcher dispatcher;
   btGhostPairCallback ghostCallback;
-#if (0) // Default broadphase
-        btDbvtBroadphase broadphase;
-#else
-        // More accurate broadphase:
-        btAxisSweep3 broadphase;
-#endif
-
-#ifdef MLCP_SOLVER
-		btDantzigSolver mlcp;
-        //btSolveProjectedGaussSeidel mlcp;
-		btMLCPSolver solver;
-#else
-		btSequentialImpulseConstraintSolver solver;
-#endif
-	
+  btBroadphaseInterface* broadphase;
+  /** NULL unless solver is a btMLCPSolver */
+  btMLCPSolverInterface* mlcp;
+  btConstraintSolver* solver;
 };
 
 tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config,
         tgBulletGround* ground) :
     tgWorldImpl(config, ground),
-    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config.worldSize)),
-    m_pDynamicsWorld(createDynamicsWorld())
+    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config)),
+    m_pDynamicsWorld(createDynamicsWorld()),
+    m_pSpringCableSolver(config.batchSpringCables || config.physicsSubsteps > 1 ?
+                         new tgBulletSpringCableSolver() : NULL),
+    m_physicsSubsteps(config.physicsSubsteps),
+    m_staticObjectsMark(-1),
+    m_staticShapesMark(-1),
+    m_staticConstraintsMark(-1)
 {
 
     // Gravitational acceleration is down on the Y axis
     const btVector3 gravityVector(0, -config.gravity, 0);
     m_pDynamicsWorld->setGravity(gravityVector);
 	
+	// The ground is always in the static layer
+	beginStaticLayer();
 	if (!tgCast::cast<tgBulletGround, tgEmptyGround>(ground) && ground != NULL)
 	{
 		m_pDynamicsWorld->addRigidBody(ground->getGroundRigidBody());
 	}
+	endStaticLayer();
 	
-	/*
-	 * These are lines from the old BasicLearningApp.cpp that we aren't using.
-	 * http://bulletphysics.org/mediawiki-1.5.8/index.php/BtContactSolverInfo
-	 */
-    #if (0) 
-		// Split impulse is on by default
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulse = true;
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulsePenetrationThreshold = -0.02;
-        
-        // Default is 10 - increases runtime but decreases odds of penetration
-        // Makes tetraspine sine waves more accurate and static test less accurate
-        m_pDynamicsWorld->getSolverInfo().m_numIterations = 20;
-        
-        // Ground contact params:
-        m_pDynamicsWorld->getSolverInfo().m_erp = 0.8;
-        
-    #endif	
+    /*
+     * http://bulletphysics.org/mediawiki-1.5.8/index.php/BtContactSolverInfo
+     * More iterations increase runtime but decrease the odds of
+     * penetration. They make tetraspine sine waves more accurate and the
+     * static test less accurate.
+     */
+    btContactSolverInfo& solverInfo = m_pDynamicsWorld->getSolverInfo();
+    solverInfo.m_numIterations = config.solverIterations;
+    solverInfo.m_splitImpulse = config.splitImpulse;
     
-
+    if (m_physicsSubsteps > 1)
+    {
+        // Before each substep's forces are integrated
+        m_pDynamicsWorld->setInternalTickCallback(&solveSpringCables,
+                                                  this, true);
+    }
     
     // Postcondition
     assert(invariant());
@@ -153,6 +218,10 @@ tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config
 
 tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
 {
+    // The models have torn down, so no cables are left in the solver
+    assert(m_substepCables.empty());
+    delete m_pSpringCableSolver;
+
     // Delete all the collision objects. The dynamics world must exist.
     // Delete in reverse order of creation.
     const size_t nco = m_pDynamicsWorld->getNumCollisionObjects();
@@ -181,6 +250,7 @@ tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
     const size_t ncs = m_collisionShapes.size();
     
     for (size_t i = 0; i < ncs; ++i) { delete m_collisionShapes[i]; }
+    for (int i = 0; i < m_staticShapes.size(); ++i) { delete m_staticShapes[i]; }
 
     delete m_pDynamicsWorld;
 
@@ -197,12 +267,9 @@ btDynamicsWorld* tgWorldBulletPhysicsImpl::createDynamicsWorld() const
    
   btSoftRigidDynamicsWorld* const result =
     new btSoftRigidDynamicsWorld(&m_pIntermediateBuildProducts->dispatcher,
-                 &m_pIntermediateBuildProducts->broadphase,
-                 &m_pIntermediateBuildProducts->solver, 
+                 m_pIntermediateBuildProducts->broadphase,
+                 m_pIntermediateBuildProducts->solver, 
                  &m_pIntermediateBuildProducts->collisionConfiguration);
-#ifdef MLCPSOLVER	
-		result ->getSolverInfo().m_minimumSolverBatchSize = 1;//for direct solver it is better to have a small A matrix
-#endif	
   return result;
 }
 
@@ -211,17 +278,377 @@ void tgWorldBulletPhysicsImpl::step(double dt)
     // Precondition
     assert(dt > 0.0);
 
-    const btScalar timeStep = dt;
-    const int maxSubSteps = 1;
-    const btScalar fixedTimeStep = dt;
-    m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    if (m_physicsSubsteps == 1)
+    {
+        const btScalar timeStep = dt;
+        const int maxSubSteps = 1;
+        const btScalar fixedTimeStep = dt;
+        m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    }
+    else
+    {
+        // One substep per call. stepSimulation(dt, n, dt / n) could take
+        // n - 1 substeps when dt / n rounds up, and carry the rest over.
+        const btScalar subStep = dt / m_physicsSubsteps;
+        for (int i = 0; i < m_physicsSubsteps; i++)
+        {
+            m_pDynamicsWorld->stepSimulation(subStep, 1, subStep);
+        }
+        m_pSpringCableSolver->logHistory();
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::stepSpringCables(double dt)
+{
+    // Precondition
+    assert(dt > 0.0);
+
+    // With substeps, solveSpringCables has applied them already
+    if (m_pSpringCableSolver != NULL && m_physicsSubsteps == 1)
+    {
+        m_pSpringCableSolver->solve(dt);
+    }
+}
+
+bool tgWorldBulletPhysicsImpl::addSubstepCable(tgSpringCable* pCable)
+{
+    // Precondition
+    assert(pCable != NULL);
+
+    if (m_physicsSubsteps == 1)
+    {
+        return false;
+    }
+    m_substepCables.push_back(pCable);
+    return true;
+}
+
+void tgWorldBulletPhysicsImpl::removeSubstepCable(tgSpringCable* pCable)
+{
+    const std::vector<tgSpringCable*>::iterator it =
+        std::find(m_substepCables.begin(), m_substepCables.end(), pCable);
+    if (it != m_substepCables.end())
+    {
+        m_substepCables.erase(it);
+    }
+}
+
+void tgWorldBulletPhysicsImpl::stepSubstepCables(double dt)
+{
+    m_pSpringCableSolver->solve(dt, false);
+    const std::size_t n = m_substepCables.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_substepCables[i]->step(dt);
+    }
+}
+
+void tgWorldBulletPhysicsImpl::saveState(tgSimulationState& state) const
+{
+    const int n = m_pDynamicsWorld->getNumCollisionObjects();
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    state.write(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const btCollisionObject * const pCollisionObject = oa[i];
+        if (btSoftBody::upcast(pCollisionObject))
+        {
+            throw std::runtime_error("Saving the state of soft bodies is not supported");
+        }
+        
+        const btTransform& transform = pCollisionObject->getWorldTransform();
+        const btVector3& origin = transform.getOrigin();
+        state.write(origin.x());
+        state.write(origin.y());
+        state.write(origin.z());
+        // The whole basis rather than a quaternion, so that a restore
+        // gives back the same bits and the run continues exactly
+        const btMatrix3x3& basis = transform.getBasis();
+        for (int row = 0; row < 3; ++row)
+        {
+            state.write(basis[row].x());
+            state.write(basis[row].y());
+            state.write(basis[row].z());
+        }
+        
+        const btRigidBody* const pRigidBody =
+            btRigidBody::upcast(pCollisionObject);
+        if (pRigidBody)
+        {
+            const btVector3& linear = pRigidBody->getLinearVelocity();
+            const btVector3& angular = pRigidBody->getAngularVelocity();
+            state.write(linear.x());
+            state.write(linear.y());
+            state.write(linear.z());
+            state.write(angular.x());
+            state.write(angular.y());
+            state.write(angular.z());
+        }
+    }
+}
+
+void tgWorldBulletPhysicsImpl::restoreState(tgSimulationState& state)
+{
+    const int n = m_pDynamicsWorld->getNumCollisionObjects();
+    if (static_cast<int>(state.read()) != n)
+    {
+        throw std::runtime_error("Simulation state was saved with a different number of collision objects");
+    }
+    
+    btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    // Copy, since removing objects changes the world's array
+    btAlignedObjectArray<btCollisionObject*> objects;
+    btAlignedObjectArray<int> groups;
+    btAlignedObjectArray<int> masks;
+    for (int i = 0; i < n; ++i)
+    {
+        btCollisionObject * const pCollisionObject = oa[i];
+        objects.push_back(pCollisionObject);
+        const btBroadphaseProxy* const pProxy = pCollisionObject->getBroadphaseHandle();
+        assert(pProxy != NULL);
+        groups.push_back(pProxy->m_collisionFilterGroup);
+        masks.push_back(pProxy->m_collisionFilterMask);
+        
+        const double x = state.read();
+        const double y = state.read();
+        const double z = state.read();
+        btMatrix3x3 basis;
+        for (int row = 0; row < 3; ++row)
+        {
+            const double bx = state.read();
+            const double by = state.read();
+            const double bz = state.read();
+            basis[row].setValue(bx, by, bz);
+        }
+        const btTransform transform(basis, btVector3(x, y, z));
+        
+        btRigidBody* const pRigidBody = btRigidBody::upcast(pCollisionObject);
+        if (pRigidBody)
+        {
+            // Also turns the inverse inertia tensor to the new orientation
+            pRigidBody->setCenterOfMassTransform(transform);
+            const double vx = state.read();
+            const double vy = state.read();
+            const double vz = state.read();
+            const btVector3 linear(vx, vy, vz);
+            const double wx = state.read();
+            const double wy = state.read();
+            const double wz = state.read();
+            const btVector3 angular(wx, wy, wz);
+            pRigidBody->setLinearVelocity(linear);
+            pRigidBody->setAngularVelocity(angular);
+            pRigidBody->setInterpolationLinearVelocity(linear);
+            pRigidBody->setInterpolationAngularVelocity(angular);
+            pRigidBody->clearForces();
+            // Rendering reads the motion state, not the body
+            if (pRigidBody->getMotionState())
+            {
+                pRigidBody->getMotionState()->setWorldTransform(transform);
+            }
+        }
+        else
+        {
+            pCollisionObject->setWorldTransform(transform);
+            pCollisionObject->setInterpolationWorldTransform(transform);
+        }
+    }
+    
+    // The broadphase pairs, contact points and solver caches all describe
+    // the bodies before the restore. Removing every object and adding them
+    // back in the same order rebuilds them the same way on every restore,
+    // so each run from a restored state is the same.
+    for (int i = n - 1; i >= 0; --i)
+    {
+        m_pDynamicsWorld->removeCollisionObject(objects[i]);
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        btRigidBody* const pRigidBody = btRigidBody::upcast(objects[i]);
+        if (pRigidBody)
+        {
+            m_pDynamicsWorld->addRigidBody(pRigidBody, groups[i], masks[i]);
+            if (!pRigidBody->isStaticOrKinematicObject())
+            {
+                pRigidBody->activate(true);
+            }
+        }
+        else
+        {
+            m_pDynamicsWorld->addCollisionObject(objects[i], groups[i], masks[i]);
+        }
+    }
+    m_pDynamicsWorld->getConstraintSolver()->reset();
+    
+    // Postcondition
+    assert(invariant());
+    assert(m_pDynamicsWorld->getNumCollisionObjects() == n);
+}
+
+void tgWorldBulletPhysicsImpl::resetDynamics()
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgWorldBulletPhysicsImpl::resetDynamics");
+#endif //BT_NO_PROFILE
+    if (m_staticObjectsMark >= 0)
+    {
+        throw std::logic_error("Cannot reset while adding a static layer");
+    }
+
+    // Constraints are deleted by their owners, which have torn down;
+    // just make sure none of theirs refer to the bodies deleted here
+    for (int i = m_pDynamicsWorld->getNumConstraints() - 1; i >= 0; --i)
+    {
+        btTypedConstraint* const pConstraint = m_pDynamicsWorld->getConstraint(i);
+        if (m_staticConstraints.findLinearSearch(pConstraint) ==
+            m_staticConstraints.size())
+        {
+            m_pDynamicsWorld->removeConstraint(pConstraint);
+        }
+    }
+
+    std::set<const btCollisionObject*> statics;
+    for (int i = 0; i < m_staticObjects.size(); ++i)
+    {
+        statics.insert(m_staticObjects[i]);
+    }
+
+    // Remove every collision object, so that the broadphase is empty,
+    // and delete those that are not static. Reverse order of creation.
+    const int nco = m_pDynamicsWorld->getNumCollisionObjects();
+    btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    for (int i = nco - 1; i >= 0; --i)
+    {
+        btCollisionObject * const pCollisionObject = oa[i];
+        m_pDynamicsWorld->removeCollisionObject(pCollisionObject);
+
+        if (statics.find(pCollisionObject) == statics.end())
+        {
+            const btRigidBody* const pRigidBody =
+                btRigidBody::upcast(pCollisionObject);
+            if (pRigidBody)
+            {
+                delete pRigidBody->getMotionState();
+            }
+            delete pCollisionObject;
+        }
+    }
+    assert(m_pDynamicsWorld->getNumCollisionObjects() == 0);
+
+    // The static shapes are in m_staticShapes, so these are the models'
+    for (int i = 0; i < m_collisionShapes.size(); ++i)
+    {
+        delete m_collisionShapes[i];
+    }
+    m_collisionShapes.clear();
+
+    // Hand out proxies and reuse manifolds as a new world would
+    m_pDynamicsWorld->getBroadphase()->resetPool(m_pDynamicsWorld->getDispatcher());
+    m_pDynamicsWorld->getConstraintSolver()->reset();
+
+    for (int i = 0; i < m_staticObjects.size(); ++i)
+    {
+        btCollisionObject * const pCollisionObject = m_staticObjects[i];
+        const btTransform& transform = m_staticTransforms[i];
+
+        btRigidBody* const pRigidBody = btRigidBody::upcast(pCollisionObject);
+        if (pRigidBody)
+        {
+            // Also turns the inverse inertia tensor to the new orientation
+            pRigidBody->setCenterOfMassTransform(transform);
+            // Obstacles that can move start each episode at rest
+            const btVector3 zero(0.0, 0.0, 0.0);
+            pRigidBody->setLinearVelocity(zero);
+            pRigidBody->setAngularVelocity(zero);
+            pRigidBody->setInterpolationLinearVelocity(zero);
+            pRigidBody->setInterpolationAngularVelocity(zero);
+            pRigidBody->clearForces();
+            if (pRigidBody->getMotionState())
+            {
+                pRigidBody->getMotionState()->setWorldTransform(transform);
+            }
+            m_pDynamicsWorld->addRigidBody(pRigidBody, m_staticGroups[i],
+                                           m_staticMasks[i]);
+            if (!pRigidBody->isStaticOrKinematicObject())
+            {
+                pRigidBody->activate(true);
+            }
+        }
+        else
+        {
+            pCollisionObject->setWorldTransform(transform);
+            pCollisionObject->setInterpolationWorldTransform(transform);
+            m_pDynamicsWorld->addCollisionObject(pCollisionObject,
+                                                 m_staticGroups[i],
+                                                 m_staticMasks[i]);
+        }
+    }
 
     // Postcondition
     assert(invariant());
+    assert(m_pDynamicsWorld->getNumCollisionObjects() == m_staticObjects.size());
+}
+
+void tgWorldBulletPhysicsImpl::beginStaticLayer()
+{
+    if (m_staticObjectsMark >= 0)
+    {
+        throw std::logic_error("Already adding a static layer");
+    }
+
+    boost::mutex::scoped_lock lock(m_collisionShapesMutex);
+    m_staticObjectsMark = m_pDynamicsWorld->getNumCollisionObjects();
+    m_staticShapesMark = m_collisionShapes.size();
+    m_staticConstraintsMark = m_pDynamicsWorld->getNumConstraints();
+}
+
+void tgWorldBulletPhysicsImpl::endStaticLayer()
+{
+    if (m_staticObjectsMark < 0)
+    {
+        throw std::logic_error("Not adding a static layer");
+    }
+
+    // Objects and constraints are appended as they are added
+    const int nco = m_pDynamicsWorld->getNumCollisionObjects();
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    for (int i = m_staticObjectsMark; i < nco; ++i)
+    {
+        btCollisionObject * const pCollisionObject = oa[i];
+        const btBroadphaseProxy* const pProxy = pCollisionObject->getBroadphaseHandle();
+        assert(pProxy != NULL);
+        m_staticObjects.push_back(pCollisionObject);
+        m_staticTransforms.push_back(pCollisionObject->getWorldTransform());
+        m_staticGroups.push_back(pProxy->m_collisionFilterGroup);
+        m_staticMasks.push_back(pProxy->m_collisionFilterMask);
+    }
+
+    const int nc = m_pDynamicsWorld->getNumConstraints();
+    for (int i = m_staticConstraintsMark; i < nc; ++i)
+    {
+        m_staticConstraints.push_back(m_pDynamicsWorld->getConstraint(i));
+    }
+
+    boost::mutex::scoped_lock lock(m_collisionShapesMutex);
+    const int ncs = m_collisionShapes.size();
+    for (int i = m_staticShapesMark; i < ncs; ++i)
+    {
+        m_staticShapes.push_back(m_collisionShapes[i]);
+    }
+    m_collisionShapes.resize(m_staticShapesMark);
+
+    m_staticObjectsMark = -1;
+    m_staticShapesMark = -1;
+    m_staticConstraintsMark = -1;
 }
 
 void tgWorldBulletPhysicsImpl::addCollisionShape(btCollisionShape* pShape)
 {
+    // Held for the profiler too, which is not thread safe either
+    boost::mutex::scoped_lock lock(m_collisionShapesMutex);
+
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("addCollisionShape");
 #endif //BT_NO_PROFILE   	
@@ -253,6 +680,7 @@ void tgWorldBulletPhysicsImpl::deleteCollisionShape(btCollisionShape* pShape)
 			}
 		}
 		m_collisionShapes.remove(pShape);
+		m_staticShapes.remove(pShape);
         delete pShape;
     }
 
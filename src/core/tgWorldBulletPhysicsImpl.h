@@ -31,10 +31,16 @@
 #include "tgWorld.h"
 #include "tgWorldImpl.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btTransform.h"
+// Boost
+#include <boost/thread/mutex.hpp>
+// The C++ Standard Library
+#include <vector>
 
 
 
 // Forward declarations
+class btCollisionObject;
 class btCollisionShape;
 class btTypedConstraint;
 class btDynamicsWorld;
@@ -43,6 +49,8 @@ class IntermediateBuildProducts;
 class btBroadphaseInterface;
 class btDispatcher;
 class tgBulletGround;
+class tgBulletSpringCableSolver;
+class tgSpringCable;
 class tgHillyGround;
 
 /**
@@ -73,6 +81,80 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
    */
   virtual void step(double dt);
 
+  /**
+   * Step the tgBulletSpringCableSolver, if there is one and there are
+   * no physics substeps.
+   * @param[in] dt the number of seconds since the previous call;
+   * must be positive
+   */
+  virtual void stepSpringCables(double dt);
+
+  /**
+   * Step a spring cable before every physics substep. For actuators
+   * whose cables the tgBulletSpringCableSolver cannot batch, since the
+   * actuators themselves only step once per call to step.
+   * @param[in] pCable the cable, which must be removed before it is
+   * destroyed
+   * @return false if there are no physics substeps, in which case the
+   * actuator must keep stepping its cable
+   */
+  bool addSubstepCable(tgSpringCable* pCable);
+
+  /**
+   * Stop stepping a cable added by addSubstepCable. Does nothing if it
+   * was not added.
+   * @param[in] pCable the cable
+   */
+  void removeSubstepCable(tgSpringCable* pCable);
+
+  /**
+   * Apply the forces of the batched cables, then step the cables added
+   * by addSubstepCable. Called by Bullet before every physics substep.
+   * @param[in] dt the length of the substep; must be positive
+   */
+  void stepSubstepCables(double dt);
+
+  /**
+   * Write the transform of every collision object, and the velocities
+   * of the rigid bodies, in the order they were added to the world.
+   * @param[in,out] state the state being saved
+   * @throw std::runtime_error if the world holds a soft body
+   */
+  virtual void saveState(tgSimulationState& state) const;
+
+  /**
+   * Read back what saveState wrote. Every object is then removed and
+   * added again, which clears the contact points and solver warm
+   * starting data from before the restore.
+   * @param[in,out] state the state being restored
+   * @throw std::runtime_error if the number of collision objects has
+   * changed since the save
+   */
+  virtual void restoreState(tgSimulationState& state);
+
+  /**
+   * Remove every collision object, then delete those that are not in
+   * the static layer, along with every collision shape that is not.
+   * The broadphase is emptied and the static layer added back in the
+   * order it was first added, at its first transforms and at rest, so
+   * every episode after a reset starts from the same state.
+   */
+  virtual void resetDynamics();
+
+  /**
+   * Note which collision objects, shapes and constraints are already
+   * in the world, so that endStaticLayer can tell the new ones apart.
+   * @throw std::logic_error if a static layer is already being added
+   */
+  virtual void beginStaticLayer();
+
+  /**
+   * Move the collision objects, shapes and constraints added since
+   * beginStaticLayer to the static layer.
+   * @throw std::logic_error if beginStaticLayer was not called
+   */
+  virtual void endStaticLayer();
+
   /**
    * Return a reference to the dynamics world.
    * @return a reference to the dynamics world
@@ -81,10 +163,21 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
   {
     return *m_pDynamicsWorld;
   }
+
+  /**
+   * Return the solver that batches spring cables.
+   * @return the solver, or NULL unless tgWorld::Config::batchSpringCables
+   * was set or there are physics substeps
+   */
+  tgBulletSpringCableSolver* springCableSolver() const
+  {
+    return m_pSpringCableSolver;
+  }
   
 	/**
 	 * Add a btCollisionShape the a collection for deletion upon
-	 * destruction.
+	 * destruction. Safe to call from several threads at once, so that
+	 * shapes can be made in parallel while building a structure.
 	 * @param[in] pShape a pointer to a btCollisionShape; do nothing if NULL
 	 */
 	void addCollisionShape(btCollisionShape* pShape);
@@ -135,6 +228,15 @@ private:
     /** The Bullet Physics representation of the tgWorld. 
      */
    btDynamicsWorld* m_pDynamicsWorld;
+
+    /** Owned. NULL unless spring cables are batched. */
+    tgBulletSpringCableSolver * const m_pSpringCableSolver;
+
+    /** From tgWorld::Config::physicsSubsteps. */
+    const int m_physicsSubsteps;
+
+    /** Cables stepped before every substep. Not owned. */
+    std::vector<tgSpringCable*> m_substepCables;
     
     /* 
      * A btAlignedObjectArray of collision shapes for easy reference. Does not affect
@@ -144,12 +246,41 @@ private:
      */
     btAlignedObjectArray<btCollisionShape*> m_collisionShapes;
 
+    /** Guards m_collisionShapes in addCollisionShape. */
+    boost::mutex m_collisionShapesMutex;
+
     /* 
      * A vector of constraints for easy reference. Does not affect
      * physics or rendering unles the constraint is placed into the dynamics
      * world.
      */
     btAlignedObjectArray<btTypedConstraint*> m_constraints;
+
+    // The static layer, kept by resetDynamics
+    
+    /** In the order they were added to the world. */
+    btAlignedObjectArray<btCollisionObject*> m_staticObjects;
+
+    /** Where each static object was when it was added. */
+    btAlignedObjectArray<btTransform> m_staticTransforms;
+
+    /** The broadphase filters each static object was added with. */
+    btAlignedObjectArray<int> m_staticGroups;
+
+    btAlignedObjectArray<int> m_staticMasks;
+
+    /** Owned, and no longer in m_collisionShapes. */
+    btAlignedObjectArray<btCollisionShape*> m_staticShapes;
+
+    /** Left in the dynamics world by resetDynamics. */
+    btAlignedObjectArray<btTypedConstraint*> m_staticConstraints;
+
+    /** The sizes noted by beginStaticLayer, or -1 when not adding. */
+    int m_staticObjectsMark;
+
+    int m_staticShapesMark;
+
+    int m_staticConstraintsMark;
 };
 
 #endif  // TG_WORLDBULLETPHYSICSIMPL_H
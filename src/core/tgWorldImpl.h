@@ -31,6 +31,7 @@
 
 // Forward declarations
 class tgGround;
+class tgSimulationState;
 
 /**
  * Abstract base class to encapsulate the implementation of the tgWorld.
@@ -55,6 +56,45 @@ public:
    * must be positive
    */
   virtual void step(double dt) = 0;
+
+  /**
+   * Apply the forces of any cables the implementation steps in a batch.
+   * The base class batches nothing.
+   * @param[in] dt the number of seconds since the previous call;
+   * must be positive
+   */
+  virtual void stepSpringCables(double dt) { }
+
+  /**
+   * Write the state of every body in the world.
+   * @param[in,out] state the state being saved
+   */
+  virtual void saveState(tgSimulationState& state) const = 0;
+
+  /**
+   * Read back what saveState wrote and move every body to it.
+   * @param[in,out] state the state being restored
+   * @throw std::runtime_error if the world has changed since the save
+   */
+  virtual void restoreState(tgSimulationState& state) = 0;
+
+  /**
+   * Remove and delete everything but the static layer, and put the
+   * static layer back where it started.
+   */
+  virtual void resetDynamics() = 0;
+
+  /**
+   * Add what is added from now until endStaticLayer to the static layer.
+   * @throw std::logic_error if a static layer is already being added
+   */
+  virtual void beginStaticLayer() = 0;
+
+  /**
+   * Stop adding to the static layer.
+   * @throw std::logic_error if beginStaticLayer was not called
+   */
+  virtual void endStaticLayer() = 0;
 };
 
 
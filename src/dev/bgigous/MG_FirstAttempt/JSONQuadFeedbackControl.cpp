@@ -133,6 +133,8 @@ JSONQuadFeedbackControl::~JSONQuadFeedbackControl()
 
 void JSONQuadFeedbackControl::onSetup(BaseSpineModelLearning& subject)
 {
+    applyTrialFile();
+    
 	// spine, 4 legs, 4 hips/shoulers
 	n_bodyParts = 9;
 
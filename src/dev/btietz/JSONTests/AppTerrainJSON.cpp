@@ -48,12 +48,20 @@ AppTerrainJSON::AppTerrainJSON(int argc, char** argv)
     startAngle = 0;
     
     suffix = "default";
+    
+    batch = NULL;
+    batchControl = NULL;
 
     handleOptions(argc, argv);
 }
 
 bool AppTerrainJSON::setup()
 {
+    if (!batchFile.empty())
+    {
+        setupBatch();
+    }
+    
     // First create the world
     world = createWorld();
 
@@ -136,6 +144,7 @@ bool AppTerrainJSON::setup()
     myControl->attach(myLogger);
 #endif        
         myModel->attach(myControl);
+        batchControl = myControl;
     }
 
     // Sixth add model & controller to simulation
@@ -172,6 +181,8 @@ void AppTerrainJSON::handleOptions(int argc, char **argv)
         ("start_z,z", po::value<double>(&startZ), "Z Coordinate of starting position for robot. Default = 0")
         ("angle,a", po::value<double>(&startAngle), "Angle of starting rotation for robot. Degrees. Default = 0")
         ("learning_controller,l", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
+        ("batch,F", po::value<std::string>(&batchFile), "File listing one controller (and optional step count) per line to run back to back. Use - for stdin. Overrides -l and -e")
+        ("batch_scores,O", po::value<std::string>(&batchScores), "File to stream batch scores to. Required with -F, since controllers print to stdout")
     ;
 
     po::variables_map vm;
@@ -274,6 +285,40 @@ tgSimView *AppTerrainJSON::createView(tgWorld *world)
     return new tgSimView(*world, timestep_physics, timestep_graphics);
 }
 
+void AppTerrainJSON::setupBatch()
+{
+    std::istream* trials = &std::cin;
+    if (batchFile != "-")
+    {
+        batchInput.open(batchFile.c_str());
+        if (!batchInput.is_open())
+        {
+            throw std::invalid_argument("Could not open batch file " + batchFile);
+        }
+        trials = &batchInput;
+    }
+    
+    // The controllers and the simulation print to stdout, which would
+    // interleave with the scores
+    if (batchScores.empty() || batchScores == "-")
+    {
+        throw std::invalid_argument("Batch mode needs a scores file (-O), stdout is not kept clean");
+    }
+    batchOutput.open(batchScores.c_str(), std::ofstream::out);
+    if (!batchOutput.is_open())
+    {
+        throw std::invalid_argument("Could not open batch scores file " + batchScores);
+    }
+    
+    batch = new BatchRunner(*trials, batchOutput, nSteps);
+    
+    // The first trial runs on the initial setup
+    if (!batch->empty())
+    {
+        suffix = batch->firstTrialFile();
+    }
+}
+
 bool AppTerrainJSON::run()
 {
     if (!bSetup)
@@ -281,7 +326,15 @@ bool AppTerrainJSON::run()
         setup();
     }
 
-    if (use_graphics)
+    if (batch != NULL)
+    {
+        if (batchControl == NULL)
+        {
+            throw std::invalid_argument("Batch mode requires the controller");
+        }
+        batch->run(*simulation, *batchControl);
+    }
+    else if (use_graphics)
     {
         // Run until the user stops
         simulation->run();
@@ -296,6 +349,7 @@ bool AppTerrainJSON::run()
    delete simulation;
    delete view;
    delete world;
+   delete batch;
     
     return true;
 }
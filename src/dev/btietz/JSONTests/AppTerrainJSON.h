@@ -35,6 +35,9 @@
 // obstacles
 #include "models/obstacles/tgBlockField.h"
 
+// learning
+#include "learning/BatchRunner/BatchRunner.h"
+
 // This library
 #include "core/tgModel.h"
 #include "core/tgSimViewGraphics.h"
@@ -47,6 +50,7 @@
 #include <boost/program_options.hpp>
 
 // The C++ Standard Library
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -84,11 +88,24 @@ private:
     /** Run a series of episodes for nSteps each */
     void simulate(tgSimulation *simulation);
     
+    /**
+     * Open the batch file (or stdin) and the scores file, and create
+     * the BatchRunner. Sets suffix to the first trial's file.
+     * @throw std::invalid_argument if no scores file was given
+     */
+    void setupBatch();
+    
     
     // Keep these around for cleanup
     tgWorld* world;
     tgSimView* view;
     tgSimulation* simulation;
+    
+    // Only used in batch mode
+    BatchRunner* batch;
+    JSONFeedbackControl* batchControl;
+    std::ifstream batchInput;
+    std::ofstream batchOutput;
 
     bool use_graphics;
     bool add_controller;
@@ -109,6 +126,12 @@ private:
     
     std::string suffix;
     
+    /** File of trials for BatchRunner, "-" for stdin. Empty if not batching */
+    std::string batchFile;
+    
+    /** The file the batch scores go to. Required in batch mode */
+    std::string batchScores;
+    
     bool bSetup;
 };
 
@@ -42,7 +42,6 @@
 #include "helpers/FileHelpers.h"
 
 #include "util/CPGEquations.h"
-#include "util/CPGNode.h"
 
 // JSON
 #include <json/json.h>
@@ -163,6 +162,8 @@ JSONCPGControl::~JSONCPGControl()
 
 void JSONCPGControl::onSetup(BaseSpineModelLearning& subject)
 {
+    applyTrialFile();
+    
     // Maximum number of sub-steps allowed by CPG
 	m_pCPGSys = new CPGEquations(200);
     //Initialize the Learning Adapters
@@ -384,6 +385,25 @@ double JSONCPGControl::getScore() const
 		throw std::runtime_error("Called before scores were obtained!");
 	}
 }
+
+void JSONCPGControl::setTrialFile(const std::string& filename)
+{
+    nextFilename = controlFilePath + filename;
+}
+
+std::vector<double> JSONCPGControl::getTrialScores() const
+{
+    return scores;
+}
+
+void JSONCPGControl::applyTrialFile()
+{
+    if (!nextFilename.empty())
+    {
+        controlFilename = nextFilename;
+        nextFilename.clear();
+    }
+}
 	
 
 array_4D JSONCPGControl::scaleEdgeActions  
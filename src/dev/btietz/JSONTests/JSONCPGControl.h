@@ -33,6 +33,7 @@
 #include "core/tgSubject.h"
 #include "core/tgObserver.h"
 #include "sensors/tgDataObserver.h"
+#include "learning/BatchRunner/BatchTrial.h"
 
 #include <json/value.h>
 
@@ -55,7 +56,7 @@ typedef boost::multi_array<double, 4> array_4D;
  * Due to the number of parameters, the learned parameters are split
  * into one config file for the nodes and another for the CPG's "edges"
  */
-class JSONCPGControl : public tgObserver<BaseSpineModelLearning>, public tgSubject <JSONCPGControl>
+class JSONCPGControl : public tgObserver<BaseSpineModelLearning>, public tgSubject <JSONCPGControl>, public BatchTrial
 {
 public:
 
@@ -125,7 +126,21 @@ struct Config
 	
 	double getScore() const;
 	
+    /**
+     * Use a different parameter file from the next onSetup onwards.
+     * Scores of the current episode still go to the current file.
+     */
+    virtual void setTrialFile(const std::string& filename);
+    
+    virtual std::vector<double> getTrialScores() const;
+    
 protected:
+    /**
+     * Switch to the file given by setTrialFile, if any. Called at the
+     * start of onSetup, before the parameters are read.
+     */
+    void applyTrialFile();
+    
     /**
      * Takes a vector of parameters reported by learning, and then 
      * converts it into a format used to assign to the CPGEdges
@@ -156,6 +171,9 @@ protected:
     
     std::string controlFilename;
     std::string controlFilePath;
+    
+    /** Set by setTrialFile, empty if there is no pending switch */
+    std::string nextFilename;
 };
 
 #endif // BASE_SPINE_CPG_CONTROL_H
@@ -45,7 +45,7 @@
 #include "util/CPGEquationsFB.h"
 #include "examples/learningSpines/tgCPGCableControl.h"
 
-#include "neuralNet/Neural Network v2/neuralNetwork.h"
+#include "learning/NeuroEvolution/BatchedNeuralNetwork.h"
 
 #include <json/json.h>
 
@@ -114,6 +114,8 @@ JSONFeedbackControl::~JSONFeedbackControl()
 
 void JSONFeedbackControl::onSetup(BaseSpineModelLearning& subject)
 {
+    applyTrialFile();
+    
 	m_pCPGSys = new CPGEquationsFB(100);
 
     Json::Value root; // will contains the root value after parsing.
@@ -152,7 +154,7 @@ void JSONFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     
     std::string nnFile = controlFilePath + feedbackParams.get("neuralFilename", "UTF-8").asString();
     
-    nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
+    nn = new BatchedNeuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
     
@@ -390,40 +392,40 @@ array_2D JSONFeedbackControl::scaleNodeActions (Json::Value actions)
 
 std::vector<double> JSONFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
-    std::vector<double> feedback;
-    
     const std::vector<tgSpringCableActuator*>& allCables = subject.getAllMuscles();
     
-    double *inputs = new double[m_config.numStates];
+    const std::size_t n = allCables.size();
+    const std::size_t numStates = m_config.numStates;
+    const std::size_t numActions = m_config.numActions;
+    
+    if (n == 0)
+    {
+        return std::vector<double>();
+    }
     
-    std::size_t n = allCables.size();
+    m_nnInputs.resize(n * numStates);
     for(std::size_t i = 0; i != n; i++)
     {
-        std::vector< std::vector<double> > actions;
-        
         const tgSpringCableActuator& cable = *(allCables[i]);
         std::vector<double > state = getCableState(cable);
+        assert(state.size() == numStates);
         
         // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
+        for (std::size_t j = 0; j < numStates; j++)
         {
-            tmpAct.push_back(output[j]);
+            m_nnInputs[i * numStates + j] = state[j] / 2.0 + 0.5;
         }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
     }
     
+    // Every cable through the network at once
+    const double* outputs = nn->feedForwardBatch(&m_nnInputs[0], n);
+    
+    // Scale values back to -1 to +1
+    std::vector<double> feedback(n * numActions);
+    for (std::size_t k = 0; k < n * numActions; k++)
+    {
+        feedback[k] = outputs[k] * 2.0 - 1.0;
+    }
     
     return feedback;
 }
@@ -443,27 +445,3 @@ std::vector<double> JSONFeedbackControl::getCableState(const tgSpringCableActuat
     
 	return state;
 }
-
-std::vector<double> JSONFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
-{
-	// Placeholder
-	std::vector<double> feedback;
-    
-    // Leave in place for generalization later
-    const std::size_t numControllers = 1;
-    const std::size_t numActions = m_config.numActions;
-    
-    assert( actions.size() == numControllers);
-    assert( actions[0].size() == numActions);
-    
-    // Scale values back to -1 to +1
-    for( std::size_t i = 0; i < numControllers; i++)
-    {
-        for( std::size_t j = 0; j < numActions; j++)
-        {
-            feedback.push_back(actions[i][j] * 2.0 - 1.0);
-        }
-    }
-    
-	return feedback;
-}
@@ -32,7 +32,7 @@
 #include <json/value.h>
 
 // Forward Declarations
-class neuralNetwork;
+class BatchedNeuralNetwork;
 class tgSpringCableActuator;
 
 /**
@@ -113,12 +113,13 @@ protected:
     
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
-    std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
-    
     JSONFeedbackControl::Config m_config;
     
     /// @todo generalize this if we need more than one
-    neuralNetwork* nn;
+    BatchedNeuralNetwork* nn;
+    
+    /// The scaled state of every cable, one row per cable, reused each step
+    std::vector<double> m_nnInputs;
     
 };
 
@@ -116,6 +116,8 @@ JSONGoalControl::~JSONGoalControl()
 
 void JSONGoalControl::onSetup(BaseSpineModelLearning& subject)
 {
+    applyTrialFile();
+    
 	m_pCPGSys = new CPGEquationsFB(200);
 
     Json::Value root; // will contains the root value after parsing.
@@ -240,7 +240,7 @@ tgWorld* AppMultiTerrain_Tetra::createWorld()
     if (add_hills)
     {
         const tgHillyGround::Config hillGroundConfig = getHillyConfig();
-        ground = new tgHillyGround(hillGroundConfig);
+        ground = new tgHeightfieldGround(hillGroundConfig);
     }
     else
     {
@@ -308,7 +308,7 @@ void AppMultiTerrain_Tetra::simulate(tgSimulation *simulation)
             {
                 
                 const tgHillyGround::Config hillGroundConfig = getHillyConfig();
-                tgBulletGround* ground = new tgHillyGround(hillGroundConfig);
+                tgBulletGround* ground = new tgHeightfieldGround(hillGroundConfig);
                 simulation->reset(ground);
             }
             // Flat
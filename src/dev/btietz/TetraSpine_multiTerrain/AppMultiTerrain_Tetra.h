@@ -42,6 +42,7 @@
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
 #include "core/terrain/tgBoxGround.h"
+#include "core/terrain/tgHeightfieldGround.h"
 #include "core/terrain/tgHillyGround.h"
 
 // Boost
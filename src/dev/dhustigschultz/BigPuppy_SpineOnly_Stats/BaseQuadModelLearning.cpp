@@ -192,8 +192,9 @@ btVector3 BaseQuadModelLearning::getSegmentCOMVector(const int n)
         throw std::range_error(tgString("Segment number > ", m_segments));
     }
     
-    std::vector<tgRod*> p_rods =
-        tgCast::filter<tgModel, tgRod> (m_allSegments[n]->getDescendants());
+    // Called every control step, so use the segment's cached index
+    const std::vector<tgRod*>& p_rods =
+        m_allSegments[n]->findCached<tgRod>();
     
     // Ensure our segments are being populated correctly
     assert(!p_rods.empty());
@@ -41,7 +41,6 @@
 #include "helpers/FileHelpers.h"
 
 #include "util/CPGEquations.h"
-#include "util/CPGNode.h"
 
 // JSON
 #include <json/json.h>
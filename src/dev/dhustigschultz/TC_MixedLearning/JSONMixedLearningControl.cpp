@@ -118,6 +118,8 @@ JSONMixedLearningControl::~JSONMixedLearningControl()
 
 void JSONMixedLearningControl::onSetup(BaseSpineModelLearning& subject)
 {
+    applyTrialFile();
+    
 	m_pCPGSys = new CPGEquationsFB(200);
 
     Json::Value root; // will contains the root value after parsing.
@@ -104,6 +104,13 @@ public:
 	
     virtual void initRigidBody(tgWorld& world);
 
+    /**
+     * Ghosts are not btRigidBodies, so initRigidBody makes them serially.
+     */
+    virtual void prepareRigidBody(tgWorld& world)
+    {
+    }
+
     virtual tgModel* createModel(tgWorld& world);
 
 #if (0) // Default to box's com so we can do compounding
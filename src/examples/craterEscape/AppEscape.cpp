@@ -26,27 +26,28 @@
 // This application
 #include "EscapeModel.h"
 #include "EscapeController.h"
+#include "EscapeTrial.h"
 
 // This library
-#include "core/terrain/tgBoxGround.h"
-#include "models/obstacles/tgCraterShallow.h"
-#include "models/obstacles/tgCraterDeep.h"
 #include "core/tgModel.h"
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
+#include "learning/AnnealEvolution/AnnealEvolution.h"
+#include "learning/BatchRunner/EvaluationPool.h"
 
-// Bullet Physics
-#include "LinearMath/btVector3.h"
+// Boost
+#include <boost/program_options.hpp>
 
 // The C++ Standard Library
 #include <iostream>
+#include <string>
+
+namespace po = boost::program_options;
 
-tgBoxGround *createGround();
-tgWorld *createWorld();
 tgSimViewGraphics *createGraphicsView(tgWorld *world);
-tgSimView *createView(tgWorld *world);
-void simulate(tgSimulation *simulation);
+void simulate(tgSimulation *simulation, int nEpisodes, int nSteps);
+void evolve(const std::string& suffix, int nWorkers, int nGenerations, int nSteps);
 
 /**
  * Runs a series of episodes. 
@@ -55,78 +56,71 @@ void simulate(tgSimulation *simulation);
  *     the maximum distance from the tensegrity's starting point 
  *     at any point during the episode
  * NB: Running episodes and using graphics are mutually exclusive features
+ * With --workers, whole generations are run at once, one world per trial,
+ * on that many worker processes.
  */
 int main(int argc, char** argv)
 {
     std::cout << "AppEscapeCrater" << std::endl;
 
+    /* Required for setting up learning file input/output. */
+    std::string suffix = "default";
+    int nWorkers = 0;
+    int nEpisodes = 1; // Number of episodes ("trial runs")
+    int nGenerations = 1;
+    int nSteps = 60000; // Number of steps in each episode, 60k is 100 seconds (timestep_physics*nSteps)
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help,h", "produce help message")
+        ("suffix", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
+        ("workers,w", po::value<int>(&nWorkers), "Worker processes that evaluate a generation at once. Default = 0, one episode at a time in this process")
+        ("generations,g", po::value<int>(&nGenerations), "Generations to evaluate with --workers. Default = 1")
+        ("episodes,e", po::value<int>(&nEpisodes), "Number of episodes to run without --workers. Default = 1")
+        ("steps,s", po::value<int>(&nSteps), "Number of steps per episode. Default = 60000")
+    ;
+    // The suffix used to be the only argument
+    po::positional_options_description positional;
+    positional.add("suffix", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+    if (vm.count("help"))
+    {
+        std::cout << desc << "\n";
+        return 0;
+    }
+    po::notify(vm);
+
+    if (nWorkers > 0)
+    {
+        evolve(suffix, nWorkers, nGenerations, nSteps);
+        return 0;
+    }
+
     // First create the world
-    tgWorld *world = createWorld();
+    tgWorld *world = EscapeTrial::createWorld();
 
     // Second create the view
     //tgSimViewGraphics *view = createGraphicsView(world); // For visual experimenting on one tensegrity
-    tgSimView       *view = createView(world);         // For running multiple episodes
+    tgSimView       *view = EscapeTrial::createView(world);         // For running multiple episodes
 
     // Third create the simulation
     tgSimulation *simulation = new tgSimulation(*view);
 
-    // Fourth create the models with their controllers and add the models to the simulation
-    EscapeModel* const model = new EscapeModel();
+    // Fourth create controller, which gets the parameters from learning
+    EscapeController* const controller = EscapeTrial::createController(suffix);
 
-    /* Required for setting up learning file input/output. */
-    const std::string suffix((argc > 1) ? argv[1] : "default");
-    
-    
-    
-    // Fifth create controller and attach it to the model
-    double initialLength = 9.0; // decimeters
-    EscapeController* const controller = new EscapeController(initialLength,
-                                                                suffix,
-                                                                "craterEscape/",
-                                                                "Config.ini");
-    model->attach(controller);
-
-    //Sixth add model (with controller) to simulation
-    simulation->addModel(model);
-
-    //Seventh add crater to simulation
-    btVector3 originCrater = btVector3(0,0,0);
-    //tgCraterShallow* crater = new tgCraterShallow(originCrater);
-    tgCraterDeep* crater = new tgCraterDeep(originCrater);
-    simulation->addModel(crater);
-
-    simulate(simulation);
+    // Fifth add the model with the controller and the crater to the simulation
+    EscapeTrial::populate(*simulation, controller);
+
+    simulate(simulation, nEpisodes, nSteps);
 
     delete controller;
     //Teardown is handled by delete, so that should be automatic
     return 0;
 }
 
-tgBoxGround *createGround() {
-    // Determine the angle of the ground in radians. All 0 is flat
-    const double yaw = 0.0;
-    const double pitch = 0.0;
-    const double roll = 0.0;
-    const btVector3 eulerAngles = btVector3(yaw, pitch, roll);  // Default: (0.0, 0.0, 0.0)
-    const double friction = 0.5; // Default: 0.5
-    const double restitution = 0.0;  // Default: 0.0
-    const btVector3 size = btVector3(10000.0, 2, 10000.0); // Default: (500.0, 1.5, 500.0)
-    const btVector3 origin = btVector3(0.0, 0.0, 0.0); // Default: (0.0, 0.0, 0.0)
-    const tgBoxGround::Config groundConfig(eulerAngles, friction, restitution,
-                                           size, origin);
-    // the world will delete this
-    return new tgBoxGround(groundConfig);
-}
-
-tgWorld *createWorld() {
-    const tgWorld::Config config(98.1); // gravity, cm/sec^2  Use this to adjust length scale of world.
-    // NB: by changing the setting below from 981 to 98.1, we've
-    // scaled the world length scale to decimeters not cm.
-
-    tgBoxGround* ground = createGround();
-    return new tgWorld(config, ground);
-}
-
 /** Use for displaying tensegrities in simulation */
 tgSimViewGraphics *createGraphicsView(tgWorld *world) {
     const double timestep_physics = 1.0 / 60.0 / 10.0; // Seconds
@@ -134,20 +128,21 @@ tgSimViewGraphics *createGraphicsView(tgWorld *world) {
     return new tgSimViewGraphics(*world, timestep_physics, timestep_graphics); 
 }
 
-/** Use for trial episodes of many tensegrities in an experiment */
-tgSimView *createView(tgWorld *world) {
-    const double timestep_physics = 1.0 / 60.0 / 10.0; // Seconds
-    const double timestep_graphics = 1.f /60.f; // Seconds, AKA render rate. Leave at 1/60 for real-time viewing
-    return new tgSimView(*world, timestep_physics, timestep_graphics); 
-}
-
 /** Run a series of episodes for nSteps each */
-void simulate(tgSimulation *simulation) {
-    int nEpisodes = 1; // Number of episodes ("trial runs")
-    int nSteps = 60000; // Number of steps in each episode, 60k is 100 seconds (timestep_physics*nSteps)
+void simulate(tgSimulation *simulation, int nEpisodes, int nSteps) {
     for (int i=0; i<nEpisodes; i++) {
         simulation->run(nSteps);
         simulation->reset();
     }
 }
 
+/** Evaluate whole generations on nWorkers processes */
+void evolve(const std::string& suffix, int nWorkers, int nGenerations, int nSteps) {
+    AnnealEvolution evolution(suffix, "Config.ini", "craterEscape/");
+    EvaluationPool pool(nWorkers);
+    EscapeTrial trial(suffix, nSteps);
+    for (int i=0; i<nGenerations; i++) {
+        std::cout << "Generation " << i << std::endl;
+        evolution.evaluateGeneration(pool, trial);
+    }
+}
@@ -119,11 +119,12 @@ void EscapeController::onStep(EscapeModel& subject, double dt)
 // So far, only score used for eventual fitness calculation of an Escape Model
 // is the maximum distance from the origin reached during that subject's episode
 void EscapeController::onTeardown(EscapeModel& subject) {
-    std::vector<double> scores; //scores[0] == displacement, scores[1] == energySpent
+    //scores[0] == displacement, scores[1] == energySpent
     double distance = displacement(subject);
     double energySpent = totalEnergySpent(subject);
 
     //Invariant: For now, scores must be of size 2 (as required by endEpisode())
+    scores.clear();
     scores.push_back(distance);
     scores.push_back(energySpent);
 
@@ -133,6 +134,16 @@ void EscapeController::onTeardown(EscapeModel& subject) {
     // If any of subject's dynamic objects need to be freed, this is the place to do so
 }
 
+void EscapeController::setTrialControllers(const std::vector<AnnealEvoMember*>& controllers)
+{
+    trialControllers = controllers;
+}
+
+const std::vector<double>& EscapeController::getScores() const
+{
+    return scores;
+}
+
 /** 
  * Returns the modified actions 2D vector such that 
  *   each action value is now scaled to fit the model
@@ -208,11 +219,18 @@ void EscapeController::setupAdapter() {
     }
     
     std::string configAnnealEvolution = path + configName;
-    AnnealEvolution* evo = new AnnealEvolution(suffix, configName, configPath);
-    bool isLearning = true;
     configuration configEvolutionAdapter;
     configEvolutionAdapter.readFile(configAnnealEvolution);
 
+    if (!trialControllers.empty())
+    {
+        // Part of a generation evaluated by AnnealEvolution
+        evolutionAdapter.initialize(trialControllers, configEvolutionAdapter);
+        return;
+    }
+
+    AnnealEvolution* evo = new AnnealEvolution(suffix, configName, configPath);
+    bool isLearning = true;
     evolutionAdapter.initialize(evo, isLearning, configEvolutionAdapter);
 }
 
@@ -222,20 +240,8 @@ double EscapeController::totalEnergySpent(EscapeModel& subject) {
     std::vector<tgBasicActuator* > tmpStrings = subject.getAllMuscles();
     for(int i=0; i<tmpStrings.size(); i++)
     {
-        tgSpringCableActuator::SpringCableActuatorHistory stringHist = tmpStrings[i]->getHistory();
-
-        for(int j=1; j<stringHist.tensionHistory.size(); j++)
-        {
-            const double previousTension = stringHist.tensionHistory[j-1];
-            const double previousLength = stringHist.restLengths[j-1];
-            const double currentLength = stringHist.restLengths[j];
-            //TODO: examine this assumption - free spinning motor may require more power         
-            double motorSpeed = (currentLength-previousLength);
-            if(motorSpeed > 0) // Vestigial code
-                motorSpeed = 0;
-            const double workDone = previousTension * motorSpeed;
-            totalEnergySpent += workDone;
-        }
+        // Summed as the history is logged, so this works in every history mode
+        totalEnergySpent += tmpStrings[i]->getHistory().energySpent;
     }
     return totalEnergySpent;
 }
@@ -57,6 +57,19 @@ class EscapeController : public tgObserver<EscapeModel>
 
         virtual void onTeardown(EscapeModel& subject);
 
+        /**
+         * Use these parameters from the next onSetup on, instead of
+         * taking them from an AnnealEvolution of our own. This is how
+         * EscapeTrial runs the trials of AnnealEvolution::evaluateGeneration,
+         * which records the scores itself.
+         * @param[in] controllers one member per cluster, owned by the
+         * evolution
+         */
+        void setTrialControllers(const std::vector<AnnealEvoMember*>& controllers);
+
+        /** The scores of the last episode torn down, distance then energy */
+        const std::vector<double>& getScores() const;
+
     protected:
         virtual std::vector< std::vector <double> > transformActions(std::vector< std::vector <double> > act);
 
@@ -71,6 +84,9 @@ class EscapeController : public tgObserver<EscapeModel>
         // Evolution and Adapter
         AnnealAdapter evolutionAdapter;
         std::vector< std::vector<double> > actions; // For modifications between episodes
+        /** Set by setTrialControllers, empty when learning on our own */
+        std::vector<AnnealEvoMember*> trialControllers;
+        std::vector<double> scores; // Of the last episode
 
         // Muscle Clusters
         int nClusters;
@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file EscapeTrial.cpp
+ * @brief Contains the implementation of class EscapeTrial.
+ * $Id$
+ */
+
+// This module
+#include "EscapeTrial.h"
+// This application
+#include "EscapeController.h"
+#include "EscapeModel.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "models/obstacles/tgCraterDeep.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <iostream>
+#include <stdexcept>
+
+EscapeTrial::EscapeTrial(const std::string& suffix, int nSteps) :
+    m_suffix(suffix),
+    m_nSteps(nSteps)
+{
+    if (nSteps <= 0) {
+        throw std::invalid_argument("nSteps is not positive");
+    }
+}
+
+std::vector<double> EscapeTrial::evaluate(const std::vector<AnnealEvoMember*>& controllers,
+                                          tgRandomStream episode)
+{
+    // The crater is fixed, so the episode stream is not needed yet
+    tgWorld* const world = createWorld();
+    tgSimView* const view = createView(world);
+    tgSimulation* const simulation = new tgSimulation(*view);
+
+    EscapeController* const controller = createController(m_suffix);
+    controller->setTrialControllers(controllers);
+    populate(*simulation, controller);
+
+    bool failed = false;
+    try {
+        simulation->run(m_nSteps);
+    }
+    catch (std::runtime_error& e) {
+        std::cerr << "Trial failed: " << e.what() << std::endl;
+        failed = true;
+    }
+
+    // Tearing down the model scores the episode
+    delete simulation;
+    delete view;
+    delete world;
+
+    std::vector<double> scores;
+    if (!failed) {
+        scores = controller->getScores();
+    }
+    delete controller;
+    return scores;
+}
+
+tgWorld* EscapeTrial::createWorld() {
+    // Determine the angle of the ground in radians. All 0 is flat
+    const double yaw = 0.0;
+    const double pitch = 0.0;
+    const double roll = 0.0;
+    const btVector3 eulerAngles = btVector3(yaw, pitch, roll);  // Default: (0.0, 0.0, 0.0)
+    const double friction = 0.5; // Default: 0.5
+    const double restitution = 0.0;  // Default: 0.0
+    const btVector3 size = btVector3(10000.0, 2, 10000.0); // Default: (500.0, 1.5, 500.0)
+    const btVector3 origin = btVector3(0.0, 0.0, 0.0); // Default: (0.0, 0.0, 0.0)
+    const tgBoxGround::Config groundConfig(eulerAngles, friction, restitution,
+                                           size, origin);
+    // the world will delete this
+    tgBoxGround* ground = new tgBoxGround(groundConfig);
+
+    const tgWorld::Config config(98.1); // gravity, cm/sec^2  Use this to adjust length scale of world.
+    // NB: by changing the setting below from 981 to 98.1, we've
+    // scaled the world length scale to decimeters not cm.
+    return new tgWorld(config, ground);
+}
+
+tgSimView* EscapeTrial::createView(tgWorld* world) {
+    const double timestep_physics = 1.0 / 60.0 / 10.0; // Seconds
+    const double timestep_graphics = 1.f /60.f; // Seconds, AKA render rate. Leave at 1/60 for real-time viewing
+    return new tgSimView(*world, timestep_physics, timestep_graphics);
+}
+
+EscapeController* EscapeTrial::createController(const std::string& suffix) {
+    double initialLength = 9.0; // decimeters
+    return new EscapeController(initialLength,
+                                suffix,
+                                "craterEscape/",
+                                "Config.ini");
+}
+
+void EscapeTrial::populate(tgSimulation& simulation, EscapeController* controller) {
+    EscapeModel* const model = new EscapeModel();
+    model->attach(controller);
+    simulation.addModel(model);
+
+    btVector3 originCrater = btVector3(0,0,0);
+    //tgCraterShallow* crater = new tgCraterShallow(originCrater);
+    tgCraterDeep* crater = new tgCraterDeep(originCrater);
+    simulation.addModel(crater);
+}
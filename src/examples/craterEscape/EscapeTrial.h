@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef ESCAPETRIAL
+#define ESCAPETRIAL
+
+/**
+ * @file EscapeTrial.h
+ * @brief Contains the definition of class EscapeTrial.
+ * $Id$
+ */
+
+// This library
+#include "learning/AnnealEvolution/AnnealEvolution.h"
+// The C++ Standard Library
+#include <string>
+#include <vector>
+
+// Forward declarations
+class EscapeController;
+class tgSimulation;
+class tgSimView;
+class tgWorld;
+
+/**
+ * Runs one escape episode per trial of AnnealEvolution::evaluateGeneration,
+ * each in a world of its own, so a generation can be spread over the
+ * workers of an EvaluationPool. Also builds the world and the models for
+ * AppEscape, so both run the same experiment.
+ */
+class EscapeTrial : public AnnealEvolution::Trial
+{
+    public:
+        /**
+         * @param[in] suffix the suffix of the learning logs
+         * @param[in] nSteps the length of every episode. Must be positive.
+         * @throw std::invalid_argument if nSteps is not positive
+         */
+        EscapeTrial(const std::string& suffix, int nSteps);
+
+        /**
+         * Build a world with the crater, run the controllers in it for
+         * nSteps and tear it down again.
+         * @return the distance and the energy, or empty if the
+         * simulation failed
+         */
+        virtual std::vector<double> evaluate(const std::vector<AnnealEvoMember*>& controllers,
+                                             tgRandomStream episode);
+
+        /** The ground and gravity of the experiment, in decimeters */
+        static tgWorld* createWorld();
+
+        /** A view without graphics, for running many episodes */
+        static tgSimView* createView(tgWorld* world);
+
+        /** A controller reading Config.ini from the craterEscape resources */
+        static EscapeController* createController(const std::string& suffix);
+
+        /**
+         * Add the model, with the controller attached, and the crater.
+         * The caller keeps ownership of the controller.
+         */
+        static void populate(tgSimulation& simulation, EscapeController* controller);
+
+    private:
+        const std::string m_suffix;
+        const int m_nSteps;
+};
+
+#endif // ESCAPETRIAL
@@ -42,7 +42,7 @@
 #include "learning/Configuration/configuration.h"
 
 #include "util/CPGEquations.h"
-#include "util/CPGNode.h"
+#include "core/tgSimulationState.h"
 
 //#define LOGGING
 
@@ -278,6 +278,22 @@ void BaseSpineCPGControl::onStep(BaseSpineModelLearning& subject, double dt)
 	}
 }
 
+void BaseSpineCPGControl::onSaveState(BaseSpineModelLearning& subject,
+                                      tgSimulationState& state)
+{
+    state.write(m_updateTime);
+    state.write(bogus ? 1.0 : 0.0);
+    m_pCPGSys->saveState(state);
+}
+
+void BaseSpineCPGControl::onRestoreState(BaseSpineModelLearning& subject,
+                                         tgSimulationState& state)
+{
+    m_updateTime = state.read();
+    bogus = state.read() != 0.0;
+    m_pCPGSys->restoreState(state);
+}
+
 void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
 {
     scores.clear();
@@ -310,20 +326,8 @@ void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
     
     for(int i=0; i<tmpStrings.size(); i++)
     {
-        tgSpringCableActuator::SpringCableActuatorHistory stringHist = tmpStrings[i]->getHistory();
-        
-        for(int j=1; j<stringHist.tensionHistory.size(); j++)
-        {
-            const double previousTension = stringHist.tensionHistory[j-1];
-            const double previousLength = stringHist.restLengths[j-1];
-            const double currentLength = stringHist.restLengths[j];
-            //TODO: examine this assumption - free spinning motor may require more power
-            double motorSpeed = (currentLength-previousLength);
-            if(motorSpeed > 0) // Vestigial code
-                motorSpeed = 0;
-            const double workDone = previousTension * motorSpeed;
-            totalEnergySpent += workDone;
-        }
+        // Summed as the history is logged, so this works in every history mode
+        totalEnergySpent += tmpStrings[i]->getHistory().energySpent;
     }
     
     scores.push_back(totalEnergySpent);
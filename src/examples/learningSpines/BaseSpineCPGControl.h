@@ -125,6 +125,14 @@ struct Config
     virtual void onSetup(BaseSpineModelLearning& subject);
     
     virtual void onTeardown(BaseSpineModelLearning& subject);
+    
+    /**
+     * Save the time since the last CPG update and the CPGs' state.
+     * The muscles' controllers save their own.
+     */
+    virtual void onSaveState(BaseSpineModelLearning& subject, tgSimulationState& state);
+    
+    virtual void onRestoreState(BaseSpineModelLearning& subject, tgSimulationState& state);
 
 	const double getCPGValue(std::size_t i) const;
 	
@@ -78,6 +78,20 @@ void BaseSpineModelLearning::step(double dt)
     tgModel::step(dt);  // Step any children
 }
 
+void BaseSpineModelLearning::saveState(tgSimulationState& state)
+{
+    notifySaveState(state);
+    
+    tgModel::saveState(state);
+}
+
+void BaseSpineModelLearning::restoreState(tgSimulationState& state)
+{
+    notifyRestoreState(state);
+    
+    tgModel::restoreState(state);
+}
+
 const std::vector<tgSpringCableActuator*>&
 BaseSpineModelLearning::getMuscles (const std::string& key) const
 {
@@ -147,8 +161,9 @@ btVector3 BaseSpineModelLearning::getSegmentCOMVector(const int n) const
         throw std::range_error(tgString("Segment number > ", m_segments));
     }
     
-    std::vector<tgRod*> p_rods =
-        tgCast::filter<tgModel, tgRod> (m_allSegments[n]->getDescendants());
+    // Called every control step, so use the segment's cached index
+    const std::vector<tgRod*>& p_rods =
+        m_allSegments[n]->findCached<tgRod>();
     
     // Ensure our segments are being populated correctly
     assert(!p_rods.empty());
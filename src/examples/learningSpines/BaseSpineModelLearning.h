@@ -35,6 +35,7 @@
 #include <string>
 #include <vector>
 
+class tgSimulationState;
 class tgWorld;
 class tgStructureInfo;
 class tgSpringCableActuator;
@@ -60,6 +61,13 @@ public:
         
     virtual void step(double dt);
     
+    /**
+     * Notify the controllers, then save the children
+     */
+    virtual void saveState(tgSimulationState& state);
+    
+    virtual void restoreState(tgSimulationState& state);
+    
     virtual std::vector<double> getSegmentCOM(const int n) const;
     
     virtual btVector3 getSegmentCOMVector(const int n) const;
@@ -44,7 +44,6 @@
 #include "learning/Configuration/configuration.h"
 
 #include "util/CPGEquations.h"
-#include "util/CPGNode.h"
 
 //#define LOGGING
 #define USE_KINEMATIC
@@ -44,7 +44,6 @@
 #include "learning/Configuration/configuration.h"
 
 #include "util/CPGEquationsFB.h"
-#include "util/CPGNodeFB.h"
 
 //#define LOGGING
 #define USE_KINEMATIC
@@ -231,20 +230,8 @@ void SpineFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
     
     for(int i=0; i<tmpStrings.size(); i++)
     {
-        tgSpringCableActuator::SpringCableActuatorHistory stringHist = tmpStrings[i]->getHistory();
-        
-        for(int j=1; j<stringHist.tensionHistory.size(); j++)
-        {
-            const double previousTension = stringHist.tensionHistory[j-1];
-            const double previousLength = stringHist.restLengths[j-1];
-            const double currentLength = stringHist.restLengths[j];
-            //TODO: examine this assumption - free spinning motor may require more power
-            double motorSpeed = (currentLength-previousLength);
-            if(motorSpeed > 0) // Vestigial code
-                motorSpeed = 0;
-            const double workDone = previousTension * motorSpeed;
-            totalEnergySpent += workDone;
-        }
+        // Summed as the history is logged, so this works in every history mode
+        totalEnergySpent += tmpStrings[i]->getHistory().energySpent;
     }
     
     scores.push_back(totalEnergySpent);
@@ -34,6 +34,7 @@
 #include "controllers/tgImpedanceController.h"
 #include "util/CPGEquations.h"
 #include "core/tgCast.h"
+#include "core/tgSimulationState.h"
 
 // The C++ Standard Library
 #include <iostream>
@@ -99,6 +100,22 @@ void tgCPGActuatorControl::onStep(tgSpringCableActuator& subject, double dt)
 	}
 }
 
+void tgCPGActuatorControl::onSaveState(tgSpringCableActuator& subject,
+                                       tgSimulationState& state)
+{
+    state.write(m_controlTime);
+    state.write(m_totalTime);
+    state.write(m_commandedTension);
+}
+
+void tgCPGActuatorControl::onRestoreState(tgSpringCableActuator& subject,
+                                          tgSimulationState& state)
+{
+    m_controlTime = state.read();
+    m_totalTime = state.read();
+    m_commandedTension = state.read();
+}
+
 void tgCPGActuatorControl::assignNodeNumber (CPGEquations& CPGSys, array_2D nodeParams)
 {
     // Ensure that this hasn't already been assigned
@@ -40,6 +40,7 @@ class btRigidBody;
 class CPGEquations;
 class CPGEquationsFB;
 class tgImpedanceController;
+class tgSimulationState;
 
 class tgCPGActuatorControl : public tgObserver<tgSpringCableActuator>,
 							public tgBaseCPGNode
@@ -53,6 +54,13 @@ public:
     virtual void onAttach(tgSpringCableActuator& subject);
     
     virtual void onStep(tgSpringCableActuator& subject, double dt);
+    
+    /**
+     * Save the time since the last control step and the commanded tension
+     */
+    virtual void onSaveState(tgSpringCableActuator& subject, tgSimulationState& state);
+    
+    virtual void onRestoreState(tgSpringCableActuator& subject, tgSimulationState& state);
 	
 	/**
      * Can call these any time, but they'll only have the intended effect
@@ -96,6 +96,26 @@ void tgCPGCableControl::onStep(tgSpringCableActuator& subject, double dt)
 	}
 }
 
+void tgCPGCableControl::onSaveState(tgSpringCableActuator& subject,
+                                    tgSimulationState& state)
+{
+    tgCPGActuatorControl::onSaveState(subject, state);
+    if (m_PID != NULL)
+    {
+        m_PID->saveState(state);
+    }
+}
+
+void tgCPGCableControl::onRestoreState(tgSpringCableActuator& subject,
+                                       tgSimulationState& state)
+{
+    tgCPGActuatorControl::onRestoreState(subject, state);
+    if (m_PID != NULL)
+    {
+        m_PID->restoreState(state);
+    }
+}
+
 void tgCPGCableControl::assignNodeNumberFB (CPGEquationsFB& CPGSys, array_2D nodeParams)
 {
     // Ensure that this hasn't already been assigned
@@ -37,6 +37,13 @@ public:
     
     virtual void onStep(tgSpringCableActuator& subject, double dt);
     
+    /**
+     * Save the base class's state, then the PID controller's
+     */
+    virtual void onSaveState(tgSpringCableActuator& subject, tgSimulationState& state);
+    
+    virtual void onRestoreState(tgSpringCableActuator& subject, tgSimulationState& state);
+    
     /**
      * Account for the larger number of parameters the nodes have
      * with a feedback CPGSystem
@@ -19,6 +19,7 @@
 #include "tgSCASineControl.h"
 
 #include "controllers/tgImpedanceController.h"
+#include "core/tgSimulationState.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -93,6 +94,34 @@ void tgSCASineControl::onStep(tgSpringCableActuator& subject, double dt)
 
 }
 
+void tgSCASineControl::onSaveState(tgSpringCableActuator& subject,
+                                   tgSimulationState& state)
+{
+    state.write(m_controlTime);
+    state.write(m_totalTime);
+    state.write(m_commandedTension);
+    state.write(cycle);
+    state.write(target);
+    if (m_PIDController != NULL)
+    {
+        m_PIDController->saveState(state);
+    }
+}
+
+void tgSCASineControl::onRestoreState(tgSpringCableActuator& subject,
+                                      tgSimulationState& state)
+{
+    m_controlTime = state.read();
+    m_totalTime = state.read();
+    m_commandedTension = state.read();
+    cycle = state.read();
+    target = state.read();
+    if (m_PIDController != NULL)
+    {
+        m_PIDController->restoreState(state);
+    }
+}
+
 void tgSCASineControl::updateTensionSetpoint(double newTension)
 {
     if (newTension >= 0.0)
@@ -44,6 +44,14 @@ public:
     virtual void onAttach(tgSpringCableActuator& subject);
     
     virtual void onStep(tgSpringCableActuator& subject, double dt);
+    
+    /**
+     * Save the timers, the sine wave's last target and the PID
+     * controller's state
+     */
+    virtual void onSaveState(tgSpringCableActuator& subject, tgSimulationState& state);
+    
+    virtual void onRestoreState(tgSpringCableActuator& subject, tgSimulationState& state);
 	
     void updateTensionSetpoint(double newTension);
     
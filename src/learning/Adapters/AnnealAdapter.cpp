@@ -36,6 +36,7 @@
 using namespace std;
 
 AnnealAdapter::AnnealAdapter() :
+annealEvo(NULL),
 totalTime(0.0)
 {
 }
@@ -68,6 +69,18 @@ void AnnealAdapter::initialize(AnnealEvolution *evo,bool isLearning,configuratio
     errorOfFirstController=0.0;
 }
 
+void AnnealAdapter::initialize(const vector< AnnealEvoMember *>& controllers,configuration configdata)
+{
+    numberOfActions=configdata.getDoubleValue("numberOfActions");
+    numberOfStates=configdata.getDoubleValue("numberOfStates");
+    numberOfControllers=configdata.getDoubleValue("numberOfControllers");
+    totalTime=0.0;
+
+    this->annealEvo = NULL;
+    currentControllers = controllers;
+    errorOfFirstController=0.0;
+}
+
 vector<vector<double> > AnnealAdapter::step(double deltaTimeSeconds,vector<double> state)
 {
     totalTime+=deltaTimeSeconds;
@@ -89,6 +102,11 @@ vector<vector<double> > AnnealAdapter::step(double deltaTimeSeconds,vector<doubl
 
 void AnnealAdapter::endEpisode(vector<double> scores)
 {
+    if(annealEvo == NULL)
+    {
+        // Running a trial of evaluateGeneration
+        return;
+    }
     if(scores.size()==0)
     {
         vector< double > tmp(1);
@@ -43,6 +43,12 @@ public:
      * AnnealEvolution, we can't create it here
      */
     void initialize(AnnealEvolution *evo,bool isLearning,configuration config);
+    /**
+     * Initialize with controllers already selected, as a trial of
+     * AnnealEvolution::evaluateGeneration does. endEpisode then reports
+     * nothing, since the generation's scores are recorded by the caller.
+     */
+    void initialize(const std::vector< AnnealEvoMember *>& controllers,configuration config);
     std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
     void endEpisode(std::vector<double> state);
 
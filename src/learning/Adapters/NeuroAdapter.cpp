@@ -38,6 +38,7 @@
 using namespace std;
 
 NeuroAdapter::NeuroAdapter() :
+neuroEvo(NULL),
 totalTime(0.0)
 {
 }
@@ -69,6 +70,18 @@ void NeuroAdapter::initialize(NeuroEvolution *evo,bool isLearning,configuration
 	errorOfFirstController=0.0;
 }
 
+void NeuroAdapter::initialize(const vector< NeuroEvoMember *>& controllers,configuration configdata)
+{
+	numberOfActions=configdata.getDoubleValue("numberOfActions");
+	numberOfStates=configdata.getDoubleValue("numberOfStates");
+	numberOfControllers=configdata.getDoubleValue("numberOfControllers");
+	totalTime=0.0;
+
+	this->neuroEvo = NULL;
+	currentControllers = controllers;
+	errorOfFirstController=0.0;
+}
+
 vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double> state)
 {
 	totalTime+=deltaTimeSeconds;
@@ -116,6 +129,11 @@ vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double
 
 void NeuroAdapter::endEpisode(vector<double> scores)
 {
+	if(neuroEvo == NULL)
+	{
+		// Running a trial of evaluateGeneration
+		return;
+	}
 	if(scores.size()==0)
 	{
 		vector< double > tmp(1);
@@ -42,6 +42,12 @@ public:
 	 * NeuroEvolution, we can't create it here
 	 */
 	void initialize(NeuroEvolution *evo,bool isLearning,configuration config);
+	/**
+	 * Initialize with controllers already selected, as a trial of
+	 * NeuroEvolution::evaluateGeneration does. endEpisode then reports
+	 * nothing, since the generation's scores are recorded by the caller.
+	 */
+	void initialize(const std::vector< NeuroEvoMember *>& controllers,configuration config);
 	std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
 	void endEpisode(std::vector<double> state);
 
@@ -30,12 +30,36 @@
 
 #include "AnnealEvoPopulation.h"
 #include "AnnealEvoMember.h"
+#include "core/tgRandomStream.h"
 #include <fstream>
 #include <boost/iterator/iterator_concepts.hpp>
 
+// Forward declarations
+class EvaluationPool;
+
 class AnnealEvolution
 {
 public:
+    /**
+     * Runs the controllers of one trial, for evaluateGeneration
+     */
+    class Trial
+    {
+    public:
+        virtual ~Trial() { }
+        /**
+         * Run one episode with these controllers. Called in a worker
+         * process of the EvaluationPool, after srand has been seeded
+         * from the episode's stream.
+         * @param[in] episode the stream for terrain and controller noise,
+         * from episodeStream
+         * @return the scores, distance followed by energy, or empty if
+         * the episode failed
+         */
+        virtual std::vector<double> evaluate(const std::vector< AnnealEvoMember *>& controllers,
+                                             tgRandomStream episode) = 0;
+    };
+
     AnnealEvolution(std::string suffix, std::string config = "config.ini", std::string path = "");
     ~AnnealEvolution();
     void mutateEveryController();
@@ -43,14 +67,48 @@ public:
     void evaluatePopulation();
     std::vector< AnnealEvoMember *> nextSetOfControllers();
     void updateScores(std::vector<double> scores);
+    /**
+     * Select every trial up to the end of the current generation,
+     * ordering and mutating the populations first if the previous
+     * generation is complete. Equivalent to calling nextSetOfControllers
+     * that many times.
+     */
+    std::vector< std::vector< AnnealEvoMember *> > nextGeneration();
+    /**
+     * Record the scores of a trial selected by nextGeneration
+     */
+    void updateScores(const std::vector< AnnealEvoMember *>& controllers, std::vector<double> scores);
+    /**
+     * Run a whole generation at once on the workers of pool, then
+     * record the scores in trial order, so the populations and logs
+     * advance as if the trials had run one after another.
+     */
+    void evaluateGeneration(EvaluationPool& pool, Trial& trial);
+    /**
+     * The random numbers for a trial of the current generation,
+     * derived from the run's seed, the generation and the trial.
+     * With commonRandomNumbers set in the config file, the stream
+     * depends on the subtest instead of the trial, so the candidates are
+     * compared on the same terrain and noise while the numberOfSubtests
+     * runs of one candidate still differ.
+     * @param[in] trial the index of the trial in nextGeneration
+     */
+    tgRandomStream episodeStream(std::size_t trial) const;
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
     
 private:
+    /** The number of tests after which the populations are ordered */
+    int testsPerGeneration() const;
     int populationSize;
     int numberOfControllers;
     std::tr1::ranlux64_base_01 eng;
+    /** From the seed in the config file, or the clock if there is none */
+    tgRandomStream runStream;
+    /** Selection and mutation, restarted every generation */
+    tgRandomStream generationStream;
+    bool commonRandomNumbers;
     std::vector< AnnealEvoPopulation *> populations;
     std::vector <AnnealEvoMember *>  selectedControllers;
     std::vector< std::vector< double > > scoresOfTheGeneration;
@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file BatchRunner.cpp
+ * @brief Contains the implementation of class BatchRunner
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "BatchRunner.h"
+#include "BatchTrial.h"
+// This library
+#include "core/tgSimulation.h"
+// The C++ Standard Library
+#include <sstream>
+#include <stdexcept>
+
+BatchRunner::Trial::Trial() :
+steps(0)
+{
+}
+
+BatchRunner::BatchRunner(std::istream& trials, std::ostream& scores, int defaultSteps) :
+m_trials(trials),
+m_scores(scores),
+m_defaultSteps(defaultSteps),
+m_hasFirst(false)
+{
+    if (defaultSteps <= 0)
+    {
+        throw std::invalid_argument("Default number of steps is not positive");
+    }
+    
+    m_hasFirst = readTrial(m_first);
+}
+
+const std::string& BatchRunner::firstTrialFile() const
+{
+    if (!m_hasFirst)
+    {
+        throw std::runtime_error("Batch contains no trials");
+    }
+    return m_first.filename;
+}
+
+std::size_t BatchRunner::run(tgSimulation& simulation, BatchTrial& controller)
+{
+    if (!m_hasFirst)
+    {
+        return 0;
+    }
+    
+    // The application already set up the simulation with this file
+    Trial current = m_first;
+    runEpisode(simulation, current);
+    std::size_t nTrials = 1;
+    
+    Trial next;
+    while (readTrial(next))
+    {
+        // Takes effect at the next setup, after the current episode
+        // has been torn down and scored
+        controller.setTrialFile(next.filename);
+        simulation.reset();
+        reportScores(current, controller.getTrialScores());
+        
+        current = next;
+        runEpisode(simulation, current);
+        nTrials++;
+    }
+    
+    // Only teardown scores the final episode. This builds one more
+    // model than is needed, once per batch.
+    simulation.reset();
+    reportScores(current, controller.getTrialScores());
+    
+    m_hasFirst = false;
+    
+    return nTrials;
+}
+
+bool BatchRunner::readTrial(Trial& trial)
+{
+    std::string line;
+    while (std::getline(m_trials, line))
+    {
+        std::istringstream iss(line);
+        std::string filename;
+        if (!(iss >> filename) || filename[0] == '#')
+        {
+            continue;
+        }
+        
+        int steps = 0;
+        if ((iss >> steps) && steps < 0)
+        {
+            throw std::invalid_argument("Trial length is negative for " + filename);
+        }
+        
+        trial.filename = filename;
+        trial.steps = steps;
+        return true;
+    }
+    return false;
+}
+
+void BatchRunner::runEpisode(tgSimulation& simulation, const Trial& trial) const
+{
+    const int steps = trial.steps > 0 ? trial.steps : m_defaultSteps;
+    try
+    {
+        simulation.run(steps);
+    }
+    catch (std::runtime_error& e)
+    {
+        // Nothing to do here, the controller scores the trial as bogus
+    }
+}
+
+void BatchRunner::reportScores(const Trial& trial, const std::vector<double>& scores)
+{
+    m_scores << trial.filename;
+    for (std::size_t i = 0; i < scores.size(); i++)
+    {
+        m_scores << "," << scores[i];
+    }
+    m_scores << std::endl;
+}
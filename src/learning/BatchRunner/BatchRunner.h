@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+/**
+ * @file BatchRunner.h
+ * @brief Contains the definition of class BatchRunner
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+class BatchTrial;
+
+/**
+ * Runs a stream of learning trials back to back inside one process,
+ * using tgSimulation::reset() between episodes rather than starting
+ * a new application (and a new world) for every parameter set.
+ *
+ * The input has one trial per line: a parameter file name, relative
+ * to the controller's resource path, optionally followed by the number
+ * of steps for that trial. Blank lines and lines starting with '#'
+ * are ignored. For every trial one line of the form
+ * "filename,score0,score1,..." is written to the output stream.
+ */
+class BatchRunner
+{
+public:
+    
+    /**
+     * One line of the trial stream
+     */
+    struct Trial
+    {
+        Trial();
+        
+        /** The parameter file for the episode */
+        std::string filename;
+        
+        /** Steps to run, 0 to use the runner's default */
+        int steps;
+    };
+    
+    /**
+     * The only constructor. Reads the first trial, so the application
+     * can set up its controller with firstTrialFile().
+     * @param[in,out] trials the stream of trials, such as std::cin or
+     * an std::ifstream
+     * @param[in,out] scores the stream that receives one line per trial.
+     * Should not be std::cout, since controllers and banners print there.
+     * @param[in] defaultSteps the number of steps to run a trial that
+     * does not specify its own length. Must be positive.
+     * @throw std::invalid_argument if defaultSteps is not positive
+     */
+    BatchRunner(std::istream& trials, std::ostream& scores, int defaultSteps);
+    
+    /**
+     * Whether the trial stream held no trials at all.
+     */
+    bool empty() const { return !m_hasFirst; }
+    
+    /**
+     * The parameter file of the first trial. The simulation passed to
+     * run() must already be set up with this file, so the first trial
+     * does not pay for an extra reset.
+     * @throw std::runtime_error if the trial stream is empty
+     */
+    const std::string& firstTrialFile() const;
+    
+    /**
+     * Run every trial in the stream. Between trials the controller is
+     * given the next file and the simulation is reset, which tears down
+     * (and scores) the previous episode. The scores of a trial are
+     * therefore written once the next trial has been read, or when the
+     * stream ends.
+     * @param[in,out] simulation a simulation set up with firstTrialFile()
+     * @param[in,out] controller the controller that reads the trial
+     * files and computes their scores
+     * @return the number of trials that were run
+     */
+    std::size_t run(tgSimulation& simulation, BatchTrial& controller);
+    
+private:
+    
+    /**
+     * Read the next non-empty, non-comment line of the trial stream.
+     * @return false at the end of the stream
+     * @throw std::invalid_argument if a trial has a negative length
+     */
+    bool readTrial(Trial& trial);
+    
+    /** Run one episode, treating a runtime error as a failed trial. */
+    void runEpisode(tgSimulation& simulation, const Trial& trial) const;
+    
+    /** Write and flush one line of scores */
+    void reportScores(const Trial& trial, const std::vector<double>& scores);
+    
+    std::istream& m_trials;
+    
+    std::ostream& m_scores;
+    
+    const int m_defaultSteps;
+    
+    /** The first trial, read at construction */
+    Trial m_first;
+    
+    bool m_hasFirst;
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef BATCH_TRIAL_H
+#define BATCH_TRIAL_H
+
+/**
+ * @file BatchTrial.h
+ * @brief Contains the definition of interface class BatchTrial
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <string>
+#include <vector>
+
+/**
+ * Interface for controllers that can be handed a new parameter file
+ * between episodes by BatchRunner, instead of being constructed anew
+ * in a separate process for every trial.
+ */
+class BatchTrial
+{
+public:
+    
+    virtual ~BatchTrial() { }
+    
+    /**
+     * Select the parameter file for the next episode. This must not
+     * affect the episode that is currently running (its scores are
+     * still written to the old file during teardown), so implementations
+     * should only switch files in their next onSetup.
+     * @param[in] filename the file name, relative to the controller's
+     * resource path
+     */
+    virtual void setTrialFile(const std::string& filename) = 0;
+    
+    /**
+     * Return the scores of the most recently torn down episode.
+     * @return the scores, typically distance followed by energy. Empty
+     * if no episode has been completed.
+     */
+    virtual std::vector<double> getTrialScores() const = 0;
+};
+
+#endif // BATCH_TRIAL_H
@@ -0,0 +1,330 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file EvaluationPool.cpp
+ * @brief Contains the implementation of class EvaluationPool
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// This module
+#include "EvaluationPool.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+// POSIX
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    /** Sent instead of a trial index to tell a worker to exit */
+    const std::size_t stopIndex = static_cast<std::size_t>(-1);
+    
+    /** @return false if the pipe was closed */
+    bool writeAll(int fd, const void* data, std::size_t size)
+    {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            const ssize_t n = ::write(fd, p, size);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+    
+    /** @return false if the pipe was closed */
+    bool readAll(int fd, void* data, std::size_t size)
+    {
+        char* p = static_cast<char*>(data);
+        while (size > 0)
+        {
+            const ssize_t n = ::read(fd, p, size);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+    
+    /** The parent's view of one worker process */
+    struct Worker
+    {
+        pid_t pid;
+        
+        /** The parent writes trial indices here */
+        int taskFd;
+        
+        /** and reads scores from here */
+        int resultFd;
+        
+        /** The trial being run, or stopIndex if idle */
+        std::size_t trial;
+    };
+    
+    /** Ask a worker to run a trial, or to stop if none are left */
+    bool assign(Worker& worker, std::size_t& next, std::size_t numTrials)
+    {
+        worker.trial = next < numTrials ? next++ : stopIndex;
+        return writeAll(worker.taskFd, &worker.trial, sizeof(worker.trial));
+    }
+    
+    /** Close the pipes, which stops idle workers, and reap every worker */
+    void stopWorkers(std::vector<Worker>& workers, bool kill)
+    {
+        for (std::size_t i = 0; i < workers.size(); i++)
+        {
+            ::close(workers[i].taskFd);
+            ::close(workers[i].resultFd);
+            if (kill)
+            {
+                ::kill(workers[i].pid, SIGKILL);
+            }
+        }
+        for (std::size_t i = 0; i < workers.size(); i++)
+        {
+            int status;
+            while (::waitpid(workers[i].pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+        }
+        workers.clear();
+    }
+}
+
+EvaluationPool::EvaluationPool(std::size_t numWorkers) :
+m_numWorkers(numWorkers > 0 ? numWorkers :
+             std::max(1L, ::sysconf(_SC_NPROCESSORS_ONLN)))
+{
+}
+
+std::vector<double> EvaluationPool::evaluateTrial(Task& task, std::size_t index)
+{
+    try
+    {
+        return task.evaluate(index);
+    }
+    catch (std::exception& e)
+    {
+        // As in BatchRunner, a trial that throws simply failed
+        return std::vector<double>();
+    }
+}
+
+void EvaluationPool::workerLoop(Task& task, int taskFd, int resultFd)
+{
+    std::size_t index;
+    while (readAll(taskFd, &index, sizeof(index)) && index != stopIndex)
+    {
+        const std::vector<double> scores = evaluateTrial(task, index);
+        const std::size_t n = scores.size();
+        // Output of the trial must not be lost by _exit
+        std::cout.flush();
+        if (!writeAll(resultFd, &n, sizeof(n)) ||
+            (n > 0 && !writeAll(resultFd, &scores[0], n * sizeof(double))))
+        {
+            return;
+        }
+    }
+}
+
+std::vector< std::vector<double> > EvaluationPool::evaluate(Task& task, std::size_t numTrials)
+{
+    std::vector< std::vector<double> > results(numTrials);
+    
+    if (m_numWorkers == 1)
+    {
+        for (std::size_t i = 0; i < numTrials; i++)
+        {
+            results[i] = evaluateTrial(task, i);
+        }
+        return results;
+    }
+    
+    const std::size_t numWorkers = std::min(m_numWorkers, numTrials);
+    if (numWorkers == 0)
+    {
+        return results;
+    }
+    
+    // Otherwise every worker would write out the same buffered output
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(NULL);
+    
+    // A worker that dies would otherwise kill us when we next write to it
+    void (*const oldSigPipe)(int) = ::signal(SIGPIPE, SIG_IGN);
+    
+    std::vector<Worker> workers;
+    for (std::size_t w = 0; w < numWorkers; w++)
+    {
+        int taskPipe[2];
+        int resultPipe[2];
+        if (::pipe(taskPipe) != 0)
+        {
+            stopWorkers(workers, true);
+            ::signal(SIGPIPE, oldSigPipe);
+            throw std::runtime_error("EvaluationPool could not create a pipe");
+        }
+        if (::pipe(resultPipe) != 0)
+        {
+            ::close(taskPipe[0]);
+            ::close(taskPipe[1]);
+            stopWorkers(workers, true);
+            ::signal(SIGPIPE, oldSigPipe);
+            throw std::runtime_error("EvaluationPool could not create a pipe");
+        }
+        
+        const pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            // The worker keeps only its own ends of its own pipes, so
+            // the others see end of file when the parent closes theirs
+            for (std::size_t i = 0; i < workers.size(); i++)
+            {
+                ::close(workers[i].taskFd);
+                ::close(workers[i].resultFd);
+            }
+            ::close(taskPipe[1]);
+            ::close(resultPipe[0]);
+            int status = 0;
+            try
+            {
+                workerLoop(task, taskPipe[0], resultPipe[1]);
+            }
+            catch (...)
+            {
+                status = 1;
+            }
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(NULL);
+            // Skip destructors and atexit handlers, which belong to the parent
+            ::_exit(status);
+        }
+        
+        ::close(taskPipe[0]);
+        ::close(resultPipe[1]);
+        if (pid < 0)
+        {
+            ::close(taskPipe[1]);
+            ::close(resultPipe[0]);
+            stopWorkers(workers, true);
+            ::signal(SIGPIPE, oldSigPipe);
+            throw std::runtime_error("EvaluationPool could not fork a worker");
+        }
+        
+        Worker worker;
+        worker.pid = pid;
+        worker.taskFd = taskPipe[1];
+        worker.resultFd = resultPipe[0];
+        worker.trial = stopIndex;
+        workers.push_back(worker);
+    }
+    
+    std::size_t next = 0;
+    std::size_t busy = 0;
+    bool failed = false;
+    for (std::size_t w = 0; w < workers.size() && !failed; w++)
+    {
+        failed = !assign(workers[w], next, numTrials);
+        busy++;
+    }
+    
+    std::vector<pollfd> fds(workers.size());
+    while (busy > 0 && !failed)
+    {
+        for (std::size_t w = 0; w < workers.size(); w++)
+        {
+            fds[w].fd = workers[w].trial != stopIndex ? workers[w].resultFd : -1;
+            fds[w].events = POLLIN;
+            fds[w].revents = 0;
+        }
+        if (::poll(&fds[0], fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        
+        for (std::size_t w = 0; w < workers.size() && !failed; w++)
+        {
+            if (fds[w].revents == 0)
+            {
+                continue;
+            }
+            
+            Worker& worker = workers[w];
+            std::size_t n;
+            if (!readAll(worker.resultFd, &n, sizeof(n)))
+            {
+                failed = true;
+                break;
+            }
+            std::vector<double>& scores = results[worker.trial];
+            scores.resize(n);
+            if (n > 0 && !readAll(worker.resultFd, &scores[0], n * sizeof(double)))
+            {
+                failed = true;
+                break;
+            }
+            
+            failed = !assign(worker, next, numTrials);
+            if (worker.trial == stopIndex)
+            {
+                busy--;
+            }
+        }
+    }
+    
+    stopWorkers(workers, failed);
+    ::signal(SIGPIPE, oldSigPipe);
+    
+    if (failed)
+    {
+        throw std::runtime_error("EvaluationPool worker died before reporting its trial");
+    }
+    return results;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef EVALUATION_POOL_H
+#define EVALUATION_POOL_H
+
+/**
+ * @file EvaluationPool.h
+ * @brief Contains the definition of class EvaluationPool
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * Evaluates many learning trials at once, each in its own forked worker
+ * process, so a whole generation takes about as long as its slowest
+ * trials instead of the sum of all of them.
+ *
+ * Workers are forked by each call to evaluate, so they see the
+ * parameters as they are at that moment, and anything a trial changes
+ * (simulations, files opened, the random number generator) stays in
+ * the worker. Each worker builds its own tgSimulation, so Bullet and
+ * its profiler are never shared between threads. Trials are handed
+ * out one at a time, so a worker whose trials end early takes more.
+ *
+ * Since only the calling thread is copied by fork, evaluate should be
+ * called while no other threads are running.
+ */
+class EvaluationPool
+{
+public:
+    
+    /**
+     * Runs one trial inside a worker.
+     */
+    class Task
+    {
+    public:
+        
+        virtual ~Task() { }
+        
+        /**
+         * Run trial index and return its scores. Called in a worker
+         * process, so changes made here are not seen by the caller.
+         * @param[in] index the trial, from 0 to the number of trials
+         * @return the scores, typically distance followed by energy.
+         * Empty if the trial failed; a std::exception thrown here is
+         * also reported as a failed trial.
+         */
+        virtual std::vector<double> evaluate(std::size_t index) = 0;
+    };
+    
+    /**
+     * @param[in] numWorkers the number of worker processes, 0 for one
+     * per core. With 1, trials run one after another in the calling
+     * process, which is easier to debug.
+     */
+    explicit EvaluationPool(std::size_t numWorkers = 0);
+    
+    std::size_t getNumWorkers() const
+    {
+        return m_numWorkers;
+    }
+    
+    /**
+     * Run trials 0 to numTrials - 1 and gather their scores.
+     * @param[in] task the trials, copied into each worker by fork
+     * @param[in] numTrials the number of trials
+     * @return the scores of each trial, in trial order
+     * @throw std::runtime_error if a worker cannot be started or dies
+     * without reporting its trial
+     */
+    std::vector< std::vector<double> > evaluate(Task& task, std::size_t numTrials);
+    
+private:
+    
+    /** Run a trial, reporting an exception as an empty score list */
+    static std::vector<double> evaluateTrial(Task& task, std::size_t index);
+    
+    /** Evaluate the trials the parent sends until told to stop */
+    static void workerLoop(Task& task, int taskFd, int resultFd);
+    
+    const std::size_t m_numWorkers;
+};
+
+#endif // EVALUATION_POOL_H
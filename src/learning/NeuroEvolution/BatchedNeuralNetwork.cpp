@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file BatchedNeuralNetwork.cpp
+ * @brief A neuralNetwork that can feed many patterns forward at once
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+#include "BatchedNeuralNetwork.h"
+
+#include <cmath>
+
+namespace
+{
+	/** The same sigmoid as neuralNetwork::activationFunction */
+	inline double sigmoid(double x)
+	{
+		return 1.0 / (1.0 + std::exp(-x));
+	}
+
+	/**
+	 * Compute one layer for every pattern: out = f(in * w), where w has
+	 * one row per input plus a last row for the bias neuron, whose value
+	 * is -1. Sums are taken in the same order as neuralNetwork::feedForward.
+	 */
+	void feedLayer(const double* in, std::size_t numIn, double** w,
+				   double* out, std::size_t numOut, std::size_t numPatterns)
+	{
+		for (std::size_t k = 0; k < numPatterns * numOut; k++)
+		{
+			out[k] = 0.0;
+		}
+
+		// One row of weights at a time, for every pattern
+		for (std::size_t i = 0; i <= numIn; i++)
+		{
+			const double* const row = w[i];
+			for (std::size_t p = 0; p < numPatterns; p++)
+			{
+				const double x = (i < numIn) ? in[p * numIn + i] : -1.0;
+				double* const o = out + p * numOut;
+				for (std::size_t j = 0; j < numOut; j++)
+				{
+					o[j] += x * row[j];
+				}
+			}
+		}
+
+		for (std::size_t k = 0; k < numPatterns * numOut; k++)
+		{
+			out[k] = sigmoid(out[k]);
+		}
+	}
+}
+
+BatchedNeuralNetwork::BatchedNeuralNetwork(int nI, int nH, int nO) :
+	neuralNetwork(nI, nH, nO)
+{
+}
+
+const double* BatchedNeuralNetwork::feedForwardBatch(const double* patterns,
+													  std::size_t numPatterns)
+{
+	if (numPatterns == 0)
+	{
+		return NULL;
+	}
+
+	// Only ever grows, so a steady batch size never allocates
+	if (m_hidden.size() < numPatterns * nHidden)
+	{
+		m_hidden.resize(numPatterns * nHidden);
+	}
+	if (m_outputs.size() < numPatterns * nOutput)
+	{
+		m_outputs.resize(numPatterns * nOutput);
+	}
+
+	feedLayer(patterns, nInput, wInputHidden, &m_hidden[0], nHidden, numPatterns);
+	feedLayer(&m_hidden[0], nHidden, wHiddenOutput, &m_outputs[0], nOutput, numPatterns);
+
+	return &m_outputs[0];
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef BATCHED_NEURAL_NETWORK_H_
+#define BATCHED_NEURAL_NETWORK_H_
+
+/**
+ * @file BatchedNeuralNetwork.h
+ * @brief A neuralNetwork that can feed many patterns forward at once
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+#include "neuralNet/Neural Network v2/neuralNetwork.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A neuralNetwork that also evaluates a whole batch of patterns in one
+ * pass, for controllers that run the same network on every cable.
+ * Weights are loaded, mutated and copied exactly as for a neuralNetwork.
+ * Each layer is computed for all patterns at once, reading each row of
+ * weights once per batch, into buffers that are reused between calls.
+ * The outputs are the same as calling feedForwardPattern on each pattern.
+ */
+class BatchedNeuralNetwork : public neuralNetwork
+{
+public:
+	BatchedNeuralNetwork(int nI, int nH, int nO);
+
+	/**
+	 * Feed every pattern through the network.
+	 * @param[in] patterns numPatterns rows of getNumInputs() values,
+	 * one row after another
+	 * @param[in] numPatterns the number of rows
+	 * @return numPatterns rows of getNumOutputs() values, valid until
+	 * the next call
+	 */
+	const double* feedForwardBatch(const double* patterns, std::size_t numPatterns);
+
+	int getNumInputs() const
+	{
+		return nInput;
+	}
+
+	int getNumOutputs() const
+	{
+		return nOutput;
+	}
+
+private:
+	/** numPatterns rows of nHidden values */
+	std::vector<double> m_hidden;
+
+	/** numPatterns rows of nOutput values */
+	std::vector<double> m_outputs;
+};
+
+#endif /* BATCHED_NEURAL_NETWORK_H_ */
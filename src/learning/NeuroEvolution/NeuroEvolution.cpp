@@ -28,7 +28,11 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "learning/BatchRunner/EvaluationPool.h"
 // The C++ Standard Library
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -88,8 +92,30 @@ suffix(suff)
         throw std::invalid_argument("Population will grow with given parameters");
     }
     
-   srand(rdtsc());
-	eng.seed(rdtsc());
+	// An explicit seed makes the run reproducible
+	unsigned long long seed = rdtsc();
+	if (myconfigdataaa.iskey("seed"))
+	{
+		// Seeds are 64 bits, like the clock ones, so an int is too small
+		const std::string seedString = myconfigdataaa.getStringValue("seed");
+		char* end = NULL;
+		errno = 0;
+		seed = strtoull(seedString.c_str(), &end, 10);
+		if (seedString.empty() || !isdigit(seedString[0]) ||
+			*end != '\0' || errno == ERANGE)
+		{
+			throw std::invalid_argument("Seed must be an unsigned integer: " + seedString);
+		}
+	}
+	commonRandomNumbers = myconfigdataaa.iskey("commonRandomNumbers") &&
+		myconfigdataaa.getintvalue("commonRandomNumbers");
+	cout<<"Evolution seed: "<<seed<<endl;
+
+	runStream = tgRandomStream(seed);
+	generationStream = runStream.substream(0);
+	// The initial populations are still drawn with rand
+	srand(generationStream.seed32());
+	eng.seed(generationStream.seed32());
 
 	for(int j=0;j<numberOfControllers;j++)
 	{
@@ -193,15 +219,11 @@ double diffclock(clock_t clock1,clock_t clock2)
 
 vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 {
-	int testsToDo=0;
-	if(coevolution)
-		testsToDo=numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
-	else
-		testsToDo=populationSize; //stop when we test each element once
-
-	if(currentTest == testsToDo)
+	if(currentTest == testsPerGeneration())
 	{
 		orderAllPopulations();
+		generationStream = runStream.substream(generationNumber);
+		eng.seed(generationStream.seed32());
         if (numberOfChildren == 0)
         {
             mutateEveryController();
@@ -224,7 +246,7 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 	{
 		int selectedOne=0;
 		if(coevolution)
-			selectedOne=rand()%populationSize; //select random one from each pool
+			selectedOne=generationStream.index(populationSize); //select random one from each pool
 		else
 			selectedOne=currentTest; //select the same from each pool
 
@@ -244,15 +266,20 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 }
 
 void NeuroEvolution::updateScores(vector <double> multiscore)
+{
+	updateScores(selectedControllers, multiscore);
+}
+
+void NeuroEvolution::updateScores(const vector <NeuroEvoMember *>& controllers, vector <double> multiscore)
 {
 	if(multiscore.size()==2)
 		this->scoresOfTheGeneration.push_back(multiscore);
 	else
 		multiscore.push_back(-1.0);
 	double score=1.0* multiscore[0] - 0.0 * multiscore[1];
-	for(std::size_t oneElem=0;oneElem<selectedControllers.size();oneElem++)
+	for(std::size_t oneElem=0;oneElem<controllers.size();oneElem++)
 	{
-		NeuroEvoMember * controllerPointer=selectedControllers.at(oneElem);
+		NeuroEvoMember * controllerPointer=controllers.at(oneElem);
 
 		controllerPointer->pastScores.push_back(score);
 		double prevScore=controllerPointer->maxScore;
@@ -276,3 +303,93 @@ void NeuroEvolution::updateScores(vector <double> multiscore)
 	payloadLog.close();
 	return;
 }
+
+int NeuroEvolution::testsPerGeneration() const
+{
+	if(coevolution)
+		return numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
+	else
+		return populationSize; //stop when we test each element once
+}
+
+vector< vector <NeuroEvoMember *> > NeuroEvolution::nextGeneration()
+{
+	vector< vector <NeuroEvoMember *> > generation;
+	do
+	{
+		generation.push_back(nextSetOfControllers());
+	}
+	while (currentTest != testsPerGeneration());
+	return generation;
+}
+
+namespace
+{
+	/** Hands the trials of one generation to the workers */
+	class GenerationTask : public EvaluationPool::Task
+	{
+	public:
+		GenerationTask(NeuroEvolution::Trial& trial,
+					   const vector< vector <NeuroEvoMember *> >& generation,
+					   const vector<tgRandomStream>& episodes) :
+		m_trial(trial),
+		m_generation(generation),
+		m_episodes(episodes)
+		{
+		}
+
+		vector<double> evaluate(size_t index)
+		{
+			// So that code still using rand is reproducible too
+			tgRandomStream legacy = m_episodes[index].substream(0);
+			srand(legacy.seed32());
+			return m_trial.evaluate(m_generation[index], m_episodes[index]);
+		}
+
+	private:
+		NeuroEvolution::Trial& m_trial;
+		const vector< vector <NeuroEvoMember *> >& m_generation;
+		const vector<tgRandomStream>& m_episodes;
+	};
+}
+
+void NeuroEvolution::evaluateGeneration(EvaluationPool& pool, Trial& trial)
+{
+	const vector< vector <NeuroEvoMember *> > generation = nextGeneration();
+	vector<tgRandomStream> episodes;
+	for(size_t i=0;i<generation.size();i++)
+	{
+		episodes.push_back(episodeStream(i));
+	}
+	GenerationTask task(trial, generation, episodes);
+	const vector< vector<double> > scores = pool.evaluate(task, generation.size());
+
+	// In trial order, so scores.csv reads as if they ran one at a time
+	for(size_t i=0;i<generation.size();i++)
+	{
+		if(scores[i].empty())
+		{
+			// As the adapters report an episode that exploded
+			updateScores(generation[i], vector<double>(1, -1.0));
+		}
+		else
+		{
+			updateScores(generation[i], scores[i]);
+		}
+	}
+}
+
+tgRandomStream NeuroEvolution::episodeStream(std::size_t trial) const
+{
+	const tgRandomStream generation = runStream.substream(generationNumber);
+	if(commonRandomNumbers)
+	{
+		// The trials of a member are consecutive, one per subtest. Each
+		// subtest gets its own stream, which every member shares.
+		return generation.substream(1 + trial % numberOfSubtests);
+	}
+	else
+	{
+		return generation.substream(trial + 1);
+	}
+}
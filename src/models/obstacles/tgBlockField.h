@@ -59,7 +59,8 @@ public:
                     size_t nBlocks = 500,
                     double blockLength = 5.0,
                     double blockWidth = 5.0,
-                    double blockHeight = 5.0);
+                    double blockHeight = 5.0,
+                    unsigned long long seed = 1);
 
             /** Origin position of the block field */
             btVector3 m_origin;
@@ -87,6 +88,14 @@ public:
             
             /** Height of the blocks */
             double m_height;
+            
+            /**
+             * Seed of the tgRandomStream that places the blocks.
+             * The blocks used to be placed with rand after seedRandom(1),
+             * so no seed reproduces a layout from before the stream was
+             * introduced; every default field changed once then.
+             */
+            unsigned long long m_seed;
     };
     
    /**
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ConvertDataLog.cpp
+ * @brief Converts a binary log written by tgDataLogger2 to CSV.
+ * @author Drew Sabelhaus
+ * $Id$
+ */
+
+// This application
+#include "tgDataLogReader.h"
+// The C++ Standard Library
+#include <exception>
+#include <iostream>
+#include <string>
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1] is the binary log; argv[2], if supplied, is the
+ * CSV file to write. Otherwise ".txt" replaces the ".bin" extension.
+ * @return 0 on success, 1 on failure
+ */
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <log.bin> [log.txt]" << std::endl;
+    return 1;
+  }
+
+  const std::string binaryFileName = argv[1];
+  std::string csvFileName;
+  if (argc > 2) {
+    csvFileName = argv[2];
+  }
+  else {
+    const std::size_t dot = binaryFileName.rfind(".bin");
+    csvFileName = binaryFileName.substr(0, dot) + ".txt";
+  }
+
+  try {
+    const std::size_t numRows =
+      tgDataLogReader::convertToCSV(binaryFileName, csvFileName);
+    std::cout << "Wrote " << numRows << " rows to " << csvFileName << std::endl;
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
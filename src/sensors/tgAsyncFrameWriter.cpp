@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgAsyncFrameWriter.cpp
+ * @brief Contains the implementation of class tgAsyncFrameWriter.
+ * @author Drew Sabelhaus
+ * $Id$
+ */
+
+// This class
+#include "tgAsyncFrameWriter.h"
+// Includes from Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+// Includes from the C++ standard library
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+tgAsyncFrameWriter::tgAsyncFrameWriter(std::size_t capacity, Policy policy) :
+  m_capacity(capacity),
+  m_policy(policy),
+  m_width(0),
+  m_head(0),
+  m_tail(0),
+  m_stopping(false),
+  m_failed(false),
+  m_dropped(0),
+  m_blocked(0),
+  m_pSink(NULL),
+  m_pThread(NULL)
+{
+  if (capacity == 0)
+  {
+    throw std::invalid_argument("tgAsyncFrameWriter needs room for at least one frame.");
+  }
+}
+
+tgAsyncFrameWriter::~tgAsyncFrameWriter()
+{
+  try
+  {
+    stop();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void tgAsyncFrameWriter::start(Sink& sink, std::size_t width)
+{
+  if (isRunning())
+  {
+    throw std::runtime_error("tgAsyncFrameWriter is already running.");
+  }
+  if (width == 0)
+  {
+    throw std::invalid_argument("tgAsyncFrameWriter frames must have at least one value.");
+  }
+
+  m_width = width;
+  // Allocate once here, so push never has to.
+  m_ring.assign(m_capacity * m_width, 0.0);
+  m_head.store(0);
+  m_tail.store(0);
+  m_stopping.store(false);
+  m_failed.store(false);
+  m_error.clear();
+  m_dropped = 0;
+  m_blocked = 0;
+  m_pSink = &sink;
+
+  m_pThread = new boost::thread(boost::bind(&tgAsyncFrameWriter::writeLoop, this));
+}
+
+bool tgAsyncFrameWriter::push(const double* frame)
+{
+  if (!isRunning())
+  {
+    throw std::runtime_error("tgAsyncFrameWriter::push called before start.");
+  }
+
+  const std::size_t head = m_head.load(boost::memory_order_relaxed);
+  bool waited = false;
+  // Full when the writer is a whole ring behind.
+  while (head - m_tail.load(boost::memory_order_acquire) >= m_capacity)
+  {
+    if (m_failed.load(boost::memory_order_acquire))
+    {
+      // The writer has stopped consuming, so waiting would never end.
+      throw std::runtime_error("tgAsyncFrameWriter sink failed: " + m_error);
+    }
+    if (m_policy == DROP)
+    {
+      ++m_dropped;
+      return false;
+    }
+    if (!waited)
+    {
+      ++m_blocked;
+      waited = true;
+    }
+    boost::this_thread::yield();
+  }
+
+  if (m_failed.load(boost::memory_order_acquire))
+  {
+    throw std::runtime_error("tgAsyncFrameWriter sink failed: " + m_error);
+  }
+
+  const std::size_t slot = head % m_capacity;
+  std::copy(frame, frame + m_width, &m_ring[slot * m_width]);
+  // Publish the frame to the writer.
+  m_head.store(head + 1, boost::memory_order_release);
+  return true;
+}
+
+void tgAsyncFrameWriter::stop()
+{
+  if (!isRunning())
+  {
+    return;
+  }
+  m_stopping.store(true, boost::memory_order_release);
+  m_pThread->join();
+  delete m_pThread;
+  m_pThread = NULL;
+  m_pSink = NULL;
+
+  // The writer has exited, so m_error is safe to read.
+  if (m_failed.load(boost::memory_order_acquire))
+  {
+    throw std::runtime_error("tgAsyncFrameWriter sink failed: " + m_error);
+  }
+}
+
+bool tgAsyncFrameWriter::isRunning() const
+{
+  return m_pThread != NULL;
+}
+
+std::size_t tgAsyncFrameWriter::getFramesWritten() const
+{
+  return m_tail.load();
+}
+
+std::size_t tgAsyncFrameWriter::getFramesDropped() const
+{
+  return m_dropped;
+}
+
+std::size_t tgAsyncFrameWriter::getFramesBlocked() const
+{
+  return m_blocked;
+}
+
+void tgAsyncFrameWriter::writeLoop()
+{
+  assert(m_pSink != NULL);
+  try
+  {
+    while (true)
+    {
+      const std::size_t tail = m_tail.load(boost::memory_order_relaxed);
+      if (tail != m_head.load(boost::memory_order_acquire))
+      {
+        const std::size_t slot = tail % m_capacity;
+        m_pSink->writeFrame(&m_ring[slot * m_width], m_width);
+        // Hand the slot back to the producer.
+        m_tail.store(tail + 1, boost::memory_order_release);
+      }
+      else if (m_stopping.load(boost::memory_order_acquire))
+      {
+        // Every push happened before stop, so one more look at the
+        // head is enough to know the ring is really empty.
+        if (tail == m_head.load(boost::memory_order_acquire))
+        {
+          break;
+        }
+      }
+      else
+      {
+        // Nothing to do: wait for the simulation to produce more.
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    m_error = e.what();
+    m_failed.store(true, boost::memory_order_release);
+  }
+}
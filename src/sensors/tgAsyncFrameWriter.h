@@ -0,0 +1,203 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ASYNC_FRAME_WRITER_H
+#define TG_ASYNC_FRAME_WRITER_H
+
+/**
+ * @file tgAsyncFrameWriter.h
+ * @brief Contains the definition of class tgAsyncFrameWriter.
+ * @author Drew Sabelhaus
+ * $Id$
+ */
+
+// Includes from the C++ standard library
+#include <cstddef>
+#include <string>
+#include <vector>
+// Includes from Boost
+#include <boost/atomic.hpp>
+
+// Forward declarations
+namespace boost
+{
+  class thread;
+}
+
+/**
+ * Hands fixed-width frames of sensor data from the simulation thread to
+ * a background writer thread, so that formatting and disk I/O do not
+ * stall tgSimulation::step.
+ * Frames are copied into a single-producer, single-consumer ring buffer
+ * without locking. The writer thread passes each frame, in order, to a
+ * Sink supplied by the data manager.
+ * push() must only be called from one thread (the simulation thread).
+ */
+class tgAsyncFrameWriter
+{
+ public:
+
+  /**
+   * What push() does when the ring is full.
+   * BLOCK waits for the writer, so no data is lost.
+   * DROP discards the new frame, so the simulation never waits.
+   */
+  enum Policy
+  {
+    BLOCK,
+    DROP
+  };
+
+  /**
+   * Receives frames on the writer thread.
+   */
+  class Sink
+  {
+  public:
+
+    virtual ~Sink() { }
+
+    /**
+     * Format and write one frame. Called only from the writer thread,
+     * which is the only thread using the sink between start and stop.
+     * @param[in] frame width values, in the order they were pushed.
+     * @param[in] width the number of values in the frame.
+     */
+    virtual void writeFrame(const double* frame, std::size_t width) = 0;
+  };
+
+  /**
+   * @param[in] capacity the number of frames the ring can hold.
+   * @param[in] policy what to do when the ring is full.
+   * @throw std::invalid_argument if capacity is zero.
+   */
+  tgAsyncFrameWriter(std::size_t capacity = 1024, Policy policy = BLOCK);
+
+  /**
+   * Stops the writer thread if it is still running, writing out
+   * every frame already in the ring. Reports a sink failure on
+   * std::cerr, since a destructor must not throw.
+   */
+  ~tgAsyncFrameWriter();
+
+  /**
+   * Size the ring for frames of the given width and start the writer
+   * thread. Resets the counters.
+   * @param[in] sink where frames are written, must outlive stop().
+   * @param[in] width the number of values in every frame.
+   * @throw std::runtime_error if the writer is already running.
+   * @throw std::invalid_argument if width is zero.
+   */
+  void start(Sink& sink, std::size_t width);
+
+  /**
+   * Copy one frame into the ring. Does not allocate.
+   * @param[in] frame the width values given to start.
+   * @return false if the frame was dropped because the ring was full.
+   * @throw std::runtime_error if the writer is not running, or if the
+   * sink threw on the writer thread.
+   */
+  bool push(const double* frame);
+
+  /**
+   * Write every frame still in the ring, then join the writer thread.
+   * Does nothing if the writer is not running.
+   * @throw std::runtime_error if the sink threw on the writer thread.
+   * The writer is stopped either way, and the frames from the failed
+   * one on were not written.
+   */
+  void stop();
+
+  /**
+   * @return true between start and stop.
+   */
+  bool isRunning() const;
+
+  /**
+   * @return the number of frames handed to the sink since start.
+   */
+  std::size_t getFramesWritten() const;
+
+  /**
+   * @return the number of frames discarded under the DROP policy.
+   */
+  std::size_t getFramesDropped() const;
+
+  /**
+   * @return the number of pushes that had to wait under the BLOCK policy.
+   */
+  std::size_t getFramesBlocked() const;
+
+ private:
+
+  /**
+   * The body of the writer thread.
+   */
+  void writeLoop();
+
+  // Not copyable: the writer thread holds a pointer to this object.
+  tgAsyncFrameWriter(const tgAsyncFrameWriter&);
+  tgAsyncFrameWriter& operator=(const tgAsyncFrameWriter&);
+
+  const std::size_t m_capacity;
+
+  const Policy m_policy;
+
+  std::size_t m_width;
+
+  /**
+   * m_capacity frames of m_width values each.
+   */
+  std::vector<double> m_ring;
+
+  /**
+   * Count of frames ever pushed. Only the producer writes it.
+   * The slot for a frame is its count modulo m_capacity.
+   */
+  boost::atomic<std::size_t> m_head;
+
+  /**
+   * Count of frames ever written. Only the writer thread writes it.
+   */
+  boost::atomic<std::size_t> m_tail;
+
+  /**
+   * Set by stop; the writer drains the ring and exits.
+   */
+  boost::atomic<bool> m_stopping;
+
+  /**
+   * Set by the writer thread if the sink threw.
+   */
+  boost::atomic<bool> m_failed;
+
+  /**
+   * The message of the exception the sink threw, valid once m_failed is set.
+   */
+  std::string m_error;
+
+  std::size_t m_dropped;
+
+  std::size_t m_blocked;
+
+  Sink* m_pSink;
+
+  boost::thread* m_pThread;
+};
+
+#endif // TG_ASYNC_FRAME_WRITER_H
@@ -35,10 +35,9 @@
 
 // Includes from the c++ standard library:
 //#include <iostream>
-#include <sstream>  
 #include <stdexcept>
 #include <cassert>
-#include <string> // for std::to_string(float)
+#include <string>
 #include <math.h> // for the constant PI (3.14...)
 
 // Includes from Bullet Physics:
@@ -123,15 +122,15 @@ btVector3 tgCompoundRigidSensor::getCenterOfMass()
   // It should be sufficient to just add then divide each component
   // of the 3D vector.
   // The resulting vector:
-  btVector3* pCom = new btVector3(0.0, 0.0, 0.0);
+  btVector3 com(0.0, 0.0, 0.0);
   // Iterate and add all the centers of mass of the components.
   for( size_t i=0; i < m_rigids.size(); i++){
-    *pCom += m_rigids[i]->centerOfMass();
+    com += m_rigids[i]->centerOfMass();
   }
   // Average the components:
-  *pCom /= m_rigids.size();
+  com /= m_rigids.size();
 
-  return *pCom;
+  return com;
 }
 
 btVector3 tgCompoundRigidSensor::getOrientation()
@@ -222,65 +221,35 @@ std::vector<std::string> tgCompoundRigidSensor::getSensorDataHeadings() {
   return headings;
 }
 
+/**
+ * A compound reports position (3), orientation (3) and mass (1).
+ */
+std::size_t tgCompoundRigidSensor::getSensorDataWidth() const {
+  return 7;
+}
+
 /**
  * The method that collects the actual data from this compound rigid body.
  */
-std::vector<std::string> tgCompoundRigidSensor::getSensorData() {
+std::size_t tgCompoundRigidSensor::sampleInto(double* out) {
   // Note that this method uses m_rigids directly, no need to deal
   // with the parent class' pointer to m_pSens.
-  
-  // The floats (btScalars?) need to be converted to strings
-  // via a stringstream.
-  std::stringstream ss;
-
-  // The list of sensor data that will be returned:
-  std::vector<std::string> sensordata;
 
   // Get the position and orientation of this compound body.
   // Call the helper functions
   btVector3 com = getCenterOfMass();
   btVector3 orient = getOrientation();
-  
-  // com[0]
-  ss << com[0];
-  sensordata.push_back( ss.str() );
-  // Reset the stream.
-  ss.str("");
-  
-  // com[1]
-  ss << com[1];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // com[2]
-  ss << com[2];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-
-  // yaw
-  ss << orient[0];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-
-  // pitch
-  ss << orient[1];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-
-  // roll
-  ss << orient[2];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  
-  //sensordata.push_back( "" );
-  //sensordata.push_back( "" );
-  //sensordata.push_back( "" );
 
-  // mass
-  ss << getMass();
-  sensordata.push_back( ss.str() );
-  ss.str("");
+  // Same order as the headings: X, Y, Z, yaw, pitch, roll, mass.
+  out[0] = com[0];
+  out[1] = com[1];
+  out[2] = com[2];
+  out[3] = orient[0];
+  out[4] = orient[1];
+  out[5] = orient[2];
+  out[6] = getMass();
   
-  return sensordata;
+  return 7;
 }
 
 //end.
@@ -82,7 +82,8 @@ public:
    * of the consistutent rigid bodies?
    */
   virtual std::vector<std::string> getSensorDataHeadings();
-  virtual std::vector<std::string> getSensorData();
+  virtual std::size_t getSensorDataWidth() const;
+  virtual std::size_t sampleInto(double* out);
 
  private:
 
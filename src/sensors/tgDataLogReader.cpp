@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgDataLogReader.cpp
+ * @brief Contains the implementation of class tgDataLogReader
+ * @author Drew Sabelhaus
+ * $Id$
+ */
+
+// This module
+#include "tgDataLogReader.h"
+// This application
+#include "tgDataLogger2.h"
+// The C++ Standard Library
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+
+tgDataLogReader::tgDataLogReader(const std::string& fileName) :
+  m_input(fileName.c_str(), std::ios::in | std::ios::binary)
+{
+  if (!m_input.is_open()) {
+    throw std::runtime_error("Could not open binary log file " + fileName);
+  }
+
+  // Check the tag, so we don't interpret some other file as a log.
+  const std::size_t tagLength = std::strlen(tgDataLogger2::binaryFileTag);
+  std::string tag(tagLength, '\0');
+  m_input.read(&tag[0], tagLength);
+  if (!m_input || tag != tgDataLogger2::binaryFileTag) {
+    throw std::runtime_error(fileName + " is not a tgDataLogger2 binary log.");
+  }
+
+  if (readUnsigned() != tgDataLogger2::binaryFormatVersion) {
+    throw std::runtime_error("Unsupported binary log version in " + fileName);
+  }
+
+  const unsigned int numColumns = readUnsigned();
+  for (unsigned int i = 0; i < numColumns; i++) {
+    const unsigned int length = readUnsigned();
+    std::string heading(length, '\0');
+    if (length > 0) {
+      m_input.read(&heading[0], length);
+    }
+    m_headings.push_back(heading);
+  }
+
+  if (!m_input) {
+    throw std::runtime_error("Truncated header in binary log " + fileName);
+  }
+}
+
+tgDataLogReader::~tgDataLogReader()
+{
+}
+
+bool tgDataLogReader::readFrame(std::vector<double>& frame)
+{
+  frame.resize(m_headings.size());
+  if (frame.empty()) {
+    return false;
+  }
+  m_input.read(reinterpret_cast<char*>(&frame[0]),
+	       frame.size() * sizeof(double));
+  // gcount is short if the last row was only partly written.
+  return m_input.gcount() ==
+    static_cast<std::streamsize>(frame.size() * sizeof(double));
+}
+
+std::size_t tgDataLogReader::convertToCSV(const std::string& binaryFileName,
+					  const std::string& csvFileName)
+{
+  tgDataLogReader reader(binaryFileName);
+
+  std::ofstream csv(csvFileName.c_str());
+  if (!csv.is_open()) {
+    throw std::runtime_error("Could not open CSV file " + csvFileName);
+  }
+
+  // Same layout as tgDataLogger2's CSV format, including the trailing commas.
+  csv << "tgDataLogger2 binary log converted from " << binaryFileName
+      << std::endl;
+  const std::vector<std::string>& headings = reader.getHeadings();
+  for (std::size_t i = 0; i < headings.size(); i++) {
+    csv << headings[i] << ",";
+  }
+  csv << "\n";
+
+  std::size_t numRows = 0;
+  std::vector<double> frame;
+  while (reader.readFrame(frame)) {
+    for (std::size_t i = 0; i < frame.size(); i++) {
+      csv << frame[i] << ",";
+    }
+    csv << "\n";
+    numRows++;
+  }
+
+  return numRows;
+}
+
+unsigned int tgDataLogReader::readUnsigned()
+{
+  uint32_t value = 0;
+  m_input.read(reinterpret_cast<char*>(&value), sizeof(value));
+  return value;
+}
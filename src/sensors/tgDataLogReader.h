@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_DATA_LOG_READER_H
+#define TG_DATA_LOG_READER_H
+
+/**
+ * @file tgDataLogReader.h
+ * @brief Contains the definition of class tgDataLogReader.
+ * @author Drew Sabelhaus
+ * $Id$
+ */
+
+// Includes from the C++ standard library
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Reads the binary log files written by tgDataLogger2 in BINARY format,
+ * one row at a time, and converts them to the same CSV layout that
+ * tgDataLogger2 writes in CSV format.
+ */
+class tgDataLogReader
+{
+ public:
+
+  /**
+   * Open a binary log file and read its header.
+   * @param[in] fileName the path of a .bin file written by tgDataLogger2
+   * @throw std::runtime_error if the file cannot be opened, is not a
+   * tgDataLogger2 binary log, or has an unsupported version.
+   */
+  tgDataLogReader(const std::string& fileName);
+
+  ~tgDataLogReader();
+
+  /**
+   * The column headings, "time" first, then one per sensor value
+   * prefixed with the sensor number, as in the CSV format.
+   */
+  const std::vector<std::string>& getHeadings() const { return m_headings; }
+
+  /**
+   * Read the next row of the log.
+   * @param[out] frame resized to the number of columns and filled
+   * with the row, time first
+   * @return false at the end of the file or at an incomplete final row
+   * (for example if the simulation was killed while logging)
+   */
+  bool readFrame(std::vector<double>& frame);
+
+  /**
+   * Convert a whole binary log to a CSV file.
+   * @param[in] binaryFileName the .bin file written by tgDataLogger2
+   * @param[in] csvFileName the file to write
+   * @return the number of rows converted
+   * @throw std::runtime_error if either file cannot be opened
+   */
+  static std::size_t convertToCSV(const std::string& binaryFileName,
+				  const std::string& csvFileName);
+
+ private:
+
+  /** Read a 32 bit unsigned integer from the header */
+  unsigned int readUnsigned();
+
+  std::ifstream m_input;
+
+  std::vector<std::string> m_headings;
+};
+
+#endif // TG_DATA_LOG_READER_H
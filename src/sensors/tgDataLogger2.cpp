@@ -35,6 +35,11 @@
 #include <time.h> // for the file name of the log file
 #include <sstream> // for converting a size_t to a string.
 #include <cstdlib> // for getenv, converting ~ to $HOME.
+#include <cstring> // for strlen
+#include <stdint.h> // for fixed size integers in the binary header
+
+const char* const tgDataLogger2::binaryFileTag = "NTRTLOG2";
+const unsigned int tgDataLogger2::binaryFormatVersion = 1;
 
 /**
  * The constructor for this class only assigns the filename prefix.
@@ -43,10 +48,13 @@
  * appending to the same one.)
  * Call the constructor of the parent class anyway, though it does nothing.
  */
-tgDataLogger2::tgDataLogger2(std::string fileNamePrefix, double timeInterval) :
+tgDataLogger2::tgDataLogger2(std::string fileNamePrefix, double timeInterval,
+			     Format format) :
   tgDataManager(),
   m_fileNamePrefix(fileNamePrefix),
-  m_timeInterval(timeInterval)
+  m_timeInterval(timeInterval),
+  m_format(format),
+  m_pWriter(NULL)
 {
   // A quick check on the passed-in string: it must not be the empty
   // string. Must be a correct linux path.
@@ -84,19 +92,47 @@ tgDataLogger2::tgDataLogger2(std::string fileNamePrefix, double timeInterval) :
  * lets the simulator compile, but then complains when it's called.
  * DO NOT USE THIS ONE: use the one with the string passed in!
  */
-tgDataLogger2::tgDataLogger2()
+tgDataLogger2::tgDataLogger2() :
+  m_pWriter(NULL)
 {
   throw std::invalid_argument("Cannot create a tgDataLogger2 without a path to the log file! Please use the constructor that takes a string.");
 }
 
 /**
- * The destructor should not have to do anything.
  * Closing the log file is handled by teardown(), and the parent class
- * handles deletion of the sensors and sensor infos.
+ * handles deletion of the sensors and sensor infos. The writer thread is
+ * stopped here in case teardown was never called, since it uses tgOutput.
  */
 tgDataLogger2::~tgDataLogger2()
 {
   // TO-DO: should we double-check and close the tgOutput filestream here too?
+  delete m_pWriter;
+}
+
+/**
+ * Replaces any previous writer. Its thread must not be running, since
+ * step would otherwise push to a writer that was never started.
+ */
+void tgDataLogger2::setAsynchronous(std::size_t queueFrames,
+				    tgAsyncFrameWriter::Policy policy)
+{
+  if (m_pWriter != NULL && m_pWriter->isRunning()) {
+    throw std::runtime_error("tgDataLogger2::setAsynchronous must be called before setup or after teardown.");
+  }
+  // Construct first, so a bad queue size leaves the old writer in place.
+  tgAsyncFrameWriter* pWriter = new tgAsyncFrameWriter(queueFrames, policy);
+  delete m_pWriter;
+  m_pWriter = pWriter;
+}
+
+std::size_t tgDataLogger2::getDroppedFrames() const
+{
+  return m_pWriter == NULL ? 0 : m_pWriter->getFramesDropped();
+}
+
+std::size_t tgDataLogger2::getBlockedFrames() const
+{
+  return m_pWriter == NULL ? 0 : m_pWriter->getFramesBlocked();
 }
 
 /**
@@ -104,7 +140,10 @@ tgDataLogger2::~tgDataLogger2()
  * (1) create the full filename, based on the current time from the operating system,
  * (2) create the sensors based on the sensor infos that have been added and 
  *     the senseable objects that have also been added,
- * (3) opens the log file and writes a heading line (then closes the file.)
+ * (3) opens the log file and writes a heading. The file stays open until
+ *     teardown, so step does not have to re-open it for every sample.
+ * If the logger is asynchronous, the writer thread is started last, after
+ * which only that thread uses tgOutput.
  */
 void tgDataLogger2::setup()
 {
@@ -125,50 +164,81 @@ void tgDataLogger2::setup()
   currentTime = localtime(&rawtime);
   strftime(fileTime, fileTimeSize, "%m%d%Y_%H%M%S", currentTime);
   // Result: fileTime is a string with the time information.
-  m_fileName = m_fileNamePrefix + "_" + fileTime + ".txt";
+  if (m_format == BINARY) {
+    m_fileName = m_fileNamePrefix + "_" + fileTime + ".bin";
+  }
+  else {
+    m_fileName = m_fileNamePrefix + "_" + fileTime + ".txt";
+  }
 
   // DEBUGGING output:
   std::cout << "tgDataLogger2 will be saving data to the file: " << std::endl
 	    << m_fileName << std::endl;
 
   // Attempt to open the log file
-  tgOutput.open(m_fileName.c_str());
+  if (m_format == BINARY) {
+    tgOutput.open(m_fileName.c_str(), std::ios::out | std::ios::binary);
+  }
+  else {
+    tgOutput.open(m_fileName.c_str());
+  }
   if (!tgOutput.is_open()) {
     throw std::runtime_error("Log file could not be opened. Usually, this is because the directory you specified does not exist. Check for spelling errors.");
   }
 
-  // Output a first line of the header.
-  tgOutput << "tgDataLogger2 started logging at time " << fileTime << ", with "
-	   << m_sensors.size() << " sensors on " << m_senseables.size()
-	   << " senseable objects." << std::endl;
-
   // The first column of data will be "time", the m_totalTime since beginning
   // of the simulation.
-  tgOutput << "time,";
+  std::vector<std::string> columns;
+  columns.push_back("time");
 
-  // Iterate. For each sensor, output its header.
+  // Iterate. For each sensor, collect its headings.
   // Prepend each label with the sensor number, which we choose to be the index in
   // the vector of sensors. NOTE that this means the sensors vector CANNOT
   // BE CHANGED, otherwise the data will not be aligned properly.
   for (std::size_t i=0; i < m_sensors.size(); i++) {
     // Get the vector of sensor data headings from this sensor
     std::vector<std::string> headings = m_sensors[i]->getSensorDataHeadings();
-    // Iterate and output each heading
+    // The numeric samples are written by position, so each sensor must
+    // produce exactly one value per heading.
+    if (headings.size() != m_sensors[i]->getSensorDataWidth()) {
+      throw std::runtime_error("A sensor's data width does not match its number of headings.");
+    }
+    // Iterate and store each heading
     for (std::size_t j=0; j < headings.size(); j++) {
       // Prepend with the sensor number and an underscore.
-      // Also, end with a comma, since this is a comma-separated-value log file.
-      tgOutput << i << "_" << headings[j] << ",";
+      std::ostringstream heading;
+      heading << i << "_" << headings[j];
+      columns.push_back(heading.str());
     }
   }
-  // End with a new line.
-  tgOutput << std::endl;
 
-  // Done! Close the output for now, will be re-opened during step.
-  tgOutput.close();
+  // One slot per column, reused at every sample.
+  m_frame.assign(columns.size(), 0.0);
+
+  if (m_format == BINARY) {
+    writeBinaryHeader(columns);
+  }
+  else {
+    // Output a first line of the header.
+    tgOutput << "tgDataLogger2 started logging at time " << fileTime << ", with "
+	     << m_sensors.size() << " sensors on " << m_senseables.size()
+	     << " senseable objects." << std::endl;
+    
+    // End each heading with a comma, since this is a comma-separated-value log file.
+    for (std::size_t i=0; i < columns.size(); i++) {
+      tgOutput << columns[i] << ",";
+    }
+    // End with a new line.
+    tgOutput << std::endl;
+  }
 
   // Initialize/reset the values of the time variables.
   m_totalTime = 0.0;
   m_updateTime = 0.0;
+
+  if (m_pWriter != NULL) {
+    m_pWriter->start(*this, m_frame.size());
+  }
   
   // Postcondition
   assert(invariant());
@@ -179,9 +249,27 @@ void tgDataLogger2::setup()
  */
 void tgDataLogger2::teardown()
 {
+  // Write out everything still queued, so the log is complete, and hand
+  // tgOutput back to this thread.
+  if (m_pWriter != NULL && m_pWriter->isRunning()) {
+    // Teardown also runs from tgSimulation's destructor, so report a
+    // failed write here rather than throwing, and finish tearing down.
+    try {
+      m_pWriter->stop();
+    }
+    catch (const std::runtime_error& e) {
+      std::cerr << "tgDataLogger2 could not write all of " << m_fileName
+		<< ": " << e.what() << std::endl;
+    }
+    if (m_pWriter->getFramesDropped() > 0) {
+      std::cout << "tgDataLogger2 dropped " << m_pWriter->getFramesDropped()
+		<< " of " << (m_pWriter->getFramesDropped() + m_pWriter->getFramesWritten())
+		<< " samples because the writer fell behind." << std::endl;
+    }
+  }
   // Call the parent's teardown method! This is important!
   tgDataManager::teardown();
-  // Close the log file.
+  // Close the log file, which flushes anything still buffered.
   tgOutput.close();
   // Postcondition
   assert(invariant());
@@ -191,7 +279,8 @@ void tgDataLogger2::teardown()
  * The step method is where data is actually collected!
  * This data logger will do two things here:
  * (1) iterate through all the sensors, collect their data, 
- * (2) write that line of data to the log file (then close the log again.)
+ * (2) write that line (or binary row) of data to the log file, or queue
+ *     it for the writer thread if this logger is asynchronous.
  */
 void tgDataLogger2::step(double dt) 
 {
@@ -207,23 +296,14 @@ void tgDataLogger2::step(double dt)
     m_updateTime += dt;
     // Then, if enough time has elapsed between the previous sensor reading,
     if (m_updateTime >= m_timeInterval) {
-      // Open the log file for writing, appending and not overwriting.
-      tgOutput.open(m_fileName.c_str(), std::ios::app);
-      // Then output the time.
-      tgOutput << m_totalTime << ",";
-      // Collect the data and output it to the file!
-      for (size_t i=0; i < m_sensors.size(); i++) {
-	// Get the vector of sensor data from this sensor
-	std::vector<std::string> sensordata = m_sensors[i]->getSensorData();
-	// Iterate and output each data sample
-	for (std::size_t j=0; j < sensordata.size(); j++) {
-	  // Include a comma, since this is a comma-separated-value log file.
-	  tgOutput << sensordata[j] << ",";
-	}
+      collectFrame();
+      if (m_pWriter != NULL) {
+	// Only copies the frame; the writer thread formats and writes it.
+	m_pWriter->push(&m_frame[0]);
+      }
+      else {
+	writeFrame(&m_frame[0], m_frame.size());
       }
-      tgOutput << std::endl;
-      // Close the output, to be re-opened next step.
-      tgOutput.close();
       // Now that the sensors have been read, reset the counter.
       m_updateTime = 0.0;
     }
@@ -233,6 +313,47 @@ void tgDataLogger2::step(double dt)
   assert(invariant());
 }
 
+void tgDataLogger2::writeBinaryHeader(const std::vector<std::string>& columns)
+{
+  tgOutput.write(binaryFileTag, std::strlen(binaryFileTag));
+  
+  const uint32_t version = binaryFormatVersion;
+  tgOutput.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  
+  const uint32_t numColumns = columns.size();
+  tgOutput.write(reinterpret_cast<const char*>(&numColumns), sizeof(numColumns));
+
+  for (std::size_t i=0; i < columns.size(); i++) {
+    const uint32_t length = columns[i].size();
+    tgOutput.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    tgOutput.write(columns[i].data(), length);
+  }
+}
+
+void tgDataLogger2::collectFrame()
+{
+  m_frame[0] = m_totalTime;
+  // The widths were checked against the headings in setup, so the sensors
+  // fill the rest of the frame exactly.
+  sampleSensors(&m_frame[0] + 1);
+}
+
+void tgDataLogger2::writeFrame(const double* frame, std::size_t width)
+{
+  if (m_format == BINARY) {
+    tgOutput.write(reinterpret_cast<const char*>(frame), width * sizeof(double));
+  }
+  else {
+    // Output the time and every sensor value, each followed by a comma,
+    // since this is a comma-separated-value log file.
+    for (std::size_t i=0; i < width; i++) {
+      tgOutput << frame[i] << ",";
+    }
+    // A newline without flushing: the stream is flushed when it is closed.
+    tgOutput << "\n";
+  }
+}
+
 /**
  * The toString method for tgDataLogger2 should have some specific information
  * about (for example) the log file...
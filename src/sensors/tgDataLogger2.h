@@ -28,17 +28,37 @@
 
 // Includes from NTRTsim
 #include "tgDataManager.h"
+#include "tgAsyncFrameWriter.h"
 // Includes from the C++ standard library
 #include <fstream> // for writing to a file
+#include <string>
+#include <vector>
 
 /**
  * tgDataLogger2 is a tgDataManager. It records data from sensors and outputs
- * that data to a log file, in comma-separated-value (CSV) format.
+ * that data to a log file, in comma-separated-value (CSV) format or in a
+ * binary format that can be converted to CSV later with tgDataLogReader.
+ * By default the file is written from step(). After setAsynchronous(),
+ * step() only copies a frame of numbers and a background thread does
+ * the formatting and writing.
  */
-class tgDataLogger2 : public tgDataManager
+class tgDataLogger2 : public tgDataManager, private tgAsyncFrameWriter::Sink
 {
  public:
 
+  /**
+   * The formats that tgDataLogger2 can write.
+   * CSV is human readable, but formats every value as text.
+   * BINARY writes a header with the column headings followed by one
+   * row of doubles (time first) per sample, in native byte order.
+   * Use BINARY for long runs with many sensors.
+   */
+  enum Format
+  {
+    CSV,
+    BINARY
+  };
+
   /**
    * The constructor for tgDataLogger2 takes in a string that specifies the location
    * of the log file to create, as well as an optional variable that controls
@@ -47,8 +67,10 @@ class tgDataLogger2 : public tgDataManager
    * will be written. The current time will be appended to this prefix.
    * @param[in] timeInterval the time interval for querying sensors. Note that an updateTime
    * of 0 means that sensors will be queried at each call of step().
+   * @param[in] format whether to write a CSV (.txt) or a binary (.bin) file.
    */
-  tgDataLogger2(std::string fileNamePrefix, double timeInterval = 0.0);
+  tgDataLogger2(std::string fileNamePrefix, double timeInterval = 0.0,
+		Format format = CSV);
 
   /**
    * Since folks will probably forget that a file name is needed,
@@ -57,11 +79,34 @@ class tgDataLogger2 : public tgDataManager
   tgDataLogger2();
 
   /**
-   * The base class handles destruction of the sensors and sensorInfos,
-   * so nothing to do here.
+   * The base class handles destruction of the sensors and sensorInfos.
+   * Stops the writer thread, if there is one.
    */
   ~tgDataLogger2();
 
+  /**
+   * Write the log file from a background thread instead of from step.
+   * Takes effect at the next setup.
+   * @param[in] queueFrames how many samples may wait to be written.
+   * @param[in] policy whether step waits (BLOCK) or discards the sample
+   * (DROP) when the writer falls queueFrames samples behind.
+   * @throw std::invalid_argument if queueFrames is zero.
+   */
+  void setAsynchronous(std::size_t queueFrames = 1024,
+		       tgAsyncFrameWriter::Policy policy = tgAsyncFrameWriter::BLOCK);
+
+  /**
+   * @return the number of samples discarded by the DROP policy since
+   * the last setup. Always zero for a synchronous logger.
+   */
+  std::size_t getDroppedFrames() const;
+
+  /**
+   * @return the number of samples for which step had to wait under the
+   * BLOCK policy since the last setup. Always zero for a synchronous logger.
+   */
+  std::size_t getBlockedFrames() const;
+
   /**
    * The setup function for tgDataLogger2 will:
    * (1) create all the sensors, (2) create a heading from the sensors, and
@@ -71,15 +116,15 @@ class tgDataLogger2 : public tgDataManager
   virtual void setup();
 
   /**
-   * The teardown function closes the log file.
+   * The teardown function writes any queued samples and closes the log file.
    * TO-DO: should this class also teardown the sensors, or should we let
    * the superclass handle it??
    */
   virtual void teardown();
 
   /**
-   * The step function for tgDataLogger2 will open the log file for output,
-   * write a line of sensor data, then close the log file.
+   * The step function for tgDataLogger2 will write a line (or a binary row)
+   * of sensor data to the log file, which stays open between steps.
    * Declared virtual here just in case any classes inherit from this.
    * @param[in] dt a double, the amount of time since the last step. 
    */
@@ -91,6 +136,17 @@ class tgDataLogger2 : public tgDataManager
    */
   virtual std::string toString() const;
 
+  /**
+   * The first bytes of every binary log file, followed by the
+   * version number of the format.
+   */
+  static const char* const binaryFileTag;
+
+  /**
+   * Version of the binary format. Increase when the layout changes.
+   */
+  static const unsigned int binaryFormatVersion;
+
   // TO-DO: write a new invariant for this subclass, instead of using the parent's.
 
  protected:
@@ -134,6 +190,43 @@ class tgDataLogger2 : public tgDataManager
    * check m_timeInterval.
    */
   double m_updateTime;
+
+  /**
+   * Which kind of file this logger writes.
+   */
+  Format m_format;
+
+  /**
+   * One sample of every column, time first. Sized in setup so that
+   * binary rows can be written without allocating during step.
+   */
+  std::vector<double> m_frame;
+
+  /**
+   * Writes m_frame from a background thread, or NULL to write from step.
+   */
+  tgAsyncFrameWriter* m_pWriter;
+
+ private:
+
+  /**
+   * Format and write one sample, time first, to tgOutput.
+   * Called from step, or from the writer thread when asynchronous.
+   */
+  virtual void writeFrame(const double* frame, std::size_t width);
+
+  /**
+   * Write the binary header: tag, version, number of columns, and
+   * each column heading as a length followed by its characters.
+   * @param[in] columns the headings of all columns, time first.
+   */
+  void writeBinaryHeader(const std::vector<std::string>& columns);
+
+  /**
+   * Fill m_frame with the current time and a sample from every sensor,
+   * using the typed sensor API so that nothing is allocated per sample.
+   */
+  void collectFrame();
   
 };
 
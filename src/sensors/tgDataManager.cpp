@@ -254,6 +254,32 @@ std::string tgDataManager::toString() const
   return os.str();
 }
 
+/**
+ * Sums the fixed widths of all the sensors created during setup.
+ */
+std::size_t tgDataManager::getSensorFrameWidth() const
+{
+  std::size_t width = 0;
+  for (std::size_t i = 0; i < m_sensors.size(); ++i)
+  {
+    width += m_sensors[i]->getSensorDataWidth();
+  }
+  return width;
+}
+
+/**
+ * Each sensor writes its values directly after the previous sensor's,
+ * in the same order as the headings.
+ */
+std::size_t tgDataManager::sampleSensors(double* out)
+{
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < m_sensors.size(); ++i)
+  {
+    written += m_sensors[i]->sampleInto(out + written);
+  }
+  return written;
+}
 
 bool tgDataManager::invariant() const
 {
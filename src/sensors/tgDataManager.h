@@ -29,6 +29,7 @@
 // This application
 #include "core/tgSenseable.h" //not sure why this needs to be included vs. just declared...
 // The C++ Standard Library
+#include <cstddef>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -117,6 +118,21 @@ protected:
     // Integrity predicate.
     bool invariant() const;
 
+    /**
+     * The total number of doubles one call to sampleSensors writes,
+     * i.e. the sum of getSensorDataWidth() over m_sensors.
+     * @return the width of one frame of sensor data
+     */
+    std::size_t getSensorFrameWidth() const;
+
+    /**
+     * Sample every sensor in m_sensors, in order, into a flat buffer.
+     * Does not allocate.
+     * @param[out] out a buffer of at least getSensorFrameWidth() doubles
+     * @return the number of doubles written
+     */
+    std::size_t sampleSensors(double* out);
+
     /**
      * A data manager has a list of sensors that it 
      * has created (during setup.)
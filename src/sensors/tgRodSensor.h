@@ -52,10 +52,12 @@ public:
   virtual ~tgRodSensor();
 
   /**
-   * Similarly, this class will implement the two data colleciton methods.
+   * Similarly, this class will implement the data collection methods.
+   * The string version of the data comes from tgSensor::getSensorData.
    */
   virtual std::vector<std::string> getSensorDataHeadings();
-  virtual std::vector<std::string> getSensorData();
+  virtual std::size_t getSensorDataWidth() const;
+  virtual std::size_t sampleInto(double* out);
 
 };
 
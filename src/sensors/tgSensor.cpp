@@ -29,11 +29,13 @@
 #include "core/tgSenseable.h"
 
 // Includes from the c++ standard library:
+#include <sstream>
 #include <stdexcept>
 
 /**
- * This cpp file only implements the constructor for tgSensor.
- * Note that tgSensor is an abstract class with two pure virtual member
+ * This cpp file implements the constructor for tgSensor, and the string
+ * wrapper around sampleInto.
+ * Note that tgSensor is an abstract class with pure virtual member
  * functions, so you cannot instantiate a tgSensor.
  * However, a constructor is provided here for ease of managing pointers
  * in child classes.
@@ -54,4 +56,26 @@ tgSensor::~tgSensor()
   // likely a tgModel, which is handled by other classes.
 }
 
+/**
+ * Convert one numeric sample into strings, for data managers that
+ * still use the string interface.
+ */
+std::vector<std::string> tgSensor::getSensorData()
+{
+  std::vector<double> sample(getSensorDataWidth());
+  const std::size_t n = sample.empty() ? 0 : sampleInto(&sample[0]);
+
+  // The list of sensor data that will be returned:
+  std::vector<std::string> sensordata;
+  // The doubles need to be converted to strings via a stringstream.
+  std::stringstream ss;
+  for (std::size_t i = 0; i < n; i++) {
+    ss << sample[i];
+    sensordata.push_back( ss.str() );
+    // Reset the stream.
+    ss.str("");
+  }
+  return sensordata;
+}
+
 //end.
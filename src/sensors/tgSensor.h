@@ -31,6 +31,7 @@
 class tgSenseable;
 
 // From the C++ standard library:
+#include <cstddef> // for size_t
 #include <iostream> //for strings
 #include <vector> // for returning lists of strings
 
@@ -81,13 +82,33 @@ public:
   virtual std::vector<std::string> getSensorDataHeadings() = 0;
 
   /**
-   * Return the data from this class itself.
+   * The number of values in one sample from this sensor.
+   * This must not change over the life of the sensor, and MUST equal
+   * the number of elements returned by getSensorDataHeadings, so that
+   * data managers can size one frame for all their sensors at setup.
+   * @return the number of doubles written by sampleInto.
+   */
+  virtual std::size_t getSensorDataWidth() const = 0;
+
+  /**
+   * Write one sample of data from this sensor into a buffer owned by
+   * the caller, in the same order as the headings. Implementations
+   * must not allocate, since this is called at every logged step.
+   * @param[out] out a buffer with room for getSensorDataWidth() doubles.
+   * @return the number of values written, i.e. getSensorDataWidth().
+   */
+  virtual std::size_t sampleInto(double* out) = 0;
+
+  /**
+   * Return the data from this class itself, as strings.
    * Note that this MUST have the same number of elements as is returned by
    * the getDataHeading function.
+   * The default implementation formats a sample from sampleInto; it is kept
+   * for data managers that only need text, but allocates on every call.
    * @return a list of strings, each being a piece of sensor data,
    * in the same order as the headings.
    */
-  virtual std::vector<std::string> getSensorData() = 0;
+  virtual std::vector<std::string> getSensorData();
 
   // TO-DO: should any of this be const?
 
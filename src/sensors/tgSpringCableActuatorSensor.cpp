@@ -33,10 +33,9 @@
 #include "core/tgTags.h"
 
 // Includes from the c++ standard library:
-#include <sstream>  
 #include <stdexcept>
 #include <cassert>
-#include <string> // for std::to_string(float)
+#include <string>
 
 // Includes from Bullet Physics:
 #include "LinearMath/btVector3.h"
@@ -109,10 +108,17 @@ std::vector<std::string> tgSpringCableActuatorSensor::getSensorDataHeadings() {
   return headings;
 }
 
+/**
+ * A tgSpringCableActuator reports rest length, current length and tension.
+ */
+std::size_t tgSpringCableActuatorSensor::getSensorDataWidth() const {
+  return 3;
+}
+
 /**
  * The method that collects the actual data from this tgSpringCableActuator.
  */
-std::vector<std::string> tgSpringCableActuatorSensor::getSensorData() {
+std::size_t tgSpringCableActuatorSensor::sampleInto(double* out) {
   // Similar to getSensorDataHeading, cast the a pointer
   // to a tgSpringCableActuator right now.
   tgSpringCableActuator* m_pSCA =
@@ -122,29 +128,12 @@ std::vector<std::string> tgSpringCableActuatorSensor::getSensorData() {
   // to a tgSpringCableActuator!!!
   assert( m_pSCA != 0);
 
-  // The list of sensor data that will be returned:
-  std::vector<std::string> sensordata;
-
-  // The floats doubles need to be converted to strings via a stringstream.
-  std::stringstream ss;
-
-  // rest length
-  ss << m_pSCA->getRestLength();
-  sensordata.push_back( ss.str() );
-  // Reset the stream.
-  ss.str("");
-
-  // current length
-  ss << m_pSCA->getCurrentLength();
-  sensordata.push_back( ss.str() );
-  ss.str("");
-
-  // tension
-  ss << m_pSCA->getTension();
-  sensordata.push_back( ss.str() );
-  ss.str("");
+  // Same order as the headings.
+  out[0] = m_pSCA->getRestLength();
+  out[1] = m_pSCA->getCurrentLength();
+  out[2] = m_pSCA->getTension();
   
-  return sensordata;
+  return 3;
 }
 
 //end.
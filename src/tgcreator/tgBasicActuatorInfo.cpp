@@ -75,6 +75,11 @@ double tgBasicActuatorInfo::getMass()
 
 
 tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
+{
+    return new tgBulletSpringCable(createAnchors(), m_config.stiffness, m_config.damping, m_config.pretension);
+}
+
+std::vector<tgBulletSpringCableAnchor*> tgBasicActuatorInfo::createAnchors()
 {
      
     // @todo: need to check somewhere that the rigid bodies have been set...
@@ -121,6 +126,6 @@ tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
     tgBulletSpringCableAnchor* anchor2 = new tgBulletSpringCableAnchor(toBody, to);
     anchorList.push_back(anchor2);
 	
-    return new tgBulletSpringCable(anchorList, m_config.stiffness, m_config.damping, m_config.pretension);
+    return anchorList;
 }
     
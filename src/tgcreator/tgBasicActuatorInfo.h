@@ -32,11 +32,13 @@
 #include "tgRigidInfo.h"
 
 #include <string>
+#include <vector>
 
 #include "core/tgBasicActuator.h"
 #include "core/tgTags.h"
 
 class tgBulletSpringCable;
+class tgBulletSpringCableAnchor;
 
 class tgBasicActuatorInfo : public tgConnectorInfo
 {
@@ -75,6 +77,15 @@ public:
 
     virtual void initConnector(tgWorld& world);
 
+    /**
+     * A tgBulletSpringCable has no representation in the world, so
+     * subclasses that override initConnector must check this still holds.
+     */
+    virtual bool canInitConcurrently() const
+    {
+        return true;
+    }
+
     virtual tgModel* createModel(tgWorld& world);
 
     double getMass();
@@ -82,8 +93,14 @@ public:
 protected:    
     
     tgBulletSpringCable* createTgBulletSpringCable();
+
+    /**
+     * Create the anchors at either end, moved to the edges of the
+     * rigid bodies as the config says.
+     */
+    std::vector<tgBulletSpringCableAnchor*> createAnchors();
+
     tgBulletSpringCable* m_bulletSpringCable;
-private:
     
     tgBasicActuator::Config m_config;
     
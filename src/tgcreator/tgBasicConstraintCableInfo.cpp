@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBasicConstraintCableInfo.cpp
+ * @brief Implementation of class tgBasicConstraintCableInfo
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+#include "tgBasicConstraintCableInfo.h"
+
+#include "core/tgBulletConstraintSpringCable.h"
+#include "core/tgBulletSpringCableAnchor.h"
+
+tgBasicConstraintCableInfo::tgBasicConstraintCableInfo(const tgBasicActuator::Config& config) : 
+tgBasicActuatorInfo(config)
+{}
+
+tgBasicConstraintCableInfo::tgBasicConstraintCableInfo(const tgBasicActuator::Config& config, tgTags tags) : 
+tgBasicActuatorInfo(config, tags)
+{}
+
+tgBasicConstraintCableInfo::tgBasicConstraintCableInfo(const tgBasicActuator::Config& config, const tgPair& pair) :
+tgBasicActuatorInfo(config, pair)
+{}
+
+tgConnectorInfo* tgBasicConstraintCableInfo::createConnectorInfo(const tgPair& pair)
+{
+    return new tgBasicConstraintCableInfo(m_config, pair);
+}
+
+void tgBasicConstraintCableInfo::initConnector(tgWorld& world)
+{
+    m_bulletSpringCable = new tgBulletConstraintSpringCable(world, createAnchors(),
+                                                            m_config.stiffness,
+                                                            m_config.damping,
+                                                            m_config.pretension);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBasicConstraintCableInfo.h
+ * @brief Definition of class tgBasicConstraintCableInfo
+ * @author Brian Mirletz
+ * $Id$
+ */
+
+#ifndef SRC_TGCREATOR_TG_BASIC_CONSTRAINT_CABLE_INFO_H
+#define SRC_TGCREATOR_TG_BASIC_CONSTRAINT_CABLE_INFO_H
+
+#include "tgBasicActuatorInfo.h"
+
+#include "core/tgBasicActuator.h"
+#include "core/tgTags.h"
+
+/**
+ * Builds a tgBasicActuator around a tgBulletConstraintSpringCable, so
+ * that stiff cables stay stable at larger time steps. Used just like
+ * tgBasicActuatorInfo, in a world with tgWorld::Config::eSequentialImpulse.
+ */
+class tgBasicConstraintCableInfo : public tgBasicActuatorInfo
+{
+public:
+
+    tgBasicConstraintCableInfo(const tgBasicActuator::Config& config);
+
+    tgBasicConstraintCableInfo(const tgBasicActuator::Config& config, tgTags tags);
+
+    tgBasicConstraintCableInfo(const tgBasicActuator::Config& config, const tgPair& pair);
+
+    virtual ~tgBasicConstraintCableInfo() {}
+    
+    /**
+     * Create a tgConnectorInfo* from a tgPair
+     */ 
+    virtual tgConnectorInfo* createConnectorInfo(const tgPair& pair);
+
+    /**
+     * Create the cable, which adds its constraint to the world.
+     */
+    virtual void initConnector(tgWorld& world);
+
+    /** Adding constraints to the world is not thread safe */
+    virtual bool canInitConcurrently() const
+    {
+        return false;
+    }
+};
+
+
+#endif
@@ -88,6 +88,14 @@ public:
      */
     virtual void initConnector(tgWorld& world);
 
+    /**
+     * A tgBulletCompressionSpring has no representation in the world.
+     */
+    virtual bool canInitConcurrently() const
+    {
+        return true;
+    }
+
     /**
      * Return the tgCompressionSpringActuator that's been built
      * from the tgBulletCompressionSpring.
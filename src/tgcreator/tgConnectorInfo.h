@@ -93,6 +93,16 @@ public:
     virtual std::vector<tgConnectorInfo*> createConnectorInfos(const tgPairs& pairs, const tgTagSearch& tagSearch);
     
     virtual void initConnector(tgWorld& world) = 0;
+
+    /**
+     * Whether initConnector only reads the rigid bodies it attaches to,
+     * so that tgStructureInfo may call it for several connectors at
+     * once. Connectors that add anything to the world must return false.
+     */
+    virtual bool canInitConcurrently() const
+    {
+        return false;
+    }
     
     virtual tgModel* createModel(tgWorld& world) = 0;
     
@@ -30,10 +30,14 @@
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "tgCompoundRigidInfo.h"
 // The C++ standard library
+#include <algorithm>
 #include <map>
+#include <set>
 #include <cstdlib> // for random number generator
 #include <sstream> // for string streams, tags.
 // Boost
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/random/random_device.hpp> // used for the random compound tag hash
 #include <boost/random/uniform_int_distribution.hpp> // used for the random compound tag hash
 
@@ -85,50 +89,98 @@ void tgRigidAutoCompound::setRigidInfoForGroup(tgRigidInfo* rigidInfo, std::dequ
     }
 }
 
-void tgRigidAutoCompound::groupRigids()
+namespace
 {
-    std::deque<tgRigidInfo*> ungrouped = std::deque<tgRigidInfo*>(m_rigids); // Copy of m_rigids
+    /**
+     * Hashes node positions. Nodes are only shared when their positions
+     * are exactly equal, as in tgRigidInfo::sharesNodesWith.
+     */
+    struct NodeHash
+    {
+        std::size_t operator()(const btVector3& v) const
+        {
+            std::size_t seed = 0;
+            // Adding zero turns -0.0 into 0.0, which compare equal
+            boost::hash_combine(seed, v.x() + 0.0);
+            boost::hash_combine(seed, v.y() + 0.0);
+            boost::hash_combine(seed, v.z() + 0.0);
+            return seed;
+        }
+    };
 
-    while(ungrouped.size() > 0) {
-        // go through each ungrouped element and find the groups for it
-        tgRigidInfo* elem = ungrouped[0]; // Note: the 0 element is removed by findGroup, so ungrouped[0] is different each iteration
+    struct NodeEqual
+    {
+        bool operator()(const btVector3& a, const btVector3& b) const
+        {
+            return a == b;
+        }
+    };
 
-        // Find all elements linked to the first item in ungrouped
-        // This will also remove the elements in the group from ungrouped
-        std::deque<tgRigidInfo*> group = findGroup(elem, ungrouped);
+    /** The first rigid found at each node position */
+    typedef boost::unordered_map<btVector3, std::size_t, NodeHash, NodeEqual> NodeOwners;
 
-        // Add the group to the groups list
-        m_groups.push_back(group);            
+    std::size_t findRoot(std::vector<std::size_t>& parents, std::size_t i)
+    {
+        while (parents[i] != i) {
+            // Path halving
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
     }
-}
 
-// Find all rigids that should be in a group with the given rigid
-// @todo: This may contain an off-by-one error (the last rigid may not be grouped properly...)
-std::deque<tgRigidInfo*> tgRigidAutoCompound::findGroup(tgRigidInfo* rigid, std::deque<tgRigidInfo*>& ungrouped) {
+    void unite(std::vector<std::size_t>& parents,
+               std::vector<std::size_t>& ranks,
+               std::size_t a, std::size_t b)
+    {
+        a = findRoot(parents, a);
+        b = findRoot(parents, b);
+        if (a == b) {
+            return;
+        }
+        if (ranks[a] < ranks[b]) {
+            std::swap(a, b);
+        }
+        parents[b] = a;
+        if (ranks[a] == ranks[b]) {
+            ranks[a]++;
+        }
+    }
+}
 
-    std::deque<tgRigidInfo*> group;
+void tgRigidAutoCompound::groupRigids()
+{
+    const std::size_t n = m_rigids.size();
+    std::vector<std::size_t> parents(n);
+    std::vector<std::size_t> ranks(n, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        parents[i] = i;
+    }
 
-    // Add the rigid to the current group
-    group.push_back(rigid);     
-    
-    // Remove the rigid from the ungrouped since it's now in a group
-    ungrouped.erase(std::remove(ungrouped.begin(), ungrouped.end(), rigid), ungrouped.end());
-    
-    // Recursively find linked elements
-    int i = 0;
-    while(i < ungrouped.size()) {
-        tgRigidInfo* other = ungrouped[i];
-        if(rigid->sharesNodesWith(*other)) {
-            std::deque<tgRigidInfo*> links = findGroup(other, ungrouped);
-            group.insert(group.end(), links.begin(), links.end());
-            i = 0;
-        } else {
-            i++;
+    NodeOwners owners;
+    for (std::size_t i = 0; i < n; i++) {
+        const std::set<btVector3> nodes = m_rigids[i]->getContainedNodes();
+        std::set<btVector3>::const_iterator it;
+        for (it = nodes.begin(); it != nodes.end(); ++it) {
+            const std::pair<btVector3, std::size_t> entry(*it, i);
+            const std::pair<NodeOwners::iterator, bool> result = owners.insert(entry);
+            if (!result.second) {
+                unite(parents, ranks, i, result.first->second);
+            }
         }
     }
 
-    return group;
-};
+    // Number the groups in order of their first rigid
+    std::vector<std::size_t> groupOfRoot(n, n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::size_t root = findRoot(parents, i);
+        if (groupOfRoot[root] == n) {
+            groupOfRoot[root] = m_groups.size();
+            m_groups.push_back(std::deque<tgRigidInfo*>());
+        }
+        m_groups[groupOfRoot[root]].push_back(m_rigids[i]);
+    }
+}
     
 void tgRigidAutoCompound::createCompounds() {
     for(int i=0; i < m_groups.size(); i++) {
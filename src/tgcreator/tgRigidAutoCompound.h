@@ -66,12 +66,16 @@ protected:
    
     void setRigidInfoForGroup(tgRigidInfo* rigidInfo, std::deque<tgRigidInfo*>& group);
     
+    /**
+     * Groups rigids that share nodes, directly or through other rigids.
+     * Each node position is looked up in a hash table of the positions
+     * seen so far, and rigids that meet at a node are merged with
+     * union-find, so grouping is close to linear in the number of nodes.
+     * Groups are ordered by their first rigid in m_rigids, and rigids
+     * within a group keep their order in m_rigids.
+     */
     void groupRigids();
 
-    // Find all rigids that should be in a group with the given rigid
-    // @todo: This may contain an off-by-one error (the last rigid may not be grouped properly...)
-    std::deque<tgRigidInfo*> findGroup(tgRigidInfo* rigid, std::deque<tgRigidInfo*>& ungrouped);
-
     /**
      * Creates tgCompoundRigidInfos for compounded bodies.
      * Also, adds tags to each of the consitutent tgRigidInfos 
@@ -119,7 +119,30 @@ void tgRigidInfo::initRigidBody(tgWorld& world)
                 rigid->setRigidBody(body);
             }
         }
+
+        // A body from prepareRigidBody is not in the world yet
+        btRigidBody* const body = getRigidBody();
+        if (body != NULL && body->getBroadphaseHandle() == NULL) {
+            tgBulletUtil::worldToDynamicsWorld(world).addRigidBody(body);
+        }
+    }
+
+void tgRigidInfo::prepareRigidBody(tgWorld& world)
+{
+    tgRigidInfo* rigid = getRigidInfoGroup();
+    if (rigid == 0) {
+        rigid = this;
+    }
+
+    if (rigid->getRigidBody() == NULL) {
+        btRigidBody* const body =
+            tgBulletUtil::createRigidBody(rigid->getMass(),
+                                          rigid->getTransform(),
+                                          rigid->getCollisionShape(world));
+        body->setFlags(BT_ENABLE_GYROPSCOPIC_FORCE);
+        rigid->setRigidBody(body);
     }
+}
 
 btRigidBody* tgRigidInfo::getRigidBody() 
 { 
@@ -120,8 +120,21 @@ public:
 
     virtual std::vector<tgRigidInfo*> createRigidInfos(const tgPairs& pairs, const tgTagSearch& tagSearch);
 
+    /**
+     * Create the btRigidBody for this rigid's group, and add it to the
+     * world if prepareRigidBody did not already do so.
+     */
     virtual void initRigidBody(tgWorld& world);
 
+    /**
+     * Create the collision shape and btRigidBody for this rigid's group
+     * without adding the body to the world; initRigidBody adds it later.
+     * Called from several threads at once by tgStructureInfo, each with
+     * a different group. Subclasses whose collision object is not a
+     * btRigidBody should override this to do nothing.
+     */
+    virtual void prepareRigidBody(tgWorld& world);
+
     virtual tgModel* createModel(tgWorld& world) = 0;
 
     /**
@@ -204,6 +204,8 @@ btVector3 tgStructure::getCentroid() const {
 }
 
 tgNode& tgStructure::findNode(const std::string& tags) {
+    // Split the search once rather than once per node
+    const std::vector<int> search = tgTags::lookupAll(tags);
     std::queue<tgStructure*> q;
 
     q.push(this);
@@ -212,7 +214,7 @@ tgNode& tgStructure::findNode(const std::string& tags) {
         tgStructure* structure = q.front();
         q.pop();
         for (int i = 0; i < structure->m_nodes.size(); i++) {
-            if (structure->m_nodes[i].hasAllTags(tags)) {
+            if (structure->m_nodes[i].hasAllTags(search)) {
                 return structure->m_nodes[i];
             }
         }
@@ -247,6 +249,7 @@ tgPair& tgStructure::findPair(const btVector3& from, const btVector3& to) {
 }
 
 tgStructure& tgStructure::findChild(const std::string& tags) {
+    const std::vector<int> search = tgTags::lookupAll(tags);
     std::queue<tgStructure*> q;
 
     for (int i = 0; i < m_children.size(); i++) {
@@ -256,7 +259,7 @@ tgStructure& tgStructure::findChild(const std::string& tags) {
     while (!q.empty()) {
         tgStructure* structure = q.front();
         q.pop();
-        if (structure->hasAllTags(tags)) {
+        if (structure->hasAllTags(search)) {
             return *structure;
         }
         for (int i = 0; i < structure->m_children.size(); i++) {
@@ -32,8 +32,164 @@
 #include "tgStructure.h"
 #include "core/tgWorld.h"
 #include "core/tgModel.h"
+// Boost
+#include <boost/atomic.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 // The C++ Standard Library
+#include <algorithm>
+#include <exception>
 #include <stdexcept>
+#include <string>
+
+namespace
+{
+    /**
+     * Hands out the indices [0, n) to the threads of parallelFor.
+     * The first exception thrown by the body stops the loop.
+     */
+    template <class F>
+    class ParallelLoop
+    {
+    public:
+
+        ParallelLoop(std::size_t n, F& body) :
+            m_n(n),
+            m_body(body),
+            m_next(0),
+            m_failed(false)
+        {
+        }
+
+        void run()
+        {
+            try
+            {
+                while (!m_failed.load(boost::memory_order_acquire))
+                {
+                    const std::size_t i = m_next.fetch_add(1);
+                    if (i >= m_n)
+                    {
+                        break;
+                    }
+                    m_body(i);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                boost::mutex::scoped_lock lock(m_errorMutex);
+                if (!m_failed.load())
+                {
+                    m_error = e.what();
+                    m_failed.store(true, boost::memory_order_release);
+                }
+            }
+        }
+
+        bool failed() const
+        {
+            return m_failed.load();
+        }
+
+        const std::string& error() const
+        {
+            return m_error;
+        }
+
+    private:
+        const std::size_t m_n;
+
+        F& m_body;
+
+        boost::atomic<std::size_t> m_next;
+
+        boost::atomic<bool> m_failed;
+
+        boost::mutex m_errorMutex;
+
+        std::string m_error;
+    };
+
+    /**
+     * Call body(i) for each i in [0, n), on up to numThreads threads
+     * including this one. Returns once every call has finished.
+     */
+    template <class F>
+    void parallelFor(std::size_t n, std::size_t numThreads, F body)
+    {
+        ParallelLoop<F> loop(n, body);
+
+        boost::thread_group threads;
+        const std::size_t numWorkers = std::min(numThreads, n);
+        for (std::size_t i = 1; i < numWorkers; i++)
+        {
+            threads.create_thread(boost::bind(&ParallelLoop<F>::run, &loop));
+        }
+        loop.run();
+        threads.join_all();
+
+        if (loop.failed())
+        {
+            throw std::runtime_error("tgStructureInfo parallel build failed: " +
+                                     loop.error());
+        }
+    }
+
+    struct ChooseRigids
+    {
+        ChooseRigids(const std::vector<tgConnectorInfo*>& connectors,
+                     const std::vector<tgRigidInfo*>& rigids) :
+            m_connectors(connectors),
+            m_rigids(rigids)
+        {
+        }
+
+        void operator()(std::size_t i)
+        {
+            m_connectors[i]->chooseRigids(m_rigids);
+        }
+
+        const std::vector<tgConnectorInfo*>& m_connectors;
+        const std::vector<tgRigidInfo*>& m_rigids;
+    };
+
+    struct PrepareRigidBody
+    {
+        PrepareRigidBody(const std::vector<tgRigidInfo*>& groups,
+                         tgWorld& world) :
+            m_groups(groups),
+            m_world(world)
+        {
+        }
+
+        void operator()(std::size_t i)
+        {
+            m_groups[i]->prepareRigidBody(m_world);
+        }
+
+        const std::vector<tgRigidInfo*>& m_groups;
+        tgWorld& m_world;
+    };
+
+    struct InitConnector
+    {
+        InitConnector(const std::vector<tgConnectorInfo*>& connectors,
+                      tgWorld& world) :
+            m_connectors(connectors),
+            m_world(world)
+        {
+        }
+
+        void operator()(std::size_t i)
+        {
+            m_connectors[i]->initConnector(m_world);
+        }
+
+        const std::vector<tgConnectorInfo*>& m_connectors;
+        tgWorld& m_world;
+    };
+}
 
 tgStructureInfo::tgStructureInfo(tgStructure& structure, tgBuildSpec& buildSpec) : 
     tgTaggable(),
@@ -114,6 +270,24 @@ std::vector<tgRigidInfo*> tgStructureInfo::getAllRigids() const
     return result;
 }
 
+std::vector<tgConnectorInfo*> tgStructureInfo::getAllConnectors() const
+{
+    std::vector<tgConnectorInfo*> result;
+    result.insert(result.end(), m_connectors.begin(), m_connectors.end());
+
+    // Collect child connectors
+    for (std::size_t i = 0; i < m_children.size(); i++)
+    {
+        tgStructureInfo * const pStructureInfo = m_children[i];
+    assert(pStructureInfo != NULL);
+        std::vector<tgConnectorInfo*> childConnectors =
+            pStructureInfo->getAllConnectors();
+        result.insert(result.end(), childConnectors.begin(), childConnectors.end());
+    }
+
+    return result;
+}
+
 ////////////////////////////
 // Build methods
 ////////////////////////////
@@ -269,6 +443,47 @@ void tgStructureInfo::initConnectors(tgWorld& world)
     } 
 }
 
+void tgStructureInfo::chooseConnectorRigidsParallel(std::size_t numThreads)
+{
+    const std::vector<tgRigidInfo*> allRigids = getAllRigids();
+    const std::vector<tgConnectorInfo*> allConnectors = getAllConnectors();
+    parallelFor(allConnectors.size(), numThreads,
+                ChooseRigids(allConnectors, allRigids));
+}
+
+void tgStructureInfo::prepareRigidBodiesParallel(tgWorld& world,
+                                                 std::size_t numThreads)
+{
+    // One entry per group, so no two threads make the same body
+    parallelFor(m_compounded.size(), numThreads,
+                PrepareRigidBody(m_compounded, world));
+}
+
+void tgStructureInfo::initConnectorsParallel(tgWorld& world,
+                                             std::size_t numThreads)
+{
+    const std::vector<tgConnectorInfo*> allConnectors = getAllConnectors();
+    std::vector<tgConnectorInfo*> concurrent;
+    for (std::size_t i = 0; i < allConnectors.size(); i++)
+    {
+        if (allConnectors[i]->canInitConcurrently())
+        {
+            concurrent.push_back(allConnectors[i]);
+        }
+    }
+    parallelFor(concurrent.size(), numThreads,
+                InitConnector(concurrent, world));
+
+    // The rest may touch the world, so keep them in order on this thread
+    for (std::size_t i = 0; i < allConnectors.size(); i++)
+    {
+        if (!allConnectors[i]->canInitConcurrently())
+        {
+            allConnectors[i]->initConnector(world);
+        }
+    }
+}
+
 /**
  * This is the entry point from other classes.
  * The buildInto method starts the building process, and calls
@@ -310,6 +525,30 @@ void tgStructureInfo::buildInto(tgModel& model, tgWorld& world)
     */
 }
 
+void tgStructureInfo::buildInto(tgModel& model, tgWorld& world,
+                                std::size_t numThreads)
+{
+    if (numThreads == 0)
+    {
+        numThreads = boost::thread::hardware_concurrency() > 0 ?
+            boost::thread::hardware_concurrency() : 1;
+    }
+    if (numThreads == 1)
+    {
+        buildInto(model, world);
+        return;
+    }
+
+    addRigidsAndConnectors();
+    autoCompoundRigids();
+    chooseConnectorRigidsParallel(numThreads);
+    prepareRigidBodiesParallel(world, numThreads);
+    // Adds the prepared bodies to the world, in the serial order
+    initRigidBodies(world);
+    initConnectorsParallel(world, numThreads);
+    buildIntoHelper(model, world, *this);
+}
+
 void tgStructureInfo::buildIntoHelper(tgModel& model, tgWorld& world,
                       tgStructureInfo& structureInfo)
 {
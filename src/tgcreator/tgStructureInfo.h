@@ -32,6 +32,7 @@
 // NTRT Core library
 #include "core/tgTaggable.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
@@ -68,9 +69,29 @@ public:
         return m_connectors;
     }
 
+    // Return all connectors in this structure and its descendants
+    std::vector<tgConnectorInfo*> getAllConnectors() const;
+
     // Build our info into the provided model
     void buildInto(tgModel& model, tgWorld& world);
 
+    /**
+     * Build our info into the provided model, using several threads for
+     * the steps that are independent per element: choosing the rigids
+     * of each connector, making collision shapes and rigid bodies, and
+     * initializing connectors that report canInitConcurrently(). Adding
+     * bodies to the world and building the model tree stay on the calling
+     * thread, in the same order as buildInto(model, world), so the
+     * result does not depend on the number of threads.
+     * @param[in,out] model the model to build into
+     * @param[in,out] world the world to build into
+     * @param[in] numThreads the number of threads to use, including the
+     * calling thread. 1 is the same as buildInto(model, world), and 0
+     * uses one thread per core.
+     * @throw std::runtime_error if building any element throws
+     */
+    void buildInto(tgModel& model, tgWorld& world, std::size_t numThreads);
+
 private:
 
     /*
@@ -99,6 +120,16 @@ private:
     void initRigidBodies(tgWorld& world);
     
     void initConnectors(tgWorld& world);
+
+    /**
+     * The parallel counterparts of chooseConnectorRigids, the shape and
+     * body creation in initRigidBodies, and initConnectors.
+     */
+    void chooseConnectorRigidsParallel(std::size_t numThreads);
+
+    void prepareRigidBodiesParallel(tgWorld& world, std::size_t numThreads);
+
+    void initConnectorsParallel(tgWorld& world, std::size_t numThreads);
     
     const std::vector<tgRigidInfo*>& getRigids() const
     {
@@ -26,8 +26,10 @@
 
 #include "CPGEquations.h"
 
-#include "boost/array.hpp"
+#include "core/tgSimulationState.h"
+
 #include "boost/numeric/odeint.hpp"
+#include "boost/ref.hpp"
 
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
@@ -35,41 +37,66 @@
 
 // The C++ Standard Library
 #include <assert.h>
+#include <math.h>
 #include <stdexcept>
 
 using namespace boost::numeric::odeint;
 
 typedef std::vector<double > cpgVars_type;
 
+/**
+ * The same stepper integrate() used to build for every update
+ */
+struct CPGEquations::Stepper
+{
+	controlled_runge_kutta< runge_kutta_dopri5< cpgVars_type > > rk;
+};
+
 CPGEquations::CPGEquations(int maxSteps) :
+m_couplingStart(1, 0),
+m_batchedCoupling(false),
 stepSize(0.1),
 numSteps(0),
-m_maxSteps(maxSteps)
+m_maxSteps(maxSteps),
+m_pStepper(new Stepper())
  {}
-CPGEquations::CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps) :
-nodeList(newNodeList),
-stepSize(0.1), //TODO: specify as a parameter somewhere
-numSteps(0),
-m_maxSteps(maxSteps)
-{
-}
 
 CPGEquations::~CPGEquations()
 {
-	for (std::size_t i = 0; i < nodeList.size(); i++)
-	{
-		delete nodeList[i];
-	}
-	nodeList.clear();
+	delete m_pStepper;
 }
 
 // Params needs size 7 to fill all of the params.
 // TODO: consider changing to a config struct
 int CPGEquations::addNode(std::vector<double>& newParams) 
 {
-	int index = nodeList.size();
-	CPGNode* newNode = new CPGNode(index, newParams);
-	nodeList.push_back(newNode);
+	//Precondition
+	assert(newParams.size() >= 7);
+	
+	int index = size();
+	
+	m_frequencyOffset.push_back(newParams[0]);
+	m_frequencyScale.push_back(newParams[1]);
+	m_radiusOffset.push_back(newParams[2]);
+	m_radiusScale.push_back(newParams[3]);
+	m_rConst.push_back(newParams[4]);
+	m_dMin.push_back(newParams[5]);
+	m_dMax.push_back(newParams[6]);
+	
+	// Phi, R and RDot
+	XVars.push_back(0.0);
+	XVars.push_back(0.0);
+	XVars.push_back(0.0);
+	
+	// No couplings yet
+	m_couplingStart.push_back(m_couplingStart.back());
+	
+	const std::size_t n = size();
+	m_sinPhi.resize(n);
+	m_cosPhi.resize(n);
+	m_rSinPhi.resize(n);
+	m_rCosPhi.resize(n);
+	m_phaseCoupling.resize(n);
 	
 	return index;
 }
@@ -81,11 +108,27 @@ void CPGEquations::defineConnections (	int nodeIndex,
 {
 	assert(connections.size() == newWeights.size());
 	assert(connections.size() == newPhaseOffsets.size());
-	assert(nodeList[nodeIndex] != NULL);
+	assert(nodeIndex >= 0 && nodeIndex < size());
 	
-	for(int i = 0; i != connections.size(); i++){
-		nodeList[nodeIndex]->addCoupling(nodeList[connections[i]], newWeights[i], newPhaseOffsets[i]); 
+	// Insert after the node's existing couplings, and shift the rows after it
+	const std::size_t n = connections.size();
+	const std::size_t pos = m_couplingStart[nodeIndex + 1];
+	for(std::size_t i = 0; i != n; i++){
+		assert(connections[i] >= 0 && connections[i] < size());
+		m_couplingNode.insert(m_couplingNode.begin() + pos + i, connections[i]);
+		m_couplingWeight.insert(m_couplingWeight.begin() + pos + i, newWeights[i]);
+		m_couplingPhase.insert(m_couplingPhase.begin() + pos + i, newPhaseOffsets[i]);
+		m_couplingWeightCos.insert(m_couplingWeightCos.begin() + pos + i,
+								   newWeights[i] * cos(newPhaseOffsets[i]));
+		m_couplingWeightSin.insert(m_couplingWeightSin.begin() + pos + i,
+								   newWeights[i] * sin(newPhaseOffsets[i]));
 	}
+	for(std::size_t j = nodeIndex + 1; j < m_couplingStart.size(); j++){
+		m_couplingStart[j] += n;
+	}
+	
+	m_edgeSin.resize(m_couplingNode.size());
+	m_edgeCos.resize(m_couplingNode.size());
 }
 
 const double CPGEquations::operator[](const std::size_t i) const
@@ -94,65 +137,123 @@ const double CPGEquations::operator[](const std::size_t i) const
     BT_PROFILE("CPGEquations::[]");
 #endif //BT_NO_PROFILE
 	double nodeValue;
-	if (i >= nodeList.size())
+	if (i >= size())
 	{
 		nodeValue = NAN;
 		throw std::invalid_argument("Node index out of bounds");
 	}
 	else
 	{
-		nodeValue = (*nodeList[i]).nodeValue;
+		nodeValue = XVars[3*i+1] * cos(XVars[3*i]);
 	}
 	
 	return nodeValue;
 }
 
-std::vector<double>& CPGEquations::getXVars() {
+void CPGEquations::prepareCouplings(const std::vector<double>& x) const
+{
+	if (!m_batchedCoupling || size() == 0)
+	{
+		return;
+	}
 #ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquations::getXVars");
+    BT_PROFILE("CPGEquations::prepareCouplings");
 #endif //BT_NO_PROFILE
-	XVars.clear();
 	
-	for (int i = 0; i != nodeList.size(); i++){
-		XVars.push_back(nodeList[i]->phiValue);
-		XVars.push_back(nodeList[i]->rValue);
-		XVars.push_back(nodeList[i]->rDotValue);
+	/**
+	 * With A = w cos(phase) and B = w sin(phase), the coupling term
+	 * w r_j sin(phi_j - phi_i - phase) is
+	 * cos(phi_i) (A r_j sin(phi_j) - B r_j cos(phi_j))
+	 * - sin(phi_i) (A r_j cos(phi_j) + B r_j sin(phi_j))
+	 * so the only sines and cosines needed are those of each phase.
+	 */
+	const std::size_t n = size();
+	for (std::size_t i = 0; i != n; i++){
+		const double phi = x[3*i];
+		const double r = x[3*i+1];
+		const double s = sin(phi);
+		const double c = cos(phi);
+		m_sinPhi[i] = s;
+		m_cosPhi[i] = c;
+		m_rSinPhi[i] = r * s;
+		m_rCosPhi[i] = r * c;
 	}
 	
-	return XVars;
-}
-
-std::vector<double>& CPGEquations::getDXVars() {
-	DXVars.clear();
-	
-	for (int i = 0; i != nodeList.size(); i++){
-		DXVars.push_back(nodeList[i]->phiDotValue);
-		DXVars.push_back(nodeList[i]->rDotValue);
-		DXVars.push_back(nodeList[i]->rDoubleDotValue);
+	// Plain loops over flat arrays, so the compiler can vectorize them
+	const std::size_t numEdges = m_couplingNode.size();
+	const std::size_t* const target = numEdges ? &m_couplingNode[0] : NULL;
+	const double* const a = numEdges ? &m_couplingWeightCos[0] : NULL;
+	const double* const b = numEdges ? &m_couplingWeightSin[0] : NULL;
+	const double* const rSin = &m_rSinPhi[0];
+	const double* const rCos = &m_rCosPhi[0];
+	double* const edgeSin = numEdges ? &m_edgeSin[0] : NULL;
+	double* const edgeCos = numEdges ? &m_edgeCos[0] : NULL;
+	for (std::size_t k = 0; k < numEdges; k++){
+		const double rs = rSin[target[k]];
+		const double rc = rCos[target[k]];
+		edgeSin[k] = a[k] * rs - b[k] * rc;
+		edgeCos[k] = a[k] * rc + b[k] * rs;
 	}
 	
-	return DXVars;
+	for (std::size_t i = 0; i != n; i++){
+		double sumSin = 0.0;
+		double sumCos = 0.0;
+		const std::size_t end = m_couplingStart[i + 1];
+		for (std::size_t k = m_couplingStart[i]; k != end; k++){
+			sumSin += edgeSin[k];
+			sumCos += edgeCos[k];
+		}
+		m_phaseCoupling[i] = m_cosPhi[i] * sumSin - m_sinPhi[i] * sumCos;
+	}
 }
 
-void CPGEquations::updateNodes(std::vector<double>& descCom)
+double CPGEquations::couplePhase(const std::vector<double>& x, std::size_t i, double phiDot) const
 {
-#ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquations::updateNodes");
-#endif //BT_NO_PROFILE
-	for(int i = 0; i != nodeList.size(); i++){
-		nodeList[i]->updateDTs(descCom[i]);
+	if (m_batchedCoupling)
+	{
+		return phiDot + m_phaseCoupling[i];
+	}
+	
+	/**
+	 * Iterate through every edge and affect the phase of this node
+	 * accordingly.
+	 */
+	const double phi = x[3*i];
+	const std::size_t end = m_couplingStart[i + 1];
+	for (std::size_t k = m_couplingStart[i]; k != end; k++){
+		const std::size_t j = m_couplingNode[k];
+		phiDot += m_couplingWeight[k] * x[3*j+1] * sin (x[3*j] - phi - m_couplingPhase[k]);
 	}
+	return phiDot;
 }
 
-void CPGEquations::updateNodeData(std::vector<double> newXVals)
+void CPGEquations::computeDXVars(const std::vector<double>& x,
+								 std::vector<double>& dxdt,
+								 const std::vector<double>& descCom) const
 {
 #ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquations::updateNodeData");
-#endif //BT_NO_PROFILE    
-	assert(newXVals.size()==3*nodeList.size());
+    BT_PROFILE("CPGEquations::computeDXVars");
+#endif //BT_NO_PROFILE
+	const std::size_t n = size();
+	assert(descCom.size() >= n);
+	
+	prepareCouplings(x);
 	
-	for(int i = 0; i!=nodeList.size(); i++){
-		nodeList[i]->updateNodeValues(newXVals[3*i], newXVals[3*i+1], newXVals[3*i+2]);
+	for (std::size_t i = 0; i != n; i++){
+		const double d = descCom[i];
+		const double rValue = x[3*i+1];
+		const double rDotValue = x[3*i+2];
+		
+		const double phiDotValue = couplePhase(x, i,
+			2 * M_PI * nodeEquation(d, m_frequencyOffset[i], m_frequencyScale[i], i));
+		
+		const double rConst = m_rConst[i];
+		const double rDoubleDotValue = rConst * (rConst / 4 * (nodeEquation(d, m_radiusOffset[i], m_radiusScale[i], i)
+			- rValue) - rDotValue);
+		
+		dxdt[3*i] = phiDotValue;
+		dxdt[3*i+1] = rDotValue;
+		dxdt[3*i+2] = rDoubleDotValue;
 	}
 }
 
@@ -162,9 +263,9 @@ void CPGEquations::updateNodeData(std::vector<double> newXVals)
 class integrate_function {
 	public:
 	
-	integrate_function(CPGEquations* pCPGs, std::vector<double> newComs) :
+	integrate_function(CPGEquations* pCPGs, const std::vector<double>& newComs) :
 	theseCPGs(pCPGs),
-	descCom(newComs)
+	descCom(&newComs)
 	{
 		
 	}
@@ -176,56 +277,15 @@ class integrate_function {
 #ifndef BT_NO_PROFILE 
         BT_PROFILE("CPGEquations::integrate_function");
 #endif //BT_NO_PROFILE
-		theseCPGs->updateNodeData(x);
-		theseCPGs->updateNodes(descCom);
-	
-		/**
-		 * Read information from nodes into variables that work for ODEInt
-		 */
-		std::vector<double> dXVars = theseCPGs->getDXVars();
-		/**
-		 * Values are pre-computed by nodes, so we just have to transfer
-		 * them
-		 */
-		for(std::size_t i = 0; i != x.size(); i++){
-			dxdt[i] = dXVars[i];
-		}
-		//std::cout<<"operator call"<<std::endl;
+		theseCPGs->computeDXVars(x, dxdt, *descCom);
 		
 		theseCPGs->countStep();
-		
-	}
-	
-	private:
-	CPGEquations* theseCPGs;
-	std::vector<double> descCom;
-};
-
-/**
- * ODE_Int Output function, can do nothing, but needs to exist
- */
-class output_function {
-	public: 
-	
-	output_function(CPGEquations* pCPGs) :
-	theseCPGs(pCPGs)
-	{
-	}
-	
-	void operator() ( 	const cpgVars_type &x ,
-						const double t )
-	{
-		/**
-		 * Push integrated vars back to nodes
-		 */
-		theseCPGs->updateNodeData(x);
-		#if (0) // Suppress output
-		std::cout << t << '\t' << (*theseCPGs)[0]  << '\t' << (*theseCPGs)[1]  << '\t' << (*theseCPGs)[2]  << std::endl;
-		#endif
 	}
 	
 	private:
 	CPGEquations* theseCPGs;
+	// Copied once per ODEInt call, so only point to the commands
+	const std::vector<double>* descCom;
 };
 
 void CPGEquations::update(std::vector<double>& descCom, double dt)
@@ -243,27 +303,35 @@ void CPGEquations::update(std::vector<double>& descCom, double dt)
 	numSteps = 0;
 	
 	/**
-	 * Read information from nodes into variables that work for ODEInt
+	 * Run ODEInt. This will change the data in XVars. The descending
+	 * commands changed since the last update, so the derivative the
+	 * stepper kept from its last step is stale.
 	 */
-	std::vector<double>& xVars = getXVars(); 
-	
-	/**
-	 * Run ODEInt. This will change the data in xVars
-	 */
-	integrate(integrate_function(this, descCom), xVars, 0.0, dt, stepSize, output_function(this));
+	m_pStepper->rk.reset();
+	integrate_adaptive(boost::ref(m_pStepper->rk), integrate_function(this, descCom),
+						XVars, 0.0, dt, stepSize);
 	
     if (numSteps > m_maxSteps)
     {
         std::cout << "Ending trial due to inefficient equations " << numSteps << std::endl;
         throw std::runtime_error("Inefficient CPG Parameters");
     }
-    
-	 #if (0)
-	 std::cout << dt << '\t' << nodeList[0]->nodeValue <<
-	  '\t' << nodeList[1]->nodeValue <<
-	   '\t' << nodeList[2]->nodeValue << std::endl;
-	 #endif
-	   
+}
+
+void CPGEquations::saveState(tgSimulationState& state) const
+{
+	for (std::size_t i = 0; i < XVars.size(); i++)
+	{
+		state.write(XVars[i]);
+	}
+}
+
+void CPGEquations::restoreState(tgSimulationState& state)
+{
+	for (std::size_t i = 0; i < XVars.size(); i++)
+	{
+		XVars[i] = state.read();
+	}
 }
 
 std::string CPGEquations::toString(const std::string& prefix) const
@@ -273,8 +341,15 @@ std::string CPGEquations::toString(const std::string& prefix) const
 	os << prefix << "CPGEquations(" << std::endl;
 
 	os << prefix << p << "Nodes:" << std::endl;
-	for(int i = 0; i < nodeList.size(); i++) {
-		os << prefix << p << p << *(nodeList[i]) << std::endl;
+	for(std::size_t i = 0; i < size(); i++) {
+		os << prefix << p << p << "CPGNode(" << p << i << std::endl;
+		os << prefix << p << p << p << "Connectivity:" << std::endl;
+		for(std::size_t k = m_couplingStart[i]; k < m_couplingStart[i + 1]; k++) {
+			os << prefix << p << p << p << p << m_couplingNode[k]
+			   << " weight " << m_couplingWeight[k]
+			   << " phase " << m_couplingPhase[k] << std::endl;
+		}
+		os << prefix << p << p << ")" << std::endl;
 	}
 
 	os << prefix << ")" << std::endl;
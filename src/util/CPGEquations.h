@@ -27,49 +27,106 @@
  * $Id$
  */
 
+#include <cstddef>
 #include <vector>
 #include <sstream>
 
-#include "CPGNode.h"
+// Forward declarations
+class tgSimulationState;
 
 /**
  * The top level class for interfacing with CPGs. Contains the definition
  * of the CPG (list of nodes) as well as functions to interface with ODEInt
+ *
+ * Node parameters and state are kept in flat arrays, and the couplings
+ * in compressed sparse rows, so evaluating the equations reads
+ * contiguous memory and never allocates. The state of node i is
+ * XVars[3i] to XVars[3i + 2]. The same adaptive Runge-Kutta-Dormand-Prince
+ * stepper is reused by every call to update, so its work arrays are only
+ * allocated when nodes are added.
  */
 class CPGEquations
 {
  public:
 	
 	CPGEquations(int maxSteps = 200);
-
-	CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps = 200);
 	
 	virtual ~CPGEquations();
 	
-	int addNode(std::vector<double>& newParams);
+	/**
+	 * Add a node with zero phase, radius and radius rate
+	 * @param[in] newParams frequency offset, frequency scale, radius
+	 * offset, radius scale, rConst, dMin and dMax, in that order
+	 * @return the index of the new node
+	 */
+	virtual int addNode(std::vector<double>& newParams);
 
-	 void defineConnections (int nodeIndex,
+	/**
+	 * Couple a node to others. May be called more than once per node;
+	 * the couplings are appended to those already defined.
+	 */
+	void defineConnections (int nodeIndex,
 				 std::vector<int> connections,
 				 std::vector<double> newWeights,
 				 std::vector<double> newPhaseOffsets);
 	
+	/**
+	 * @return the output of node i, its radius times the cosine of its
+	 * phase
+	 */
 	const double operator[](const std::size_t i) const;
-
-	virtual std::vector<double>& getXVars();
-	
-	virtual std::vector<double>& getDXVars();
-	
-	virtual void updateNodes(std::vector<double>& descCom);
 	
-	virtual void updateNodeData(std::vector<double> newXVals);
+	/**
+	 * Compute the derivative of every state variable
+	 * @param[in] x the state of every node, three values per node
+	 * @param[out] dxdt the derivatives, the same size as x
+	 * @param[in] descCom the descending commands, one per node
+	 */
+	virtual void computeDXVars(const std::vector<double>& x,
+							   std::vector<double>& dxdt,
+							   const std::vector<double>& descCom) const;
 	
 	/**
 	 * Call the integrator a the specified timestep
 	 */
 	void update(std::vector<double>& descCom, double dt);
 	
+	/**
+	 * Write the state of every node. The stepper is reset by every
+	 * update, so this is all a restored run needs.
+	 * @param[in,out] state the state being saved
+	 */
+	void saveState(tgSimulationState& state) const;
+	
+	/**
+	 * Read back what saveState wrote, into the same nodes
+	 * @param[in,out] state the state being restored
+	 */
+	void restoreState(tgSimulationState& state);
+	
 	std::string toString(const std::string& prefix = "") const;
 	
+	/**
+	 * Choose how the phase couplings are evaluated. When batched, all
+	 * couplings are computed in one pass over flat per-coupling arrays,
+	 * and sin(phi_j - phi_i - phase) is expanded with the angle
+	 * difference identities, so only one sine and cosine per node are
+	 * taken per evaluation instead of one sine per coupling. The result
+	 * differs from the direct sum by rounding only. Off by default.
+	 */
+	void setBatchedCoupling(bool batched)
+	{
+		m_batchedCoupling = batched;
+	}
+	
+	/**
+	 * @return the number of nodes
+	 */
+	std::size_t size() const
+	{
+		return m_rConst.size();
+	}
+	
     void countStep()
     {
         numSteps++;
@@ -77,16 +134,94 @@ class CPGEquations
     
 protected:
 	
-	std::vector<CPGNode*> nodeList;
+	/**
+	 * Compute the base node equation for R and Phi
+	 */
+	double nodeEquation(double d, double c0, double c1, std::size_t i) const
+	{
+		if(d >= m_dMin[i] && d <= m_dMax[i]){
+			return c1 * d + c0;
+		}
+		else{
+			return 0;
+		}
+	}
+	
+	/**
+	 * Compute every coupling term at once if batched coupling is on,
+	 * otherwise do nothing. Must be called by computeDXVars before
+	 * couplePhase.
+	 */
+	void prepareCouplings(const std::vector<double>& x) const;
+	
+	/**
+	 * @return phiDot plus the phase coupling terms of node i
+	 */
+	double couplePhase(const std::vector<double>& x, std::size_t i, double phiDot) const;
+	
+	/**
+	 * The state of every node, three values per node
+	 */
+	std::vector<double> XVars;
+	
+	/**
+	 * Parameters for node equations, one entry per node
+	 */
+	std::vector<double> m_frequencyOffset;
+	std::vector<double> m_frequencyScale;
+	std::vector<double> m_radiusOffset;
+	std::vector<double> m_radiusScale;
+	std::vector<double> m_rConst;
+	std::vector<double> m_dMin;
+	std::vector<double> m_dMax;
+	
+	/**
+	 * Couplings of node i are entries m_couplingStart[i] up to
+	 * m_couplingStart[i + 1] of the other coupling arrays
+	 */
+	std::vector<std::size_t> m_couplingStart;
+	std::vector<std::size_t> m_couplingNode;
+	std::vector<double> m_couplingWeight;
+	std::vector<double> m_couplingPhase;
+	
+	/**
+	 * The weight times the cosine and sine of the phase offset, for
+	 * batched coupling
+	 */
+	std::vector<double> m_couplingWeightCos;
+	std::vector<double> m_couplingWeightSin;
+	
+	bool m_batchedCoupling;
+	
+	/**
+	 * Scratch for batched coupling, sized as nodes and couplings are
+	 * added so evaluation never allocates. Per node: the sine and cosine
+	 * of the phase, each times the radius, and the summed coupling term.
+	 * Per coupling: the two partial sums of the identity.
+	 */
+	mutable std::vector<double> m_sinPhi;
+	mutable std::vector<double> m_cosPhi;
+	mutable std::vector<double> m_rSinPhi;
+	mutable std::vector<double> m_rCosPhi;
+	mutable std::vector<double> m_phaseCoupling;
+	mutable std::vector<double> m_edgeSin;
+	mutable std::vector<double> m_edgeCos;
 	
-    std::vector<double> XVars;
-    std::vector<double> DXVars;
-    
 	double stepSize;
     
     int m_maxSteps;
     int numSteps;
     
+private:
+	
+	/** Holds the integrator, so ODEInt stays out of this header */
+	struct Stepper;
+	
+	Stepper* m_pStepper;
+	
+	/** Not implemented, since the stepper is owned */
+	CPGEquations(const CPGEquations&);
+	CPGEquations& operator=(const CPGEquations&);
 };
 
 /**
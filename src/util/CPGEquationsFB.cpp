@@ -26,30 +26,16 @@
 
 #include "CPGEquationsFB.h"
 
-#include "core/tgCast.h"
-
-#include "boost/array.hpp"
-#include "boost/numeric/odeint.hpp"
-
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
 #include <assert.h>
-#include <stdexcept>
-#include <iterator> 
-
-using namespace boost::numeric::odeint;
-
-typedef std::vector<double > cpgVars_type;
+#include <math.h>
 
 CPGEquationsFB::CPGEquationsFB(int maxSteps) :
 CPGEquations(maxSteps)
  {}
-CPGEquationsFB::CPGEquationsFB(std::vector<CPGNode*>& newNodeList, int maxSteps) :
-CPGEquations(newNodeList, maxSteps)
-{
-}
 
 CPGEquationsFB::~CPGEquationsFB()
 {
@@ -58,73 +44,47 @@ CPGEquationsFB::~CPGEquationsFB()
 
 int CPGEquationsFB::addNode(std::vector<double>& newParams) 
 {
-	int index = nodeList.size();
-	CPGNodeFB* newNode = new CPGNodeFB(index, newParams);
-	nodeList.push_back(newNode);
-	
-	return index;
-}
-
-std::vector<double>& CPGEquationsFB::getXVars() {
-#ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquationsFB:getXVars");
-#endif //BT_NO_PROFILE
-    XVars.clear();
+	//Precondition
+	assert(newParams.size() >= 11);
 	
-	for (int i = 0; i != nodeList.size(); i++){
-		CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
-        assert(currentNode);
-		XVars.push_back(currentNode->phiValue);
-		XVars.push_back(currentNode->rValue);
-		XVars.push_back(currentNode->omega);
-	}
+	int index = CPGEquations::addNode(newParams);
 	
-	return XVars;
-}
-
-std::vector<double>& CPGEquationsFB::getDXVars() {
-#ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquationsFB:getDXVars");
-#endif //BT_NO_PROFILE
-	DXVars.clear();
+	XVars[3*index+1] = sqrt(newParams[2]); // Jumpstart integration
+	XVars[3*index+2] = newParams[7];
 	
-	for (int i = 0; i != nodeList.size(); i++){
-		CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
-		DXVars.push_back(currentNode->phiDotValue);
-		DXVars.push_back(currentNode->rDotValue);
-		DXVars.push_back(currentNode->omegaDot);
-	}
+	m_kFreq.push_back(newParams[8]);
+	m_kAmp.push_back(newParams[9]);
+	m_kPhase.push_back(newParams[10]);
 	
-	return DXVars;
+	return index;
 }
 
-void CPGEquationsFB::updateNodes(std::vector<double>& descCom)
+void CPGEquationsFB::computeDXVars(const std::vector<double>& x,
+								   std::vector<double>& dxdt,
+								   const std::vector<double>& descCom) const
 {
 #ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquationsFB:updateNodes");
+    BT_PROFILE("CPGEquationsFB::computeDXVars");
 #endif //BT_NO_PROFILE
-	std::vector<double>::iterator comIt = descCom.begin();
+	const std::size_t n = size();
+	assert(descCom.size() == n * 3);
 	
-	assert(descCom.size() == nodeList.size() * 3);
+	prepareCouplings(x);
 	
-	for(int i = 0; i != nodeList.size(); i++){
-		CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
-		std::vector<double> comGroup(comIt, comIt + 3);
-		currentNode->updateDTs(comGroup);
+	for (std::size_t i = 0; i != n; i++){
+		const double* const feedback = &descCom[3*i];
+		const double phiValue = x[3*i];
+		const double rValue = x[3*i+1];
+		const double omega = x[3*i+2];
 		
-		comIt += 3;
-	}
-}
-
-void CPGEquationsFB::updateNodeData(std::vector<double> newXVals)
-{
-#ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquationsFB::updateNodeData");
-#endif //BT_NO_PROFILE 
-	assert(newXVals.size()==3*nodeList.size());
-	
-	for(int i = 0; i!=nodeList.size(); i++){
-		CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
-		currentNode->updateNodeValues(newXVals[3*i], newXVals[3*i+1], newXVals[3*i+2]);
+		const double phiDotValue = couplePhase(x, i, omega + m_kPhase[i] * feedback[2]);
+		
+		const double omegaDot = m_kFreq[i] * feedback[0] * sin(phiValue);
+		
+		const double rDotValue = m_rConst[i] * (m_radiusOffset[i] + m_kAmp[i] * feedback[1] - pow(rValue, 2.0)) * rValue;
+		
+		dxdt[3*i] = phiDotValue;
+		dxdt[3*i+1] = rDotValue;
+		dxdt[3*i+2] = omegaDot;
 	}
 }
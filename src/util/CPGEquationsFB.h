@@ -29,9 +29,6 @@
 
 #include "util/CPGEquations.h"
 
-#include "CPGNodeFB.h"
-
-
 #include <vector>
 #include <assert.h>
 #include <sstream>
@@ -40,26 +37,43 @@
 /**
  * The top level class for interfacing with CPGs. Contains the definition
  * of the CPG (list of nodes) as well as functions to interface with ODEInt
+ *
+ * The state of each node is its phase, radius and frequency, and each
+ * node takes three feedback commands.
  */
 class CPGEquationsFB : public CPGEquations
 {
  public:
 	
 	CPGEquationsFB(int maxSteps = 200);
-
-	CPGEquationsFB(std::vector<CPGNode*>& newNodeList, int maxSteps = 200);
 	
 	~CPGEquationsFB();
 	
-    int addNode(std::vector<double>& newParams);
-    
-	std::vector<double>& getXVars();
+	/**
+	 * Add a node whose radius starts at the square root of its radius
+	 * offset, so integration does not stall at zero
+	 * @param[in] newParams the seven CPGEquations parameters, then the
+	 * initial frequency, kFreq, kAmp and kPhase
+	 * @return the index of the new node
+	 */
+	int addNode(std::vector<double>& newParams);
 	
-	std::vector<double>& getDXVars();
-	
-	void updateNodes(std::vector<double>& descCom);
+	/**
+	 * @param[in] descCom three feedback values per node, for frequency,
+	 * amplitude and phase
+	 */
+	void computeDXVars(const std::vector<double>& x,
+					   std::vector<double>& dxdt,
+					   const std::vector<double>& descCom) const;
+
+protected:
 	
-	void updateNodeData(std::vector<double> newXVals);
+	/**
+	 * Feedback gains, one entry per node
+	 */
+	std::vector<double> m_kFreq;
+	std::vector<double> m_kAmp;
+	std::vector<double> m_kPhase;
 
 };
 
@@ -27,6 +27,10 @@
 // C++ Standard Library
 #include <iostream>
 #include <stdexcept>
+// POSIX
+#include <sys/stat.h>
+// Boost
+#include <boost/thread/mutex.hpp>
 // NTRT Core and tgCreator Libraries
 #include "core/tgBasicActuator.h"
 #include "core/tgKinematicActuator.h"
@@ -42,6 +46,29 @@
 #include "tgcreator/tgSphereInfo.h"
 #include "tgcreator/tgStructureInfo.h"
 
+namespace
+{
+    /**
+     * Returns the modification time of the file at path, or 0 if it can't be read.
+     */
+    time_t modificationTime(const std::string& path) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            return 0;
+        }
+        return info.st_mtime;
+    }
+
+    /**
+     * Converts a builder parameter's value as yaml-cpp converts a parsed
+     * one. The node is made here, so no node is shared between threads.
+     */
+    template <typename T>
+    T parameterValue(const std::pair<std::string, std::string>& parameter) {
+        return YAML::Node(parameter.second).as<T>();
+    }
+}
+
 /**
  * Constructor that only takes the path to the YAML file.
  */
@@ -83,19 +110,17 @@ void TensegrityModel::trace(const tgStructure& structure,
  * calling the tgStructureInfo to build the structure into the world.
  */
 void TensegrityModel::setup(tgWorld& world) {
+    // the YAML files are only read again if they have changed since the last setup
+    boost::shared_ptr<const ParsedModel> parsed = getParsedModel(topLvlStructurePath);
+
     // create the build spec that uses tags to turn the structure into a model
     tgBuildSpec spec;
+    for (std::size_t i = 0; i < parsed->builders.size(); i++) {
+        addBuilder(parsed->builders[i], spec);
+    }
 
-    // add default builders (rods, strings, boxes) that match the tags (rods, strings, boxes, spheres)
-    // (these will be overwritten if a different builder is specified for those tags)
-    Yam emptyYam = Yam();
-    addRodBuilder("tgRodInfo", "rod", emptyYam, spec);
-    addBasicActuatorBuilder("tgBasicActuatorInfo", "string", emptyYam, spec);
-    addBoxBuilder("tgBoxInfo", "box", emptyYam, spec);
-    addSphereBuilder("tgSphereInfo", "sphere", emptyYam, spec);
-
-    tgStructure structure;
-    buildStructure(structure, topLvlStructurePath, spec);
+    // the parsed structure is shared, so build from a copy of it
+    tgStructure structure(parsed->structure);
 
     tgStructureInfo structureInfo(structure, spec);
     structureInfo.buildInto(*this, world);
@@ -115,7 +140,57 @@ void TensegrityModel::setup(tgWorld& world) {
     tgModel::setup(world);
 }
 
-void TensegrityModel::addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& children) {
+boost::shared_ptr<const TensegrityModel::ParsedModel> TensegrityModel::getParsedModel(const std::string& structurePath) {
+    static boost::mutex cacheMutex;
+    static std::map<std::string, boost::shared_ptr<const ParsedModel> > cache;
+
+    // parsing happens under the lock too, so each file is only parsed once
+    // when many simulations set up at the same time
+    boost::mutex::scoped_lock lock(cacheMutex);
+
+    std::map<std::string, boost::shared_ptr<const ParsedModel> >::const_iterator cached = cache.find(structurePath);
+    if (cached != cache.end()) {
+        const std::vector< std::pair<std::string, time_t> >& files = cached->second->files;
+        bool modified = false;
+        for (std::size_t i = 0; i < files.size() && !modified; i++) {
+            modified = modificationTime(files[i].first) != files[i].second;
+        }
+        if (!modified) {
+            return cached->second;
+        }
+    }
+
+    boost::shared_ptr<const ParsedModel> parsed = parseModel(structurePath);
+    cache[structurePath] = parsed;
+    return parsed;
+}
+
+boost::shared_ptr<const TensegrityModel::ParsedModel> TensegrityModel::parseModel(const std::string& structurePath) {
+    boost::shared_ptr<ParsedModel> parsed(new ParsedModel());
+
+    // bonds need to know which pairs are rigid while the files are read,
+    // so fill a build spec alongside the builder descriptions
+    tgBuildSpec spec;
+
+    // add default builders (rods, strings, boxes) that match the tags (rods, strings, boxes, spheres)
+    // (these will be overwritten if a different builder is specified for those tags)
+    const BuilderDescription defaultBuilders[] = {
+        {"tgRodInfo", "rod", BuilderParameters()},
+        {"tgBasicActuatorInfo", "string", BuilderParameters()},
+        {"tgBoxInfo", "box", BuilderParameters()},
+        {"tgSphereInfo", "sphere", BuilderParameters()}
+    };
+    for (std::size_t i = 0; i < sizeof(defaultBuilders) / sizeof(BuilderDescription); i++) {
+        parsed->builders.push_back(defaultBuilders[i]);
+        addBuilder(defaultBuilders[i], spec);
+    }
+
+    buildStructure(parsed->structure, structurePath, spec, *parsed);
+    return parsed;
+}
+
+void TensegrityModel::addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec,
+    const Yam& children, ParsedModel& parsed) {
     if (!children) return;
     std::string structureAttributeKeys[] = {"path", "rotation", "translation", "scale", "offset"};
     std::vector<std::string> structureAttributeKeysVector(structureAttributeKeys, structureAttributeKeys + sizeof(structureAttributeKeys) / sizeof(std::string));
@@ -129,7 +204,7 @@ void TensegrityModel::addChildren(tgStructure& structure, const std::string& str
         std::string childCombos = child->first.as<std::string>() + "/";
         while (childCombos.find("/") != std::string::npos) {
             std::string childName = childCombos.substr(0, childCombos.find("/"));
-            addChild(structure, structurePath, childName, childAttributes["path"], spec);
+            addChild(structure, structurePath, childName, childAttributes["path"], spec, parsed);
             childCombos = childCombos.substr(childCombos.find("/") + 1);
         }
     }
@@ -168,7 +243,7 @@ void TensegrityModel::addChildren(tgStructure& structure, const std::string& str
 }
 
 void TensegrityModel::addChild(tgStructure& structure, const std::string &parentPath,
-    const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec) {
+    const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec, ParsedModel& parsed) {
 
     if (!childStructurePath) return;
     std::string childPath = childStructurePath.as<std::string>();
@@ -177,7 +252,7 @@ void TensegrityModel::addChild(tgStructure& structure, const std::string &parent
         childPath = parentPath.substr(0, parentPath.rfind("/") + 1) + childPath;
     }
     tgStructure childStructure = tgStructure(childName);
-    buildStructure(childStructure, childPath, spec);
+    buildStructure(childStructure, childPath, spec, parsed);
     structure.addChild(childStructure);
 }
 
@@ -233,7 +308,11 @@ void TensegrityModel::addChildTranslation(tgStructure& childStructure, const Yam
     childStructure.move(translationVector);
 }
 
-void TensegrityModel::buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec) {
+void TensegrityModel::buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec,
+    ParsedModel& parsed) {
+    // take the time before reading, so a change made while reading is seen next time
+    parsed.files.push_back(std::make_pair(structurePath, modificationTime(structurePath)));
+
     /** 
      * This call to YAML::LoadFile can return the exception YAML::BadFile 
      * if any of the yaml files or substructure files cannot be found. 
@@ -263,8 +342,8 @@ void TensegrityModel::buildStructure(tgStructure& structure, const std::string&
     yamlContainsOnly(root, structurePath, rootKeysVector);
     yamlNoDuplicates(root, structurePath);
 
-    addChildren(structure, structurePath, spec, root["substructures"]);
-    addBuilders(spec, root["builders"]);
+    addChildren(structure, structurePath, spec, root["substructures"], parsed);
+    addBuilders(spec, root["builders"], parsed);
     addNodes(structure, root["nodes"]);
     addPairGroups(structure, root["pair_groups"]);
     addBondGroups(structure, root["bond_groups"], spec);
@@ -596,36 +675,57 @@ tgStructure& TensegrityModel::getStructure(tgStructure& parentStructure, const s
     }
 }
 
-void TensegrityModel::addBuilders(tgBuildSpec& spec, const Yam& builders) {
+void TensegrityModel::addBuilders(tgBuildSpec& spec, const Yam& builders, ParsedModel& parsed) {
     for (YAML::const_iterator builder = builders.begin(); builder != builders.end(); ++builder) {
         std::string tagMatch = builder->first.as<std::string>();
         if (!builder->second["class"]) throw std::invalid_argument("Builder class not supplied for tag: " + tagMatch);
-        std::string builderClass = builder->second["class"].as<std::string>();
-        Yam parameters = builder->second["parameters"];
-
-        if (builderClass == "tgRodInfo") {
-            addRodBuilder(builderClass, tagMatch, parameters, spec);
-        }
-        else if (builderClass == "tgBasicActuatorInfo" || builderClass == "tgBasicContactCableInfo") {
-            addBasicActuatorBuilder(builderClass, tagMatch, parameters, spec);
-        }
-        else if (builderClass == "tgKinematicContactCableInfo" || builderClass == "tgKinematicActuatorInfo") {
-            addKinematicActuatorBuilder(builderClass, tagMatch, parameters, spec);
-        }
-	else if (builderClass == "tgBoxInfo") {
-            addBoxBuilder(builderClass, tagMatch, parameters, spec);
-        }
-	else if (builderClass == "tgSphereInfo") {
-	    addSphereBuilder(builderClass, tagMatch, parameters, spec);
-	}
-        // add more builders here if they use a different Config
-        else {
-            throw std::invalid_argument("Unsupported builder class: " + builderClass);
+        BuilderDescription description;
+        description.builderClass = builder->second["class"].as<std::string>();
+        description.tagMatch = tagMatch;
+        const Yam& parameters = builder->second["parameters"];
+        if (parameters) {
+            // copy the values out, since the builders are read again by every setup
+            for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+                std::string parameterName = parameter->first.as<std::string>();
+                if (!parameter->second.IsScalar()) {
+                    throw std::invalid_argument("Builder parameter is not a single value: " + parameterName);
+                }
+                description.parameters.push_back(std::make_pair(parameterName, parameter->second.Scalar()));
+            }
         }
+
+        addBuilder(description, spec);
+        parsed.builders.push_back(description);
+    }
+}
+
+void TensegrityModel::addBuilder(const BuilderDescription& builder, tgBuildSpec& spec) {
+    const std::string& builderClass = builder.builderClass;
+    const std::string& tagMatch = builder.tagMatch;
+    const BuilderParameters& parameters = builder.parameters;
+
+    if (builderClass == "tgRodInfo") {
+        addRodBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgBasicActuatorInfo" || builderClass == "tgBasicContactCableInfo") {
+        addBasicActuatorBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgKinematicContactCableInfo" || builderClass == "tgKinematicActuatorInfo") {
+        addKinematicActuatorBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgBoxInfo") {
+        addBoxBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgSphereInfo") {
+        addSphereBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    // add more builders here if they use a different Config
+    else {
+        throw std::invalid_argument("Unsupported builder class: " + builderClass);
     }
 }
 
-void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec) {
+void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec) {
     // rodParameters
     std::map<std::string, double> rp;
     rp["radius"] = rodRadius;
@@ -634,14 +734,14 @@ void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::
     rp["roll_friction"] = rodRollFriction;
     rp["restitution"] = rodRestitution;
 
-    if (parameters) {
-        for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
-            std::string parameterName = parameter->first.as<std::string>();
+    if (!parameters.empty()) {
+        for (BuilderParameters::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+            const std::string& parameterName = parameter->first;
             if (rp.find(parameterName) == rp.end()) {
                 throw std::invalid_argument("Unsupported " + builderClass + " parameter: " + parameterName);
             }
             // if defined overwrite default parameter value
-            rp[parameterName] = parameter->second.as<double>();
+            rp[parameterName] = parameterValue<double>(*parameter);
         }
     }
 
@@ -654,7 +754,7 @@ void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::
     // add more builders that use tgRod::Config here
 }
 
-void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec) {
+void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec) {
     // tgbBasicActuator parameters.
     // This method assigns default values based on TensegrityModel.h,
     // then overwrites them if a parameter is specified in the YAML file.
@@ -677,11 +777,11 @@ void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, c
     bap_booleans["moveCablePointBToEdge"] = stringMoveCablePointBToEdge;
 
     // If no parameters are passed in, do not change anything.
-    if (parameters) {
+    if (!parameters.empty()) {
         // Iterate through all the parameters passed in for this builder.
-        for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+        for (BuilderParameters::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
 	    // The key for both maps is a string.
-	    std::string parameterName = parameter->first.as<std::string>();
+	    const std::string& parameterName = parameter->first;
 	    // However, the value may be either a double or a boolean. Check both
 	    // lists, and mark a flag depending on the output.
 	    bool paramIsDouble = true;
@@ -698,11 +798,11 @@ void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, c
             // if defined, overwrite default parameter value to the appropriate map.
 	    if( paramIsDouble ) {
 	      // change the value in the doubles list
-	      bap_doubles[parameterName] = parameter->second.as<double>();
+	      bap_doubles[parameterName] = parameterValue<double>(*parameter);
 	    }
 	    else {
 	      // the value is in the booleans list.
-	      bap_booleans[parameterName] = parameter->second.as<bool>();
+	      bap_booleans[parameterName] = parameterValue<bool>(*parameter);
 	    }
         }
     }
@@ -735,7 +835,7 @@ void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, c
     // add more builders that use tgBasicActuator::Config here
 }
 
-void TensegrityModel::addKinematicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec) {
+void TensegrityModel::addKinematicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec) {
     // kinematicActuatorParameters
     std::map<std::string, double> kap;
     kap["stiffness"] = stringStiffness;
@@ -752,14 +852,14 @@ void TensegrityModel::addKinematicActuatorBuilder(const std::string& builderClas
     kap["min_rest_length"] = stringMinRestLength;
     kap["rotation"] = stringRotation;
 
-    if (parameters) {
-        for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
-            std::string parameterName = parameter->first.as<std::string>();
+    if (!parameters.empty()) {
+        for (BuilderParameters::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+            const std::string& parameterName = parameter->first;
             if (kap.find(parameterName) == kap.end()) {
                 throw std::invalid_argument("Unsupported " + builderClass + " parameter: " + parameterName);
             }
             // if defined overwrite default parameter value
-            kap[parameterName] = parameter->second.as<double>();
+            kap[parameterName] = parameterValue<double>(*parameter);
         }
     }
 
@@ -778,7 +878,7 @@ void TensegrityModel::addKinematicActuatorBuilder(const std::string& builderClas
     // add more builders that use tgKinematicActuator::Config here
 }
 
-void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec) {
+void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec) {
     /**
      * Builder procedure: 
      * (1) create a list (a map, really) of all the possible parameters, and initialize
@@ -803,14 +903,14 @@ void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::
     bp["roll_friction"] = boxRollFriction;
     bp["restitution"] = boxRestitution;
     
-    if (parameters) {
-        for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
-            std::string parameterName = parameter->first.as<std::string>();
+    if (!parameters.empty()) {
+        for (BuilderParameters::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+            const std::string& parameterName = parameter->first;
             if (bp.find(parameterName) == bp.end()) {
                 throw std::invalid_argument("Unsupported " + builderClass + " parameter: " + parameterName);
             }
             // if defined overwrite default parameter value
-            bp[parameterName] = parameter->second.as<double>();
+            bp[parameterName] = parameterValue<double>(*parameter);
         }
     }
 
@@ -824,7 +924,7 @@ void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::
     }
 }
 
-void TensegrityModel::addSphereBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec){
+void TensegrityModel::addSphereBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec){
   /**
    * Builder prcedure:
    * (1) create list of all possible parameters, as with box (for example)
@@ -848,14 +948,14 @@ void TensegrityModel::addSphereBuilder(const std::string& builderClass, const st
   sp["restitution"] = sphereRestitution;
 
   // (2) sub in the new stuff if any exists
-  if (parameters) {
-    for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
-      std::string parameterName = parameter->first.as<std::string>();
+  if (!parameters.empty()) {
+    for (BuilderParameters::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+      const std::string& parameterName = parameter->first;
       if (sp.find(parameterName) == sp.end()) {
 	throw std::invalid_argument("Unsupported " + builderClass + " parameter: " + parameterName);
       }
       // if defined overwrite default parameter value
-      sp[parameterName] = parameter->second.as<double>();
+      sp[parameterName] = parameterValue<double>(*parameter);
     }
   }
 
@@ -914,6 +1014,16 @@ void TensegrityModel::step(double timeStep) {
     }
 }
 
+void TensegrityModel::saveState(tgSimulationState& state) {
+    notifySaveState(state);
+    tgModel::saveState(state);
+}
+
+void TensegrityModel::restoreState(tgSimulationState& state) {
+    notifyRestoreState(state);
+    tgModel::restoreState(state);
+}
+
 void TensegrityModel::onVisit(tgModelVisitor& visitor) {
     tgModel::onVisit(visitor);
 }
@@ -28,8 +28,10 @@
  */
 
 // C++ Standard Library
+#include <ctime>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 // NTRT Core and tgCreator Libraries
 #include "core/tgModel.h"
@@ -39,11 +41,13 @@
 // Bullet Physics library
 #include "LinearMath/btVector3.h"
 // Helper libraries
+#include <boost/shared_ptr.hpp>
 #include <yaml-cpp/yaml.h>
 
 // Forward declarations
 class tgSpringCableActuator;
 class tgModelVisitor;
+class tgSimulationState;
 class tgWorld;
 class tgStructureInfo;
 
@@ -240,6 +244,18 @@ public:
      */
     virtual void step(double timeStep);
 
+    /**
+     * Save the state of the controllers, then of the children.
+     * @param[in,out] state the state being saved
+     */
+    virtual void saveState(tgSimulationState& state);
+
+    /**
+     * Restore what saveState saved. Notifies controllers of the restore.
+     * @param[in,out] state the state being restored
+     */
+    virtual void restoreState(tgSimulationState& state);
+
     /**
      * Receives a tgModelVisitor and dispatches itself into the
      * visitor's 'render' function. This model will go to the default
@@ -256,22 +272,72 @@ public:
     const std::vector<tgSpringCableActuator*>& getAllActuators() const;
 
 private:
+    /**
+     * The parameters of a builder, each a name and its value as written
+     * in the YAML file, in the order they were written.
+     */
+    typedef std::vector< std::pair<std::string, std::string> > BuilderParameters;
+
+    /**
+     * A builder as it appears in a YAML file. Kept so that each setup
+     * can fill a new tgBuildSpec without reading the file again. Holds
+     * no YAML nodes, since yaml-cpp does not allow reading a node from
+     * several threads at once, even a const one.
+     */
+    struct BuilderDescription
+    {
+        std::string builderClass;
+        std::string tagMatch;
+        BuilderParameters parameters;
+    };
+
+    /**
+     * Everything read from a structure file and its substructure files.
+     * Shared between models and never changed once parsed.
+     */
+    struct ParsedModel
+    {
+        tgStructure structure;
+        /*
+         * In the order they were read, since a later builder for a tag
+         * replaces an earlier one.
+         */
+        std::vector<BuilderDescription> builders;
+        /*
+         * Every file read, with its modification time when it was read.
+         */
+        std::vector< std::pair<std::string, time_t> > files;
+    };
+
     /**
      * A list of all of the spring cable actuators.
      */
     std::vector<tgSpringCableActuator*> allActuators;
 
+    /*
+     * Returns the parsed form of the structure file at structurePath. Files are only parsed
+     * the first time they are used, or again if any file they include has been modified since.
+     * Safe to call from several simulations at once.
+     */
+    boost::shared_ptr<const ParsedModel> getParsedModel(const std::string& structurePath);
+
+    /*
+     * Reads and parses the structure file at structurePath and all of its substructures.
+     */
+    boost::shared_ptr<const ParsedModel> parseModel(const std::string& structurePath);
+
     /*
      * Responsible for adding all the children defined in a structure file, and apply their
      * rotation, scale, offset and translation attributes.
      */
-    void addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& substructures);
+    void addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec,
+        const Yam& substructures, ParsedModel& parsed);
 
     /*
      * Responsible for adding the child structure defined in the file childStructurePath.
      */
     void addChild(tgStructure& structure, const std::string& parentPath,
-        const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec);
+        const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec, ParsedModel& parsed);
 
     /*
      * Responsible for applying any rotation attributes for a child structure.
@@ -297,7 +363,7 @@ private:
     /*
      * Responsible for building a structure. This includes adding children, builders, nodes, pairs and bonds.
      */
-    void buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec);
+    void buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, ParsedModel& parsed);
 
     /*
      * Responsible for adding nodes to the structure.
@@ -377,34 +443,39 @@ private:
     tgStructure& getStructure(tgStructure& parentStructure, const std::string& structurePath);
 
     /*
-     * Responsible for adding any builders to the build spec
+     * Responsible for adding any builders to the build spec, and recording them in parsed
+     */
+    void addBuilders(tgBuildSpec& spec, const Yam& builders, ParsedModel& parsed);
+
+    /*
+     * Responsible for adding a builder of any supported class to the build spec
      */
-    void addBuilders(tgBuildSpec& spec, const Yam& builders);
+    void addBuilder(const BuilderDescription& builder, tgBuildSpec& spec);
 
     /*
      * Responsible for adding a builder that uses the tgRod config
      */
-    void addRodBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+    void addRodBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec);
 
     /*
      * Responsible for adding a builder that uses the tgBasicActuator config
      */
-    void addBasicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+    void addBasicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec);
 
     /*
      * Responsible for adding a builder that uses the tgKinematicActuator config
      */
-    void addKinematicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+    void addKinematicActuatorBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec);
 
     /*
      * Responsible for adding a builder that uses the tgBox config
      */
-    void addBoxBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+    void addBoxBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec);
 
     /*
      * Responsible for adding a builder that uses the tgSphere config
      */
-    void addSphereBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+    void addSphereBuilder(const std::string& builderClass, const std::string& tagMatch, const BuilderParameters& parameters, tgBuildSpec& spec);
 
     /*
      * Ensures YAML node contains only keys from the supplied vector
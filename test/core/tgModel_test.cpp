@@ -0,0 +1,153 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgModel_test.cpp
+* @brief Checks that the index behind tgModel::findCached follows changes
+* anywhere below the model that owns it
+* $Id$
+*/
+
+// This application
+#include "core/tgModel.h"
+#include "core/tgTags.h"
+// The C++ Standard Library
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** A model with no children of its own, found by type */
+	class Leaf : public tgModel
+	{
+	public:
+		Leaf(const tgTags& tags = tgTags()) :
+			tgModel(tags)
+		{
+		}
+	};
+
+	/** A model that holds other models */
+	class Branch : public tgModel
+	{
+	};
+
+	class tgModelTest : public ::testing::Test {
+		protected:
+
+			tgModelTest() {
+
+			}
+
+			virtual ~tgModelTest() {
+			}
+	};
+
+	TEST_F(tgModelTest, FindCachedSeesAddedChild) {
+		tgModel root;
+		Leaf* a = new Leaf();
+		root.addChild(a);
+
+		ASSERT_EQ(1u, root.findCached<Leaf>().size());
+		// Asked again, the same view is returned
+		EXPECT_EQ(&root.findCached<Leaf>(), &root.findCached<Leaf>());
+
+		Leaf* b = new Leaf();
+		root.addChild(b);
+
+		const vector<Leaf*>& leaves = root.findCached<Leaf>();
+		ASSERT_EQ(2u, leaves.size());
+		EXPECT_EQ(a, leaves[0]);
+		EXPECT_EQ(b, leaves[1]);
+
+		root.teardown();
+	}
+
+	TEST_F(tgModelTest, FindCachedSeesGrandchildren) {
+		tgModel root;
+		Branch* branch = new Branch();
+		root.addChild(branch);
+
+		EXPECT_TRUE(root.findCached<Leaf>().empty());
+		EXPECT_TRUE(root.findCached<Leaf>("rod").empty());
+		EXPECT_TRUE(branch->findCached<Leaf>().empty());
+
+		// Added below the child, so the root is not told directly
+		Leaf* rod = new Leaf(tgTags("rod"));
+		branch->addChild(rod);
+
+		ASSERT_EQ(1u, root.findCached<Leaf>().size());
+		EXPECT_EQ(rod, root.findCached<Leaf>()[0]);
+		ASSERT_EQ(1u, root.findCached<Leaf>("rod").size());
+		EXPECT_EQ(rod, root.findCached<Leaf>("rod")[0]);
+		EXPECT_EQ(1u, branch->findCached<Leaf>().size());
+
+		// Another level down
+		Branch* twig = new Branch();
+		branch->addChild(twig);
+		twig->addChild(new Leaf(tgTags("muscle")));
+
+		EXPECT_EQ(2u, root.findCached<Leaf>().size());
+		EXPECT_EQ(1u, root.findCached<Leaf>("rod").size());
+		EXPECT_EQ(1u, root.findCached<Leaf>("muscle").size());
+		EXPECT_EQ(2u, root.findCached<Branch>().size());
+
+		root.teardown();
+	}
+
+	TEST_F(tgModelTest, FindCachedSeesRemovedDescendants) {
+		tgModel root;
+		Branch* branch = new Branch();
+		root.addChild(branch);
+		branch->addChild(new Leaf(tgTags("rod")));
+		branch->addChild(new Leaf(tgTags("rod")));
+		root.addChild(new Leaf(tgTags("rod")));
+
+		EXPECT_EQ(3u, root.findCached<Leaf>().size());
+		EXPECT_EQ(3u, root.findCached<Leaf>("rod").size());
+		EXPECT_EQ(4u, root.getDescendants().size());
+
+		// Removes the branch's children, but not the branch
+		branch->teardown();
+
+		EXPECT_EQ(1u, root.findCached<Leaf>().size());
+		EXPECT_EQ(1u, root.findCached<Leaf>("rod").size());
+		EXPECT_EQ(1u, root.findCached<Branch>().size());
+		EXPECT_EQ(2u, root.getDescendants().size());
+		EXPECT_TRUE(branch->findCached<Leaf>().empty());
+
+		// Children can be added again after a teardown
+		branch->addChild(new Leaf());
+		EXPECT_EQ(2u, root.findCached<Leaf>().size());
+
+		root.teardown();
+		EXPECT_TRUE(root.findCached<Leaf>().empty());
+		EXPECT_TRUE(root.findCached<Leaf>("rod").empty());
+		EXPECT_TRUE(root.getDescendants().empty());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgRandomStream_test.cpp
+* @brief Checks that tgRandomStream gives the same numbers for the same
+* seed and substream, whatever else has been drawn
+* $Id$
+*/
+
+// This application
+#include "core/tgRandomStream.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	class tgRandomStreamTest : public ::testing::Test {
+		protected:
+			
+			tgRandomStreamTest() {
+					
+			}
+			
+			virtual ~tgRandomStreamTest() {
+			}
+	};
+
+	TEST_F(tgRandomStreamTest, SameSeedSameNumbers) {
+		tgRandomStream a(42);
+		tgRandomStream b(42);
+		tgRandomStream c(43);
+		
+		int differences = 0;
+		for (int i = 0; i < 1000; i++)
+		{
+			const tgRandomStream::result_type x = a();
+			EXPECT_EQ(x, b());
+			if (x != c())
+			{
+				differences++;
+			}
+		}
+		EXPECT_EQ(1000, differences);
+	}
+	
+	TEST_F(tgRandomStreamTest, SubstreamsIgnoreCounter) {
+		tgRandomStream run(7);
+		const tgRandomStream before = run.substream(3);
+		
+		// As a worker might, in any order
+		for (int i = 0; i < 100; i++)
+		{
+			run();
+		}
+		tgRandomStream after = run.substream(3);
+		tgRandomStream first = before;
+		for (int i = 0; i < 100; i++)
+		{
+			EXPECT_EQ(first(), after());
+		}
+		
+		tgRandomStream other = run.substream(4);
+		tgRandomStream same = run.substream(3);
+		EXPECT_NE(same(), other());
+	}
+	
+	TEST_F(tgRandomStreamTest, Distributions) {
+		tgRandomStream random(1);
+		const int n = 100000;
+		
+		double sum = 0.0;
+		for (int i = 0; i < n; i++)
+		{
+			const double u = random.uniform();
+			ASSERT_GE(u, 0.0);
+			ASSERT_LT(u, 1.0);
+			sum += u;
+		}
+		EXPECT_NEAR(0.5, sum / n, 0.01);
+		
+		std::vector<int> counts(10, 0);
+		for (int i = 0; i < n; i++)
+		{
+			const std::size_t k = random.index(counts.size());
+			ASSERT_LT(k, counts.size());
+			counts[k]++;
+		}
+		for (std::size_t k = 0; k < counts.size(); k++)
+		{
+			EXPECT_NEAR(n / 10, counts[k], n / 100);
+		}
+		
+		double mean = 0.0;
+		double square = 0.0;
+		for (int i = 0; i < n; i++)
+		{
+			const double x = random.normal(2.0, 3.0);
+			mean += x;
+			square += x * x;
+		}
+		mean /= n;
+		EXPECT_NEAR(2.0, mean, 0.05);
+		EXPECT_NEAR(3.0, std::sqrt(square / n - mean * mean), 0.05);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTagSearch_test.cpp
+* @brief Checks the matching of tgTagSearch against tags and taggables
+* $Id$
+*/
+
+// This application
+#include "core/tgTagSearch.h"
+#include "core/tgTaggable.h"
+#include "core/tgTags.h"
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	class tgTagSearchTest : public ::testing::Test {
+		protected:
+			
+			tgTagSearchTest() {
+					
+			}
+			
+			virtual ~tgTagSearchTest() {
+			}
+	};
+
+	TEST_F(tgTagSearchTest, MatchesAllTags) {
+		const tgTagSearch search("rod left");
+		
+		EXPECT_TRUE(search.matches(tgTags("left rod")));
+		EXPECT_TRUE(search.matches(tgTags("rod top left")));
+		EXPECT_FALSE(search.matches(tgTags("rod")));
+		EXPECT_FALSE(search.matches(tgTags("muscle left")));
+		
+		const tgTaggable taggable("left rod");
+		EXPECT_TRUE(search.matches(taggable));
+		
+		// An empty search matches everything
+		EXPECT_TRUE(tgTagSearch("").matches(tgTags("rod")));
+	}
+
+	TEST_F(tgTagSearchTest, MatchesWithParentTags) {
+		tgTagSearch search("spine rod");
+		
+		EXPECT_TRUE(search.matches(tgTags("spine"), tgTags("rod")));
+		EXPECT_TRUE(search.matches(tgTags("spine rod"), tgTags("")));
+		EXPECT_FALSE(search.matches(tgTags("leg"), tgTags("rod")));
+	}
+
+	TEST_F(tgTagSearchTest, SearchBeforeTags) {
+		// As in tgBuildSpec, the search exists before anything has the tag
+		const tgTagSearch search("tgTagSearchTestLater");
+		
+		EXPECT_TRUE(search.matches(tgTags("tgTagSearchTestLater rod")));
+	}
+
+	TEST_F(tgTagSearchTest, Remove) {
+		tgTagSearch search("rod left");
+		search.remove(tgTags("left"));
+		
+		EXPECT_TRUE(search.matches(tgTags("rod right")));
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTags_test.cpp
+* @brief Checks the matching of tgTags, and that queries for unknown tags
+* do not add them to the tag table
+* $Id$
+*/
+
+// This application
+#include "core/tgTags.h"
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+// The C++ Standard Library
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Interns the same tags as every other thread, and keeps the ids */
+	void internMany(vector<int>* ids)
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			ids->push_back(tgTags::intern("threaded" + string(1, 'a' + i % 26)));
+		}
+	}
+
+	class tgTagsTest : public ::testing::Test {
+		protected:
+			
+			tgTagsTest() {
+					
+			}
+			
+			virtual ~tgTagsTest() {
+			}
+	};
+
+	TEST_F(tgTagsTest, ContainsAndAny) {
+		tgTags tags("rod muscle left");
+		
+		EXPECT_EQ(3, tags.size());
+		EXPECT_TRUE(tags.contains("rod"));
+		EXPECT_TRUE(tags.contains("left rod"));
+		EXPECT_TRUE(tags.contains(""));
+		EXPECT_FALSE(tags.contains("rod right"));
+		
+		EXPECT_TRUE(tags.containsAny("right left"));
+		EXPECT_FALSE(tags.containsAny("right top"));
+		
+		EXPECT_TRUE(tags.contains(tgTags("muscle rod")));
+		EXPECT_FALSE(tags.contains(tgTags("muscle right")));
+		
+		// Duplicates are dropped, order is kept
+		tags.append("rod top");
+		EXPECT_EQ(4, tags.size());
+		EXPECT_EQ("top", tags[3]);
+		
+		tags.remove("muscle");
+		EXPECT_FALSE(tags.contains("muscle"));
+		EXPECT_TRUE(tags.contains("rod left top"));
+		EXPECT_EQ(3u, tags.getIds().size());
+		
+		EXPECT_TRUE(tgTags("a b") == tgTags("b a"));
+	}
+
+	TEST_F(tgTagsTest, InvalidTagsThrow) {
+		EXPECT_THROW(tgTags("rod 12"), tgTagException);
+	}
+
+	TEST_F(tgTagsTest, LookupDoesNotIntern) {
+		const string unknown = "tgTagsTestNeverHeld";
+		
+		EXPECT_EQ(-1, tgTags::lookup(unknown));
+		
+		// None of the queries may add the tag
+		tgTags tags("rod");
+		EXPECT_FALSE(tags.contains(unknown));
+		EXPECT_FALSE(tags.contains("rod " + unknown));
+		EXPECT_FALSE(tags.containsAny(unknown));
+		tags.remove(unknown);
+		EXPECT_TRUE(tags.contains("rod"));
+		
+		const vector<int> search = tgTags::lookupAll("rod " + unknown);
+		ASSERT_EQ(2u, search.size());
+		EXPECT_EQ(-1, search[0]);
+		EXPECT_FALSE(tags.contains(search));
+		
+		EXPECT_EQ(-1, tgTags::lookup(unknown));
+		
+		// Until a tgTags holds it
+		tgTags holder(unknown);
+		const int id = tgTags::lookup(unknown);
+		EXPECT_GE(id, 0);
+		EXPECT_EQ(id, tgTags::intern(unknown));
+		EXPECT_TRUE(holder.contains(tgTags::lookupAll(unknown)));
+	}
+
+	TEST_F(tgTagsTest, LookupAllSortsAndDropsDuplicates) {
+		const tgTags tags("c b a");
+		const vector<int> search = tgTags::lookupAll("a c a");
+		
+		ASSERT_EQ(2u, search.size());
+		EXPECT_LT(search[0], search[1]);
+		EXPECT_TRUE(tags.contains(search));
+		EXPECT_TRUE(tags.contains(tgTags::lookupAll("")));
+	}
+
+	TEST_F(tgTagsTest, InternFromSeveralThreads) {
+		const int nThreads = 4;
+		vector< vector<int> > ids(nThreads);
+		
+		boost::thread_group threads;
+		for (int i = 0; i < nThreads; i++)
+		{
+			threads.create_thread(boost::bind(&internMany, &ids[i]));
+		}
+		threads.join_all();
+		
+		// Every thread was given the same id for each tag
+		for (int i = 1; i < nThreads; i++)
+		{
+			EXPECT_EQ(ids[0], ids[i]);
+		}
+		EXPECT_EQ(ids[0][3], tgTags::lookup("threadedd"));
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
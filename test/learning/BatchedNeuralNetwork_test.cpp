@@ -0,0 +1,154 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file BatchedNeuralNetwork_test.cpp
+* @brief Checks that BatchedNeuralNetwork gives every pattern of a batch
+* the outputs a neuralNetwork with the same weights gives it alone
+* $Id$
+*/
+
+// This application
+#include "learning/NeuroEvolution/BatchedNeuralNetwork.h"
+#include "neuralNet/Neural Network v2/neuralNetwork.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <tr1/random>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const int numInputs = 7;
+	const int numHidden = 5;
+	const int numOutputs = 3;
+
+	/** numPatterns rows of inputs in (-1, 1), like scaled cable states */
+	vector<double> makePatterns(std::tr1::ranlux64_base_01& eng,
+								size_t numPatterns)
+	{
+		std::tr1::uniform_real<double> unif(-1.0, 1.0);
+		vector<double> patterns(numPatterns * numInputs);
+		for (size_t i = 0; i < patterns.size(); i++)
+		{
+			patterns[i] = unif(eng);
+		}
+		return patterns;
+	}
+
+	/**
+	 * Feeds each row through perCable on its own, as the controllers
+	 * did before batching, and checks the batch gave the same outputs
+	 */
+	void expectSameOutputs(neuralNetwork& perCable,
+						   const vector<double>& patterns,
+						   const double* batched)
+	{
+		const size_t numPatterns = patterns.size() / numInputs;
+		for (size_t p = 0; p < numPatterns; p++)
+		{
+			vector<double> row(patterns.begin() + p * numInputs,
+							   patterns.begin() + (p + 1) * numInputs);
+			const double* const expected = perCable.feedForwardPattern(&row[0]);
+			for (int k = 0; k < numOutputs; k++)
+			{
+				EXPECT_DOUBLE_EQ(expected[k], batched[p * numOutputs + k])
+					<< "Pattern " << p << ", output " << k;
+			}
+		}
+	}
+
+	class BatchedNeuralNetworkTest : public ::testing::Test {
+		protected:
+
+			BatchedNeuralNetworkTest() :
+				eng(1)
+			{
+
+			}
+
+			virtual ~BatchedNeuralNetworkTest() {
+			}
+
+			std::tr1::ranlux64_base_01 eng;
+	};
+
+	TEST_F(BatchedNeuralNetworkTest, MatchesPerCableNetwork) {
+
+				BatchedNeuralNetwork batched(numInputs, numHidden, numOutputs);
+				// Move the weights away from their initial grid
+				batched.mutate(&eng);
+
+				EXPECT_EQ(numInputs, batched.getNumInputs());
+				EXPECT_EQ(numOutputs, batched.getNumOutputs());
+
+				neuralNetwork perCable(numInputs, numHidden, numOutputs);
+				perCable.copyWeightFrom(&batched);
+
+				const vector<double> patterns = makePatterns(eng, 24);
+				const double* const outputs = batched.feedForwardBatch(&patterns[0], 24);
+				ASSERT_TRUE(outputs != NULL);
+				expectSameOutputs(perCable, patterns, outputs);
+
+				// The batch and per-pattern paths share the weights, so the
+				// single pattern path still gives the same answer
+				vector<double> first(patterns.begin(), patterns.begin() + numInputs);
+				const double* const alone = batched.feedForwardPattern(&first[0]);
+				for (int k = 0; k < numOutputs; k++)
+				{
+					EXPECT_DOUBLE_EQ(outputs[k], alone[k]);
+				}
+	}
+
+	TEST_F(BatchedNeuralNetworkTest, BatchSizeChanges) {
+
+				BatchedNeuralNetwork batched(numInputs, numHidden, numOutputs);
+				batched.mutate(&eng);
+
+				neuralNetwork perCable(numInputs, numHidden, numOutputs);
+				perCable.copyWeightFrom(&batched);
+
+				// The buffers grow, then are reused for smaller batches
+				const size_t sizes[] = {1, 16, 3, 16};
+				for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+				{
+					const vector<double> patterns = makePatterns(eng, sizes[i]);
+					expectSameOutputs(perCable, patterns,
+									  batched.feedForwardBatch(&patterns[0], sizes[i]));
+				}
+
+				// Mutated again, the per-cable copy is stale until copied
+				batched.mutate(&eng);
+				perCable.copyWeightFrom(&batched);
+				const vector<double> patterns = makePatterns(eng, 8);
+				expectSameOutputs(perCable, patterns,
+								  batched.feedForwardBatch(&patterns[0], 8));
+
+				EXPECT_TRUE(batched.feedForwardBatch(&patterns[0], 0) == NULL);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,180 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file EvaluationPool_test.cpp
+* @brief Contains a test of EvaluationPool, with trials that finish out
+* of order, throw, crash or exit their worker.
+* $Id$
+*/
+
+// This application
+#include "learning/BatchRunner/EvaluationPool.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+// POSIX
+#include <unistd.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const size_t numTrials = 12;
+
+	/** What a trial does besides scoring itself */
+	enum Failure
+	{
+		eNone,
+		eThrow,
+		eCrash,
+		eExit
+	};
+
+	/**
+	 * Scores trial i as (i, i * i). Earlier trials sleep longer, so
+	 * the workers report them after the later ones.
+	 */
+	class SquareTask : public EvaluationPool::Task
+	{
+	public:
+		SquareTask(size_t failingTrial = numTrials, Failure failure = eNone) :
+			m_failingTrial(failingTrial),
+			m_failure(failure),
+			m_calls(0)
+		{
+		}
+
+		vector<double> evaluate(size_t index)
+		{
+			m_calls++;
+			usleep((numTrials - index) * 2000);
+			if (index == m_failingTrial)
+			{
+				switch (m_failure)
+				{
+				case eThrow:
+					throw std::runtime_error("Trial failed");
+				case eCrash:
+					abort();
+				case eExit:
+					_exit(3);
+				default:
+					break;
+				}
+			}
+			vector<double> scores;
+			scores.push_back(index);
+			scores.push_back(index * index);
+			return scores;
+		}
+
+		/** The trials run by this copy of the task */
+		size_t calls() const
+		{
+			return m_calls;
+		}
+
+	private:
+		const size_t m_failingTrial;
+		const Failure m_failure;
+		size_t m_calls;
+	};
+
+	class EvaluationPoolTest : public ::testing::Test {
+		protected:
+
+			EvaluationPoolTest() {
+
+			}
+
+			virtual ~EvaluationPoolTest() {
+			}
+	};
+
+	TEST_F(EvaluationPoolTest, ScoresInTrialOrder) {
+
+				EvaluationPool pool(4);
+				SquareTask task;
+				const vector< vector<double> > scores = pool.evaluate(task, numTrials);
+
+				ASSERT_EQ(numTrials, scores.size());
+				for (size_t i = 0; i < numTrials; i++)
+				{
+					ASSERT_EQ(2u, scores[i].size()) << i;
+					EXPECT_EQ(i, scores[i][0]);
+					EXPECT_EQ(i * i, scores[i][1]);
+				}
+
+				// The trials ran in the workers, not here
+				EXPECT_EQ(0u, task.calls());
+
+				// One worker runs them here, with the same scores
+				EvaluationPool serial(1);
+				EXPECT_EQ(scores, serial.evaluate(task, numTrials));
+				EXPECT_EQ(numTrials, task.calls());
+
+				// More workers than trials
+				EvaluationPool wide(2 * numTrials);
+				EXPECT_EQ(scores, wide.evaluate(task, numTrials));
+	}
+
+	TEST_F(EvaluationPoolTest, ThrowingTrialFails) {
+
+				EvaluationPool pool(3);
+				SquareTask task(5, eThrow);
+				const vector< vector<double> > scores = pool.evaluate(task, numTrials);
+
+				ASSERT_EQ(numTrials, scores.size());
+				for (size_t i = 0; i < numTrials; i++)
+				{
+					EXPECT_EQ(i == 5 ? 0u : 2u, scores[i].size()) << i;
+				}
+	}
+
+	TEST_F(EvaluationPoolTest, CrashingWorker) {
+
+				EvaluationPool pool(3);
+				SquareTask task(5, eCrash);
+				EXPECT_THROW(pool.evaluate(task, numTrials), std::runtime_error);
+
+				// The other workers were stopped, and the pool still works
+				SquareTask healthy;
+				EXPECT_EQ(numTrials, pool.evaluate(healthy, numTrials).size());
+	}
+
+	TEST_F(EvaluationPoolTest, WorkerExitsNonZero) {
+
+				EvaluationPool pool(3);
+				SquareTask task(5, eExit);
+				EXPECT_THROW(pool.evaluate(task, numTrials), std::runtime_error);
+
+				SquareTask healthy;
+				EXPECT_EQ(numTrials, pool.evaluate(healthy, numTrials).size());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
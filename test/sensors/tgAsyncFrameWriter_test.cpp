@@ -0,0 +1,335 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgAsyncFrameWriter_test.cpp
+* @brief Checks that tgAsyncFrameWriter hands every frame to its sink in
+* order on the writer thread, drops or blocks when full, and reports a
+* sink that throws.
+* $Id$
+*/
+
+// This application
+#include "sensors/tgAsyncFrameWriter.h"
+// Boost
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+// The C++ Standard Library
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const size_t width = 3;
+
+	/** Frame i holds (i, -i, i / 2) */
+	void makeFrame(size_t i, double* frame)
+	{
+		frame[0] = i;
+		frame[1] = -static_cast<double>(i);
+		frame[2] = 0.5 * i;
+	}
+
+	/**
+	 * Keeps every frame it is given, and the threads it was called on.
+	 * Optionally waits for open() before returning from the first frame,
+	 * and throws from frame failAt on.
+	 */
+	class RecordingSink : public tgAsyncFrameWriter::Sink
+	{
+	public:
+		RecordingSink(bool gated = false, size_t failAt = (size_t) -1) :
+			m_gated(gated),
+			m_failAt(failAt),
+			m_entered(false),
+			m_open(false)
+		{
+		}
+
+		void writeFrame(const double* frame, size_t frameWidth)
+		{
+			threads.push_back(boost::this_thread::get_id());
+			if (frames.size() >= m_failAt)
+			{
+				throw std::runtime_error("disk full");
+			}
+			frames.push_back(vector<double>(frame, frame + frameWidth));
+			m_entered.store(true);
+			while (m_gated && !m_open.load())
+			{
+				boost::this_thread::yield();
+			}
+		}
+
+		/** Wait until the writer is inside writeFrame */
+		void waitUntilEntered() const
+		{
+			while (!m_entered.load())
+			{
+				boost::this_thread::yield();
+			}
+		}
+
+		/** Let the writer return from writeFrame */
+		void open()
+		{
+			m_open.store(true);
+		}
+
+		// Only read by the test after stop has joined the writer
+		vector< vector<double> > frames;
+		vector<boost::thread::id> threads;
+
+	private:
+		const bool m_gated;
+		const size_t m_failAt;
+		boost::atomic<bool> m_entered;
+		boost::atomic<bool> m_open;
+	};
+
+	/** Opens the sink once the test has had time to block in push */
+	void openLater(RecordingSink* sink)
+	{
+		boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+		sink->open();
+	}
+
+	/** Checks that the sink got frames first to last, as made by makeFrame */
+	void expectFrames(const RecordingSink& sink, size_t first, size_t last)
+	{
+		ASSERT_EQ(last - first, sink.frames.size());
+		for (size_t i = first; i < last; i++)
+		{
+			double expected[width];
+			makeFrame(i, expected);
+			const vector<double>& frame = sink.frames[i - first];
+			ASSERT_EQ(width, frame.size()) << i;
+			EXPECT_EQ(vector<double>(expected, expected + width), frame) << i;
+		}
+	}
+
+	class tgAsyncFrameWriterTest : public ::testing::Test {
+		protected:
+
+			tgAsyncFrameWriterTest() {
+
+			}
+
+			virtual ~tgAsyncFrameWriterTest() {
+			}
+	};
+
+	TEST_F(tgAsyncFrameWriterTest, WritesInOrderOnWriterThread) {
+
+				const size_t nFrames = 2000;
+				// Far fewer slots than frames, so the ring wraps many times
+				tgAsyncFrameWriter writer(8);
+				RecordingSink sink;
+				writer.start(sink, width);
+				EXPECT_TRUE(writer.isRunning());
+
+				double frame[width];
+				for (size_t i = 0; i < nFrames; i++)
+				{
+					makeFrame(i, frame);
+					EXPECT_TRUE(writer.push(frame));
+				}
+				writer.stop();
+				EXPECT_FALSE(writer.isRunning());
+
+				// stop drains the ring before joining
+				expectFrames(sink, 0, nFrames);
+				EXPECT_EQ(nFrames, writer.getFramesWritten());
+				EXPECT_EQ(0u, writer.getFramesDropped());
+
+				// Every frame was written by the one writer thread, not here
+				ASSERT_EQ(nFrames, sink.threads.size());
+				for (size_t i = 0; i < nFrames; i++)
+				{
+					EXPECT_NE(boost::this_thread::get_id(), sink.threads[i]) << i;
+					EXPECT_EQ(sink.threads[0], sink.threads[i]) << i;
+				}
+
+				// Stopping twice does nothing, and pushing needs a start
+				EXPECT_NO_THROW(writer.stop());
+				EXPECT_THROW(writer.push(frame), std::runtime_error);
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, DropsWhenFull) {
+
+				tgAsyncFrameWriter writer(4, tgAsyncFrameWriter::DROP);
+				RecordingSink sink(true);
+				writer.start(sink, width);
+
+				double frame[width];
+				makeFrame(0, frame);
+				ASSERT_TRUE(writer.push(frame));
+				// Frame 0 keeps its slot until the sink returns
+				sink.waitUntilEntered();
+
+				for (size_t i = 1; i < 4; i++)
+				{
+					makeFrame(i, frame);
+					EXPECT_TRUE(writer.push(frame)) << i;
+				}
+				makeFrame(4, frame);
+				EXPECT_FALSE(writer.push(frame));
+				EXPECT_EQ(1u, writer.getFramesDropped());
+				EXPECT_EQ(0u, writer.getFramesBlocked());
+
+				sink.open();
+				writer.stop();
+				expectFrames(sink, 0, 4);
+				EXPECT_EQ(4u, writer.getFramesWritten());
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, BlocksWhenFull) {
+
+				tgAsyncFrameWriter writer(2);
+				RecordingSink sink(true);
+				writer.start(sink, width);
+
+				double frame[width];
+				makeFrame(0, frame);
+				ASSERT_TRUE(writer.push(frame));
+				sink.waitUntilEntered();
+				makeFrame(1, frame);
+				ASSERT_TRUE(writer.push(frame));
+
+				// The ring is full, so this waits for the sink
+				boost::thread opener(openLater, &sink);
+				makeFrame(2, frame);
+				EXPECT_TRUE(writer.push(frame));
+				opener.join();
+
+				writer.stop();
+				expectFrames(sink, 0, 3);
+				EXPECT_EQ(0u, writer.getFramesDropped());
+				EXPECT_EQ(1u, writer.getFramesBlocked());
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, FailedSink) {
+
+				tgAsyncFrameWriter writer(2);
+				RecordingSink failing(false, 0);
+				writer.start(failing, width);
+
+				// The writer stops consuming at the first frame, so the
+				// ring fills and push must report the failure by the third
+				double frame[width];
+				bool threw = false;
+				for (size_t i = 0; i < 3 && !threw; i++)
+				{
+					makeFrame(i, frame);
+					try
+					{
+						writer.push(frame);
+					}
+					catch (const std::runtime_error& e)
+					{
+						EXPECT_NE(string::npos, string(e.what()).find("disk full"));
+						threw = true;
+					}
+				}
+				EXPECT_TRUE(threw);
+
+				// stop reports it too, but still stops the writer
+				EXPECT_THROW(writer.stop(), std::runtime_error);
+				EXPECT_FALSE(writer.isRunning());
+				EXPECT_EQ(0u, writer.getFramesWritten());
+				EXPECT_TRUE(failing.frames.empty());
+
+				// A new start clears the failure
+				RecordingSink healthy;
+				writer.start(healthy, width);
+				for (size_t i = 0; i < 10; i++)
+				{
+					makeFrame(i, frame);
+					EXPECT_TRUE(writer.push(frame));
+				}
+				EXPECT_NO_THROW(writer.stop());
+				expectFrames(healthy, 0, 10);
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, FailureAfterSomeFrames) {
+
+				tgAsyncFrameWriter writer(64);
+				RecordingSink sink(false, 5);
+				writer.start(sink, width);
+
+				double frame[width];
+				for (size_t i = 0; i < 10; i++)
+				{
+					makeFrame(i, frame);
+					try
+					{
+						writer.push(frame);
+					}
+					catch (const std::runtime_error&)
+					{
+						break;
+					}
+				}
+
+				EXPECT_THROW(writer.stop(), std::runtime_error);
+				// The frames before the failed one were written, in order
+				expectFrames(sink, 0, 5);
+				EXPECT_EQ(5u, writer.getFramesWritten());
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, DestructorSwallowsFailure) {
+
+				RecordingSink failing(false, 0);
+				double frame[width];
+				makeFrame(0, frame);
+				{
+					tgAsyncFrameWriter writer;
+					writer.start(failing, width);
+					writer.push(frame);
+					// Reported on std::cerr instead of thrown
+				}
+				EXPECT_EQ(1u, failing.threads.size());
+	}
+
+	TEST_F(tgAsyncFrameWriterTest, BadArguments) {
+
+				EXPECT_THROW(tgAsyncFrameWriter(0), std::invalid_argument);
+
+				tgAsyncFrameWriter writer;
+				RecordingSink sink;
+				EXPECT_THROW(writer.start(sink, 0), std::invalid_argument);
+				EXPECT_FALSE(writer.isRunning());
+
+				writer.start(sink, width);
+				EXPECT_THROW(writer.start(sink, width), std::runtime_error);
+				writer.stop();
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file CPGCoupling_test.cpp
+* @brief Checks that batched CPG coupling matches the direct sum, and
+* times both on a densely coupled CPG
+* $Id$
+*/
+
+// This application
+#include "util/CPGEquationsFB.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	class CPGCouplingTest : public ::testing::Test {
+		protected:
+			
+			CPGCouplingTest() {
+					
+			}
+			
+			virtual ~CPGCouplingTest() {
+			}
+			
+			/**
+			 * A feedback CPG in which every node is coupled to every
+			 * other, with parameters from a fixed seed so two calls give
+			 * the same system
+			 */
+            CPGEquationsFB* getDenseCPGSystem(int numNodes, bool batched)
+            {
+                CPGEquationsFB* pCPGSystem = new CPGEquationsFB(1000000);
+                pCPGSystem->setBatchedCoupling(batched);
+                
+                srand(1);
+                
+                std::vector<double> params (11);
+                for (int i = 0; i < numNodes; i++)
+                {
+                    for (std::size_t j = 0; j < params.size(); j++)
+                    {
+                        params[j] = 0.5 + rand() / (double) RAND_MAX;
+                    }
+                    params[4] = 5.0; // rConst
+                    pCPGSystem->addNode(params);
+                }
+                
+                for (int i = 0; i < numNodes; i++)
+                {
+                    std::vector<int> connectivityList;
+                    std::vector<double> weights;
+                    std::vector<double> phases;
+                    for (int j = 0; j < numNodes; j++)
+                    {
+                        if (j != i)
+                        {
+                            connectivityList.push_back(j);
+                            weights.push_back(0.1 * rand() / (double) RAND_MAX);
+                            phases.push_back(2.0 * M_PI * rand() / (double) RAND_MAX);
+                        }
+                    }
+                    pCPGSystem->defineConnections(i, connectivityList, weights, phases);
+                }
+                
+                return pCPGSystem;
+            }
+	};
+
+	TEST_F(CPGCouplingTest, DerivativesMatch) {
+            
+            const int numNodes = 64;
+            const int numEvaluations = 10000;
+            
+            CPGEquationsFB* direct = getDenseCPGSystem(numNodes, false);
+            CPGEquationsFB* batched = getDenseCPGSystem(numNodes, true);
+            
+            // Spread the phases and radii over a full turn
+            std::vector<double> x (3 * numNodes);
+            for (int i = 0; i < numNodes; i++)
+            {
+                x[3 * i] = 2.0 * M_PI * i / numNodes;
+                x[3 * i + 1] = 0.5 + i / (double) numNodes;
+                x[3 * i + 2] = 1.0;
+            }
+            std::vector<double> feedback (3 * numNodes, 0.1);
+            
+            std::vector<double> dxdtDirect (x.size());
+            std::vector<double> dxdtBatched (x.size());
+            
+            clock_t start = clock();
+            for (int i = 0; i < numEvaluations; i++)
+            {
+                direct->computeDXVars(x, dxdtDirect, feedback);
+            }
+            const double directSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+            
+            start = clock();
+            for (int i = 0; i < numEvaluations; i++)
+            {
+                batched->computeDXVars(x, dxdtBatched, feedback);
+            }
+            const double batchedSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+            
+            std::cout << numNodes * (numNodes - 1) << " couplings, "
+                      << numEvaluations << " evaluations: direct "
+                      << directSeconds << " s, batched "
+                      << batchedSeconds << " s" << std::endl;
+            
+            for (std::size_t i = 0; i < x.size(); i++)
+            {
+                EXPECT_NEAR(dxdtDirect[i], dxdtBatched[i], 1.0 * pow(10, -10));
+            }
+            
+            delete direct;
+            delete batched;
+	}
+
+	TEST_F(CPGCouplingTest, IntegrationMatches) {
+            
+            const int numNodes = 64;
+            const int numUpdates = 500;
+            
+            CPGEquationsFB* direct = getDenseCPGSystem(numNodes, false);
+            CPGEquationsFB* batched = getDenseCPGSystem(numNodes, true);
+            
+            std::vector<double> feedback (3 * numNodes);
+            for (int k = 0; k < numUpdates; k++)
+            {
+                for (std::size_t i = 0; i < feedback.size(); i++)
+                {
+                    feedback[i] = 0.1 * sin(0.01 * k + i);
+                }
+                direct->update(feedback, 0.01);
+                batched->update(feedback, 0.01);
+            }
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*direct)[i], (*batched)[i], 1.0 * pow(10, -7));
+            }
+            
+            delete direct;
+            delete batched;
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
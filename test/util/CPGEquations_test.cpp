@@ -25,7 +25,8 @@
 
 // This application
 #include "util/CPGEquations.h"
-#include "util/CPGNode.h"
+// This library
+#include "core/tgSimulationState.h"
 // The Bullet Physics Library
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btQuaternion.h"
@@ -172,6 +173,38 @@ namespace {
             delete m_pCPGSystem2;
 	}
 
+	TEST_F(CPGEquationsTest, testSaveRestore) {
+            
+            int numNodes = 3;
+            CPGEquations* m_pCPGSystem = getCPGSystem(numNodes);
+            
+            std::vector<double> desComs (numNodes, 0.0);
+            
+            m_pCPGSystem->update(desComs, 5.0);
+            
+            tgSimulationState state;
+            m_pCPGSystem->saveState(state);
+            
+            int numSteps = 50;
+            std::vector<double> firstRun;
+            for (int i = 0; i < numSteps; i++)
+            {
+                m_pCPGSystem->update(desComs, 0.1);
+                firstRun.push_back((*m_pCPGSystem)[i % numNodes]);
+            }
+            
+            m_pCPGSystem->restoreState(state);
+            EXPECT_TRUE(state.atEnd());
+            
+            for (int i = 0; i < numSteps; i++)
+            {
+                m_pCPGSystem->update(desComs, 0.1);
+                EXPECT_EQ(firstRun[i], (*m_pCPGSystem)[i % numNodes]);
+            }
+            
+            delete m_pCPGSystem;
+	}
+
 } // namespace
 
 int main(int argc, char **argv) {
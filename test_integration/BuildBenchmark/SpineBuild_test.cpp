@@ -0,0 +1,303 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SpineBuild_test.cpp
+* @brief Times building a long tetrahedral spine with
+* tgStructureInfo::buildInto, where grouping the rods of each segment
+* into a compound used to dominate, both serially and on every core.
+* $Id$
+*/
+
+// This application
+#include "helpers/TetraSpine.h"
+// This library
+#include "core/tgBulletSpringCableAnchor.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+
+// Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+// The C++ Standard Library
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/**
+	 * The tetrahedral spine of helpers/TetraSpine.h, built on the given
+	 * number of threads.
+	 */
+	class LongSpineModel : public tgModel
+	{
+	public:
+
+		LongSpineModel(int numSegments, std::size_t numThreads = 1) :
+			m_numSegments(numSegments),
+			m_numThreads(numThreads),
+			m_buildSeconds(0.0)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure spine;
+			addTetraSpine(spine, m_numSegments);
+
+			const tgRod::Config rodConfig(0.635, 0.00311, 0.5);
+			tgSpringCableActuator::Config muscleConfig(10000, 10, false, 0, 7000, 7.0);
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			spec.addBuilder("muscle", new tgBasicActuatorInfo(muscleConfig));
+
+			// Wall time, since clock() adds up the time of every thread
+			const boost::posix_time::ptime start =
+				boost::posix_time::microsec_clock::universal_time();
+			tgStructureInfo structureInfo(spine, spec);
+			structureInfo.buildInto(*this, world, m_numThreads);
+			m_buildSeconds = (boost::posix_time::microsec_clock::universal_time() -
+				start).total_microseconds() / 1.0e6;
+
+			tgModel::setup(world);
+		}
+
+		double getBuildSeconds() const
+		{
+			return m_buildSeconds;
+		}
+
+	private:
+		const int m_numSegments;
+
+		const std::size_t m_numThreads;
+
+		double m_buildSeconds;
+	};
+
+	/**
+	 * Build the spine with the given number of threads, check that each
+	 * segment became one compound body, and report the build time.
+	 */
+	void buildSpine(int numSegments, std::size_t numThreads)
+	{
+		const tgWorld::Config config(0.0);
+		tgEmptyGround* ground = new tgEmptyGround();
+		tgWorld world(config, ground);
+
+		LongSpineModel myModel(numSegments, numThreads);
+		myModel.setup(world);
+
+		const std::vector<tgRod*> rods = myModel.find<tgRod>("rod");
+		const std::vector<tgSpringCableActuator*> muscles =
+			myModel.find<tgSpringCableActuator>("muscle");
+
+		// The rods of each segment share nodes, so each segment
+		// is one compound body
+		std::set<btRigidBody*> bodies;
+		for (std::size_t i = 0; i < rods.size(); i++)
+		{
+			bodies.insert(rods[i]->getPRigidBody());
+		}
+
+		std::cout << "Spine of " << numSegments << " segments on "
+		          << numThreads << " thread(s): built "
+		          << rods.size() << " rods and " << muscles.size()
+		          << " muscles in " << myModel.getBuildSeconds() << " s"
+		          << std::endl;
+
+		EXPECT_EQ(6u * numSegments, rods.size());
+		EXPECT_EQ(6u * (numSegments - 1), muscles.size());
+		EXPECT_EQ(static_cast<std::size_t>(numSegments), bodies.size());
+
+		myModel.teardown();
+	}
+
+	void expectSameTransform(const btTransform& a, const btTransform& b)
+	{
+		EXPECT_EQ(a.getOrigin(), b.getOrigin());
+		EXPECT_EQ(a.getBasis(), b.getBasis());
+	}
+
+	/** Compares shapes by type and size, recursing into compounds */
+	void expectSameShape(const btCollisionShape* a, const btCollisionShape* b)
+	{
+		ASSERT_EQ(a->getShapeType(), b->getShapeType());
+		EXPECT_EQ(a->getMargin(), b->getMargin());
+		EXPECT_EQ(a->getLocalScaling(), b->getLocalScaling());
+
+		if (a->isCompound())
+		{
+			const btCompoundShape* ca = static_cast<const btCompoundShape*>(a);
+			const btCompoundShape* cb = static_cast<const btCompoundShape*>(b);
+			ASSERT_EQ(ca->getNumChildShapes(), cb->getNumChildShapes());
+			for (int i = 0; i < ca->getNumChildShapes(); i++)
+			{
+				expectSameTransform(ca->getChildTransform(i), cb->getChildTransform(i));
+				expectSameShape(ca->getChildShape(i), cb->getChildShape(i));
+			}
+		}
+		else if (a->getShapeType() == CYLINDER_SHAPE_PROXYTYPE)
+		{
+			EXPECT_EQ(static_cast<const btCylinderShape*>(a)->getHalfExtentsWithMargin(),
+			          static_cast<const btCylinderShape*>(b)->getHalfExtentsWithMargin());
+		}
+	}
+
+	/** The index of each rod's body, by first appearance */
+	std::map<const btRigidBody*, std::size_t> bodyIndex(const std::vector<tgRod*>& rods)
+	{
+		std::map<const btRigidBody*, std::size_t> index;
+		for (std::size_t i = 0; i < rods.size(); i++)
+		{
+			const btRigidBody* body = rods[i]->getPRigidBody();
+			if (index.find(body) == index.end())
+			{
+				const std::size_t next = index.size();
+				index[body] = next;
+			}
+		}
+		return index;
+	}
+
+	/**
+	 * Build the spine serially and on four threads, into two worlds, and
+	 * check that the builds cannot be told apart.
+	 */
+	void compareBuilds(int numSegments)
+	{
+		const tgWorld::Config config(0.0);
+		tgWorld serialWorld(config, new tgEmptyGround());
+		tgWorld parallelWorld(config, new tgEmptyGround());
+
+		LongSpineModel serialModel(numSegments, 1);
+		serialModel.setup(serialWorld);
+		LongSpineModel parallelModel(numSegments, 4);
+		parallelModel.setup(parallelWorld);
+
+		const std::vector<tgRod*> serialRods = serialModel.find<tgRod>("rod");
+		const std::vector<tgRod*> parallelRods = parallelModel.find<tgRod>("rod");
+		ASSERT_EQ(serialRods.size(), parallelRods.size());
+
+		const std::map<const btRigidBody*, std::size_t> serialBodies =
+			bodyIndex(serialRods);
+		const std::map<const btRigidBody*, std::size_t> parallelBodies =
+			bodyIndex(parallelRods);
+		ASSERT_EQ(serialBodies.size(), parallelBodies.size());
+
+		for (std::size_t i = 0; i < serialRods.size(); i++)
+		{
+			const btRigidBody* a = serialRods[i]->getPRigidBody();
+			const btRigidBody* b = parallelRods[i]->getPRigidBody();
+
+			// The same rods share a body in both builds
+			EXPECT_EQ(serialBodies.find(a)->second, parallelBodies.find(b)->second) << i;
+			EXPECT_EQ(serialRods[i]->mass(), parallelRods[i]->mass()) << i;
+			EXPECT_EQ(a->getInvMass(), b->getInvMass()) << i;
+			expectSameTransform(a->getWorldTransform(), b->getWorldTransform());
+			expectSameShape(a->getCollisionShape(), b->getCollisionShape());
+		}
+
+		const std::vector<tgSpringCableActuator*> serialMuscles =
+			serialModel.find<tgSpringCableActuator>("muscle");
+		const std::vector<tgSpringCableActuator*> parallelMuscles =
+			parallelModel.find<tgSpringCableActuator>("muscle");
+		ASSERT_EQ(serialMuscles.size(), parallelMuscles.size());
+
+		for (std::size_t i = 0; i < serialMuscles.size(); i++)
+		{
+			const std::vector<const tgSpringCableAnchor*> a =
+				serialMuscles[i]->getSpringCable()->getAnchors();
+			const std::vector<const tgSpringCableAnchor*> b =
+				parallelMuscles[i]->getSpringCable()->getAnchors();
+			ASSERT_EQ(a.size(), b.size()) << i;
+			for (std::size_t j = 0; j < a.size(); j++)
+			{
+				EXPECT_EQ(a[j]->getWorldPosition(), b[j]->getWorldPosition()) << i;
+				EXPECT_EQ(a[j]->getRelativePosition(), b[j]->getRelativePosition()) << i;
+
+				// Attached to the same body in both builds
+				const tgBulletSpringCableAnchor* ba =
+					dynamic_cast<const tgBulletSpringCableAnchor*>(a[j]);
+				const tgBulletSpringCableAnchor* bb =
+					dynamic_cast<const tgBulletSpringCableAnchor*>(b[j]);
+				ASSERT_TRUE(ba != NULL && bb != NULL);
+				ASSERT_TRUE(serialBodies.count(ba->attachedBody) > 0);
+				ASSERT_TRUE(parallelBodies.count(bb->attachedBody) > 0);
+				EXPECT_EQ(serialBodies.find(ba->attachedBody)->second,
+				          parallelBodies.find(bb->attachedBody)->second) << i;
+			}
+		}
+
+		serialModel.teardown();
+		parallelModel.teardown();
+	}
+
+	class SpineBuildTest : public ::testing::Test {
+		protected:
+
+			SpineBuildTest() {
+
+			}
+
+			virtual ~SpineBuildTest() {
+			}
+	};
+
+	TEST_F(SpineBuildTest, ThousandSegments) {
+				buildSpine(1000, 1);
+	}
+
+	TEST_F(SpineBuildTest, ThousandSegmentsParallel) {
+				// One thread per core
+				buildSpine(1000, 0);
+	}
+
+	TEST_F(SpineBuildTest, ParallelMatchesSerial) {
+				compareBuilds(200);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file ContactCableWrap_test.cpp
+* @brief Times a contact cable wrapped around many rods, where anchor
+* lookup dominates the cost of each step.
+* $Id$
+*/
+
+// This library
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "core/tgCast.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+#include "tgcreator/tgBasicContactCableInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/**
+	 * One contact cable between two free rods, threaded alternately
+	 * above and below a row of static rods so that it touches all of them.
+	 */
+	class WrappedCableModel : public tgModel
+	{
+	public:
+
+		WrappedCableModel(int numRods) :
+			m_numRods(numRods)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			const double rodRadius = 0.25;
+			const double spacing = 1.0;
+			// Less than the radius, so the straight cable starts inside every rod
+			const double offset = 0.15;
+			const double length = spacing * (m_numRods + 1);
+
+			// Static rods have zero density
+			const tgRod::Config staticConfig(rodRadius, 0.0);
+			const tgRod::Config endConfig(rodRadius, 100.0);
+
+			tgStructure s;
+
+			// The free rods at the ends of the cable
+			s.addNode(-2.0, 0, 0); // 0
+			s.addNode(0, 0, 0); // 1
+			s.addNode(length, 0, 0); // 2
+			s.addNode(length + 2.0, 0, 0); // 3
+
+			s.addPair(0, 1, "end");
+			s.addPair(2, 3, "end");
+			s.addPair(1, 2, "muscle");
+
+			for (int i = 0; i < m_numRods; i++)
+			{
+				const double x = spacing * (i + 1);
+				const double y = (i % 2 == 0) ? offset : -offset;
+				s.addNode(x, y, -1.0);
+				s.addNode(x, y, 1.0);
+				s.addPair(4 + 2 * i, 5 + 2 * i, "static");
+			}
+
+			tgSpringCableActuator::Config muscleConfig(1000, 10, 200.0, false, 600000000);
+
+			tgBuildSpec spec;
+			spec.addBuilder("end", new tgRodInfo(endConfig));
+			spec.addBuilder("static", new tgRodInfo(staticConfig));
+			spec.addBuilder("muscle", new tgBasicContactCableInfo(muscleConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			m_cables = tgCast::filter<tgModel, tgSpringCableActuator> (getDescendants());
+
+			tgModel::setup(world);
+		}
+
+		std::size_t getNumAnchors() const
+		{
+			return m_cables[0]->getSpringCable()->getAnchors().size();
+		}
+
+	private:
+		const int m_numRods;
+
+		std::vector<tgSpringCableActuator*> m_cables;
+	};
+
+	class ContactCableWrapTest : public ::testing::Test {
+		protected:
+
+			ContactCableWrapTest() {
+
+			}
+
+			virtual ~ContactCableWrapTest() {
+			}
+	};
+
+	TEST_F(ContactCableWrapTest, WrapAroundManyRods) {
+
+				const int numRods = 24;
+				const int numSteps = 5000;
+
+				// No gravity, so only the cable moves things
+				const tgWorld::Config config(0.0);
+				tgEmptyGround* ground = new tgEmptyGround();
+				tgWorld world(config, ground);
+
+				const double stepSize = 1.0/1000.0; // Seconds
+				const double renderRate = 1.0/60.0; // Seconds
+				tgSimView view(world, stepSize, renderRate);
+
+				tgSimulation simulation(view);
+
+				WrappedCableModel* myModel = new WrappedCableModel(numRods);
+				simulation.addModel(myModel);
+
+				// Let the cable find its contacts before timing
+				simulation.run(100);
+
+				// The cable should be touching the rods by now
+				EXPECT_GT(myModel->getNumAnchors(), 2u);
+
+				const clock_t start = clock();
+				simulation.run(numSteps);
+				const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+				std::cout << "Contact cable around " << numRods << " rods: "
+				          << numSteps << " steps in " << seconds << " s ("
+				          << 1.0e6 * seconds / numSteps << " us per step), "
+				          << myModel->getNumAnchors() << " anchors" << std::endl;
+
+				EXPECT_GT(myModel->getNumAnchors(), 2u);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
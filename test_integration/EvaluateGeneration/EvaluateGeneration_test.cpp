@@ -0,0 +1,145 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file EvaluateGeneration_test.cpp
+* @brief Checks that AnnealEvolution::evaluateGeneration, with the crater
+* escape trials spread over several workers, records the same scores as
+* running the trials one after another.
+* $Id$
+*/
+
+// This application
+#include "examples/craterEscape/EscapeTrial.h"
+#include "learning/AnnealEvolution/AnnealEvolution.h"
+#include "learning/AnnealEvolution/AnnealEvoMember.h"
+#include "learning/BatchRunner/EvaluationPool.h"
+// The C++ Standard Library
+#include <fstream>
+#include <vector>
+// POSIX
+#include <sys/stat.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const char* const configFile = "EvaluateGeneration.ini";
+
+	/** Steps per episode, a few seconds of escaping */
+	const int nSteps = 1000;
+
+	class EvaluateGenerationTest : public ::testing::Test {
+		protected:
+
+			EvaluateGenerationTest() {
+
+			}
+
+			virtual ~EvaluateGenerationTest() {
+			}
+
+			/**
+			 * A small evolution in the working directory, with one
+			 * controller per cluster of the escape model. Every member
+			 * is mutated and run twice a generation, so each one has
+			 * scores to compare.
+			 */
+			virtual void SetUp() {
+				mkdir("logs", 0755);
+				ofstream config(configFile);
+				config << "learning=1\n"
+				       << "startSeed=0\n"
+				       << "seed=20150601\n"
+				       << "numberOfActions=4\n"
+				       << "numberOfStates=0\n"
+				       << "numberOfControllers=8\n"
+				       << "coevolution=0\n"
+				       << "populationSize=4\n"
+				       << "numberOfElementsToMutate=4\n"
+				       << "numberOfTestsBetweenGenerations=4\n"
+				       << "numberOfSubtests=2\n"
+				       << "leniencyCoef=0.5\n"
+				       << "MonteCarlo=0\n"
+				       << "deviation=5.0\n"
+				       << "compareAverageScores=0\n"
+				       << "clearScoresBetweenGenerations=0\n";
+			}
+	};
+
+	TEST_F(EvaluateGenerationTest, PooledMatchesOneAtATime) {
+
+				const int nGenerations = 2;
+
+				EscapeTrial trial("_EvaluateGeneration", nSteps);
+				EvaluationPool pool(4);
+				AnnealEvolution pooled("_pooled", configFile);
+				AnnealEvolution serial("_serial", configFile);
+
+				for (int i = 0; i < nGenerations; i++)
+				{
+					pooled.evaluateGeneration(pool, trial);
+
+					// As the adapters do it, one episode after another
+					const vector< vector<AnnealEvoMember*> > generation =
+						serial.nextGeneration();
+					for (size_t j = 0; j < generation.size(); j++)
+					{
+						const vector<double> scores =
+							trial.evaluate(generation[j], serial.episodeStream(j));
+						ASSERT_EQ(2u, scores.size()) << "Trial " << j;
+						serial.updateScores(generation[j], scores);
+					}
+				}
+
+				// Ordering the populations for the next generation ranks
+				// the members by the scores that were recorded
+				const vector< vector<AnnealEvoMember*> > nextPooled =
+					pooled.nextGeneration();
+				const vector< vector<AnnealEvoMember*> > nextSerial =
+					serial.nextGeneration();
+
+				ASSERT_EQ(nextSerial.size(), nextPooled.size());
+				// Every member, twice
+				ASSERT_EQ(8u, nextPooled.size());
+				for (size_t i = 0; i < nextPooled.size(); i++)
+				{
+					ASSERT_EQ(8u, nextPooled[i].size());
+					for (size_t j = 0; j < nextPooled[i].size(); j++)
+					{
+						const AnnealEvoMember& p = *nextPooled[i][j];
+						const AnnealEvoMember& s = *nextSerial[i][j];
+
+						// Two subtests in each generation reached the member
+						EXPECT_EQ(2u * nGenerations, p.pastScores.size());
+						EXPECT_EQ(s.pastScores, p.pastScores);
+						EXPECT_EQ(s.maxScore, p.maxScore);
+						EXPECT_EQ(s.statelessParameters, p.statelessParameters);
+					}
+				}
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
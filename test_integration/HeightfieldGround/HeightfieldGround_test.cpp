@@ -0,0 +1,230 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file HeightfieldGround_test.cpp
+* @brief Checks that rods come to rest in the same places on a
+* tgHeightfieldGround as on the tgHillyGround it copies, and that heights
+* mapped from a file match the same heights given as a vector. Times
+* building and stepping each ground.
+* $Id$
+*/
+
+// This application
+#include "helpers/DroppedRodsModel.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgHeightfieldGround.h"
+#include "core/terrain/tgHillyGround.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// POSIX
+#include <unistd.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Rods dropped over different parts of the terrain. */
+	std::vector<btVector3> rodStarts()
+	{
+		const double x[] = {-30.0, -12.5, 0.0, 7.0, 21.0};
+		const double z[] = {15.0, -20.0, 0.0, 33.0, -8.0};
+
+		std::vector<btVector3> starts;
+		for (int i = 0; i < 5; i++)
+		{
+			starts.push_back(btVector3(x[i] - 0.5, 4.0, z[i]));
+		}
+		return starts;
+	}
+
+	/** The hills the tests run on, in meters. */
+	tgHillyGround::Config hillyConfig()
+	{
+		const btVector3 eulerAngles(0.0, 0.0, 0.0);
+		const btScalar friction = 0.8;
+		const btScalar restitution = 0.0;
+		const btVector3 size(0.0, 0.1, 0.0);
+		const btVector3 origin(0.0, 0.0, 0.0);
+		const size_t nx = 100;
+		const size_t ny = 100;
+		const double margin = 0.05;
+		const double triangleSize = 1.0;
+		const double waveHeight = 0.5;
+		const double offset = 0.0;
+		return tgHillyGround::Config(eulerAngles, friction, restitution,
+									 size, origin, nx, ny, margin,
+									 triangleSize, waveHeight, offset);
+	}
+
+	/**
+	 * Drop the rods on the ground for three seconds, and return where
+	 * they came to rest. Takes ownership of the ground.
+	 */
+	std::vector<btVector3> dropRods(tgBulletGround* ground, const std::string& name)
+	{
+		const tgWorld::Config config(9.81);
+		tgWorld world(config, ground);
+
+		const double stepSize = 1.0/1000.0; // Seconds
+		const double renderRate = 1.0/60.0; // Seconds
+		tgSimView view(world, stepSize, renderRate);
+
+		tgSimulation simulation(view);
+
+		DroppedRodsModel* myModel = new DroppedRodsModel(rodStarts());
+		simulation.addModel(myModel);
+
+		const int numSteps = 3000;
+		const clock_t start = clock();
+		simulation.run(numSteps);
+		const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+		std::cout << name << ": " << numSteps << " steps in " << seconds
+		          << " s" << std::endl;
+
+		return myModel->rodCenters();
+	}
+
+	class HeightfieldGroundTest : public ::testing::Test {
+		protected:
+
+			HeightfieldGroundTest() {
+
+			}
+
+			virtual ~HeightfieldGroundTest() {
+			}
+	};
+
+	TEST_F(HeightfieldGroundTest, MatchesHillyMesh) {
+
+				const tgHillyGround::Config config = hillyConfig();
+
+				clock_t start = clock();
+				tgHillyGround* const mesh = new tgHillyGround(config);
+				std::cout << "Mesh built in "
+				          << double(clock() - start) / CLOCKS_PER_SEC << " s" << std::endl;
+
+				start = clock();
+				tgHeightfieldGround* const heightfield = new tgHeightfieldGround(config);
+				std::cout << "Heightfield built in "
+				          << double(clock() - start) / CLOCKS_PER_SEC << " s" << std::endl;
+
+				const std::vector<btVector3> onMesh = dropRods(mesh, "Mesh");
+				const std::vector<btVector3> onHeightfield =
+					dropRods(heightfield, "Heightfield");
+
+				// The same triangles, found by a different query
+				const double tol = 0.05;
+
+				ASSERT_EQ(onMesh.size(), onHeightfield.size());
+				for (std::size_t i = 0; i < onMesh.size(); i++)
+				{
+					// Every rod must have landed rather than fallen through
+					EXPECT_GT(onMesh[i].y(), -1.0);
+					EXPECT_NEAR(onMesh[i].x(), onHeightfield[i].x(), tol);
+					EXPECT_NEAR(onMesh[i].y(), onHeightfield[i].y(), tol);
+					EXPECT_NEAR(onMesh[i].z(), onHeightfield[i].z(), tol);
+				}
+	}
+
+	TEST_F(HeightfieldGroundTest, FileMatchesVector) {
+
+				const size_t nx = 80;
+				const size_t ny = 90;
+				const double heightScale = 0.01;
+
+				// Centimeter elevations of gentle hills, given to both
+				// grounds as the same values with the same scale
+				std::vector<short> elevations(nx * ny);
+				std::vector<btScalar> values(nx * ny);
+				for (size_t i = 0; i < nx; i++)
+				{
+					for (size_t j = 0; j < ny; j++)
+					{
+						const short e = static_cast<short>((i * 7 + j * 13) % 60);
+						elevations[i + j * nx] = e;
+						values[i + j * nx] = e;
+					}
+				}
+
+				char fileName[] = "/tmp/HeightfieldGround_testXXXXXX";
+				const int fd = mkstemp(fileName);
+				ASSERT_GE(fd, 0);
+				FILE* const file = fdopen(fd, "wb");
+				fwrite(&elevations[0], sizeof(short), elevations.size(), file);
+				fclose(file);
+
+				const tgHeightfieldGround::Config config(btVector3(0.0, 0.0, 0.0),
+														 0.8, 0.0,
+														 btVector3(0.0, 0.0, 0.0),
+														 nx, ny, 1.0, heightScale);
+
+				const std::vector<btVector3> fromVector =
+					dropRods(new tgHeightfieldGround(config, values), "Vector");
+				const std::vector<btVector3> fromFile =
+					dropRods(new tgHeightfieldGround(config, std::string(fileName)), "File");
+				unlink(fileName);
+
+				// The same integer elevations, read as btScalar or short
+				const double tol = 1.0e-6;
+
+				ASSERT_EQ(fromVector.size(), fromFile.size());
+				for (std::size_t i = 0; i < fromVector.size(); i++)
+				{
+					EXPECT_NEAR(fromVector[i].x(), fromFile[i].x(), tol);
+					EXPECT_NEAR(fromVector[i].y(), fromFile[i].y(), tol);
+					EXPECT_NEAR(fromVector[i].z(), fromFile[i].z(), tol);
+				}
+	}
+
+	TEST_F(HeightfieldGroundTest, RejectsWrongSize) {
+
+				const tgHeightfieldGround::Config config(btVector3(0.0, 0.0, 0.0),
+														 0.8, 0.0,
+														 btVector3(0.0, 0.0, 0.0),
+														 10, 10);
+
+				EXPECT_THROW(tgHeightfieldGround(config, std::vector<btScalar>(99)),
+							 std::invalid_argument);
+				EXPECT_THROW(tgHeightfieldGround(config, std::string("/nonexistent.r16")),
+							 std::runtime_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,223 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SimulationPool_test.cpp
+* @brief Checks that episodes run by tgSimulationPool on several threads
+* end exactly where the same episodes end when run one at a time.
+* $Id$
+*/
+
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationPool.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgBoxGround.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double stepSize = 1.0/1000.0;
+
+	/**
+	 * A three bar prism dropped onto the ground from a height that
+	 * depends on the episode. Writes where its rods ended up into
+	 * result when it is torn down, since the simulation deletes it.
+	 */
+	class DroppedPrismModel : public tgModel
+	{
+	public:
+
+		DroppedPrismModel(double height, vector<double>& result) :
+			m_height(height),
+			m_result(result)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			const tgRod::Config rodConfig(0.2, 1.0);
+			tgSpringCableActuator::Config muscleConfig(1000, 10, 100.0);
+
+			tgStructure s;
+
+			s.addNode(-5, 2, 0);   // 0
+			s.addNode(5, 2, 0);    // 1
+			s.addNode(0, 2, 8.66); // 2
+			s.addNode(-5, 12, 8.66); // 3
+			s.addNode(5, 12, 8.66);  // 4
+			s.addNode(0, 12, 0);     // 5
+
+			s.addPair(0, 4, "rod");
+			s.addPair(1, 5, "rod");
+			s.addPair(2, 3, "rod");
+
+			s.addPair(0, 1, "muscle");
+			s.addPair(1, 2, "muscle");
+			s.addPair(2, 0, "muscle");
+			s.addPair(3, 4, "muscle");
+			s.addPair(4, 5, "muscle");
+			s.addPair(5, 3, "muscle");
+			s.addPair(0, 3, "muscle");
+			s.addPair(1, 4, "muscle");
+			s.addPair(2, 5, "muscle");
+
+			s.move(btVector3(0, m_height, 0));
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			spec.addBuilder("muscle", new tgBasicActuatorInfo(muscleConfig));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+		virtual void teardown()
+		{
+			const vector<tgRod*> rods = find<tgRod>("rod");
+			m_result.clear();
+			for (size_t i = 0; i < rods.size(); i++)
+			{
+				const btVector3 com = rods[i]->centerOfMass();
+				m_result.push_back(com.x());
+				m_result.push_back(com.y());
+				m_result.push_back(com.z());
+			}
+			tgModel::teardown();
+		}
+
+	private:
+		const double m_height;
+
+		vector<double>& m_result;
+	};
+
+	/** Drops a prism from a different height in every episode */
+	class DroppedPrismFactory : public tgSimulationPool::EpisodeFactory
+	{
+	public:
+
+		DroppedPrismFactory(size_t nEpisodes) :
+			m_results(nEpisodes)
+		{
+		}
+
+		tgWorld* createWorld(size_t episode)
+		{
+			const tgWorld::Config config(98.1);
+			return new tgWorld(config, new tgBoxGround());
+		}
+
+		void populate(tgSimulation& simulation, size_t episode)
+		{
+			// Each episode writes only its own slot
+			simulation.addModel(new DroppedPrismModel(0.5 * episode,
+			                                          m_results[episode]));
+		}
+
+		vector<double> collect(size_t episode)
+		{
+			return m_results[episode];
+		}
+
+	private:
+		vector< vector<double> > m_results;
+	};
+
+	/** Runs an episode the way the pool does, on this thread */
+	vector<double> runSerial(tgSimulationPool::EpisodeFactory& factory,
+	                         size_t episode, int steps)
+	{
+		tgWorld* world = factory.createWorld(episode);
+		tgSimView* view = new tgSimView(*world, stepSize, stepSize);
+		tgSimulation* simulation = new tgSimulation(*view);
+		factory.populate(*simulation, episode);
+		simulation->run(steps);
+
+		delete simulation;
+		delete view;
+		delete world;
+		return factory.collect(episode);
+	}
+
+	class SimulationPoolTest : public ::testing::Test {
+		protected:
+
+			SimulationPoolTest() {
+
+			}
+
+			virtual ~SimulationPoolTest() {
+			}
+	};
+
+	TEST_F(SimulationPoolTest, PooledMatchesSerial) {
+
+				const size_t nEpisodes = 8;
+				const int steps = 2000;
+
+				DroppedPrismFactory pooledFactory(nEpisodes);
+				tgSimulationPool pool(pooledFactory, 4, stepSize);
+				const vector< vector<double> > pooled = pool.run(nEpisodes, steps);
+
+				ASSERT_EQ(nEpisodes, pooled.size());
+
+				DroppedPrismFactory serialFactory(nEpisodes);
+				for (size_t i = 0; i < nEpisodes; i++)
+				{
+					const vector<double> serial = runSerial(serialFactory, i, steps);
+
+					// Three rods, three coordinates each
+					ASSERT_EQ(9u, serial.size()) << i;
+					// Nothing is shared between the worlds, so threading
+					// must not change a single bit
+					EXPECT_EQ(serial, pooled[i]) << "Episode " << i;
+				}
+
+				// The episodes really are different
+				EXPECT_NE(pooled[0], pooled[nEpisodes - 1]);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SolverBenchmark_test.cpp
+* @brief Times each constraint solver and broadphase of tgWorld::Config
+* on the tetrahedral spine, lying on flat ground and on a field of blocks.
+* $Id$
+*/
+
+// This application
+#include "examples/learningSpines/TetrahedralComplex/FlemonsSpineModelLearning.h"
+#include "models/obstacles/tgBlockField.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
+
+#include "BulletCollision/BroadphaseCollision/btAxisSweep3.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** A named tgWorld::Config to time. */
+	struct SolverSetup
+	{
+		SolverSetup(const std::string& n,
+					tgWorld::Config::SolverType s,
+					int iterations,
+					tgWorld::Config::BroadphaseType b) :
+			name(n),
+			solverType(s),
+			solverIterations(iterations),
+			broadphaseType(b)
+		{
+		}
+
+		std::string name;
+		tgWorld::Config::SolverType solverType;
+		int solverIterations;
+		tgWorld::Config::BroadphaseType broadphaseType;
+	};
+
+	std::vector<SolverSetup> getSetups()
+	{
+		std::vector<SolverSetup> setups;
+		setups.push_back(SolverSetup("Dantzig MLCP, axis sweep",
+									 tgWorld::Config::eDantzigMLCP, 10,
+									 tgWorld::Config::eAxisSweep));
+		setups.push_back(SolverSetup("PGS MLCP, axis sweep",
+									 tgWorld::Config::ePGSMLCP, 10,
+									 tgWorld::Config::eAxisSweep));
+		setups.push_back(SolverSetup("SI 10 iterations, axis sweep",
+									 tgWorld::Config::eSequentialImpulse, 10,
+									 tgWorld::Config::eAxisSweep));
+		setups.push_back(SolverSetup("SI 20 iterations, axis sweep",
+									 tgWorld::Config::eSequentialImpulse, 20,
+									 tgWorld::Config::eAxisSweep));
+		setups.push_back(SolverSetup("SI 10 iterations, dbvt",
+									 tgWorld::Config::eSequentialImpulse, 10,
+									 tgWorld::Config::eDbvt));
+		return setups;
+	}
+
+	/**
+	 * Let the spine fall and settle, optionally onto a field of blocks,
+	 * and report the time per step and where the middle segment ended.
+	 */
+	btVector3 runSpine(const SolverSetup& setup, bool blocks, int numSteps)
+	{
+		tgWorld::Config config(981); // gravity, cm/sec^2
+		config.solverType = setup.solverType;
+		config.solverIterations = setup.solverIterations;
+		config.broadphaseType = setup.broadphaseType;
+		tgWorld world(config);
+
+		const double stepSize = 1.0/1000.0; // Seconds
+		const double renderRate = 1.0/60.0; // Seconds
+		tgSimView view(world, stepSize, renderRate);
+
+		tgSimulation simulation(view);
+
+		const int segments = 12;
+		FlemonsSpineModelLearning* myModel =
+			new FlemonsSpineModelLearning(segments);
+		simulation.addModel(myModel);
+
+		if (blocks)
+		{
+			// Small blocks close together under the spine, so most of
+			// the contacts are with their edges
+			tgBlockField::Config fieldConfig(btVector3(0.0, 0.0, 0.0),
+											 0.5, 0.0,
+											 btVector3(-20.0, 0.0, -100.0),
+											 btVector3(20.0, 0.0, 20.0),
+											 200, 2.0, 2.0, 2.0);
+			simulation.addModel(new tgBlockField(fieldConfig));
+		}
+
+		const clock_t start = clock();
+		simulation.run(numSteps);
+		const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+		std::cout << setup.name << (blocks ? " on blocks: " : " on ground: ")
+				  << 1.0e6 * seconds / numSteps << " us per step" << std::endl;
+
+		return myModel->getSegmentCOMVector(segments / 2);
+	}
+
+	class SolverBenchmarkTest : public ::testing::Test {
+		protected:
+
+			SolverBenchmarkTest() {
+
+			}
+
+			virtual ~SolverBenchmarkTest() {
+			}
+	};
+
+	TEST_F(SolverBenchmarkTest, SpineSettles) {
+
+				const int numSteps = 5000;
+				const std::vector<SolverSetup> setups = getSetups();
+
+				for (int blocks = 0; blocks < 2; blocks++)
+				{
+					for (std::size_t i = 0; i < setups.size(); i++)
+					{
+						const btVector3 com = runSpine(setups[i], blocks != 0, numSteps);
+
+						// Every solver must keep the spine on top of the
+						// ground, whatever its speed. A NaN fails both.
+						EXPECT_GT(com.y(), 0.0) << setups[i].name;
+						EXPECT_LT(com.y(), 50.0) << setups[i].name;
+					}
+				}
+	}
+
+	TEST_F(SolverBenchmarkTest, RejectsBadConfig) {
+
+				tgWorld::Config noIterations(981);
+				noIterations.solverIterations = 0;
+				EXPECT_THROW(tgWorld world(noIterations), std::invalid_argument);
+
+				tgWorld::Config noHandles(981);
+				noHandles.maxHandles = 0;
+				EXPECT_THROW(tgWorld world(noHandles), std::invalid_argument);
+
+				// A dbvt broadphase has no handle limit
+				tgWorld::Config dbvt(981);
+				dbvt.maxHandles = 0;
+				dbvt.broadphaseType = tgWorld::Config::eDbvt;
+				EXPECT_NO_THROW(tgWorld world(dbvt));
+	}
+
+	/** Whether an eAxisSweep world with this many handles got a 16 bit broadphase */
+	bool hasSmallAxisSweep(int maxHandles)
+	{
+		tgWorld::Config config(981);
+		config.maxHandles = maxHandles;
+		tgWorld world(config);
+		const tgWorldBulletPhysicsImpl& impl =
+			(tgWorldBulletPhysicsImpl&)world.implementation();
+		btBroadphaseInterface* broadphase = impl.dynamicsWorld().getBroadphase();
+
+		const bool small = dynamic_cast<btAxisSweep3*>(broadphase) != NULL;
+		const bool large = dynamic_cast<bt32BitAxisSweep3*>(broadphase) != NULL;
+		EXPECT_NE(small, large) << maxHandles;
+		return small;
+	}
+
+	TEST_F(SolverBenchmarkTest, AxisSweepHandleLimit) {
+
+				// Two 16 bit edges per handle: 32766 handles is the most
+				// btAxisSweep3 accepts
+				EXPECT_TRUE(hasSmallAxisSweep(16384));
+				EXPECT_TRUE(hasSmallAxisSweep(32766));
+				EXPECT_FALSE(hasSmallAxisSweep(32767));
+				EXPECT_FALSE(hasSmallAxisSweep(65533));
+				EXPECT_FALSE(hasSmallAxisSweep(65535));
+				EXPECT_FALSE(hasSmallAxisSweep(100000));
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
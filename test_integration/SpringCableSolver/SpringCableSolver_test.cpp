@@ -0,0 +1,334 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SpringCableSolver_test.cpp
+* @brief Checks that batching spring cables with tgBulletSpringCableSolver
+* moves a pretensioned spine the same way as stepping each cable, and
+* that physics substeps match stepping everything at the physics rate.
+* Times each.
+* $Id$
+*/
+
+// This application
+#include "helpers/TetraSpine.h"
+// This library
+#include "core/tgBulletSpringCableSolver.h"
+#include "core/tgKinematicActuator.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBasicConstraintCableInfo.h"
+#include "tgcreator/tgBasicContactCableInfo.h"
+#include "tgcreator/tgKinematicActuatorInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** The builders the spine's cables can come from */
+	enum MuscleType
+	{
+		/** tgBasicActuator with a tgBulletSpringCable, which is batched */
+		eBasic,
+		/** tgKinematicActuator */
+		eKinematic,
+		/** tgBasicActuator with a tgBulletContactSpringCable */
+		eContact,
+		/** tgBasicActuator with a tgBulletConstraintSpringCable */
+		eConstraint
+	};
+
+	const char* const muscleNames[] = {"", " kinematic", " contact", " constraint"};
+
+	/**
+	 * A tetrahedral spine whose cables start stretched, so that they
+	 * pull the segments together as soon as the simulation starts.
+	 */
+	class PretensionedSpineModel : public tgModel
+	{
+	public:
+
+		PretensionedSpineModel(int numSegments, MuscleType muscleType) :
+			m_numSegments(numSegments),
+			m_muscleType(muscleType)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure spine;
+			addTetraSpine(spine, m_numSegments);
+
+			const tgRod::Config rodConfig(0.635, 0.00311, 0.5);
+			// Pretension of 1000 over a stiffness of 1000: each cable
+			// starts one unit longer than its rest length
+			tgSpringCableActuator::Config muscleConfig(1000, 10, 1000.0);
+			tgKinematicActuator::Config motorConfig(1000, 10, 1000.0);
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			switch (m_muscleType)
+			{
+			case eKinematic:
+				spec.addBuilder("muscle", new tgKinematicActuatorInfo(motorConfig));
+				break;
+			case eContact:
+				spec.addBuilder("muscle", new tgBasicContactCableInfo(muscleConfig));
+				break;
+			case eConstraint:
+				spec.addBuilder("muscle", new tgBasicConstraintCableInfo(muscleConfig));
+				break;
+			default:
+				spec.addBuilder("muscle", new tgBasicActuatorInfo(muscleConfig));
+				break;
+			}
+
+			tgStructureInfo structureInfo(spine, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+	private:
+		const int m_numSegments;
+
+		const MuscleType m_muscleType;
+	};
+
+	/** The state the two runs are compared by. */
+	struct SpineState
+	{
+		std::vector<btVector3> rodCenters;
+
+		std::vector<double> tensions;
+
+		/** The cables the world's spring cable solver applied */
+		std::size_t batchedCables;
+	};
+
+	/**
+	 * Run the spine without gravity for the given number of physics
+	 * steps, with or without batching its cables, and report the time
+	 * taken. With substeps, the models step that many times less often.
+	 */
+	SpineState runSpine(int numSegments, int numSteps, bool batchSpringCables,
+						int physicsSubsteps = 1, MuscleType muscleType = eBasic)
+	{
+		tgWorld::Config config(0.0);
+		config.batchSpringCables = batchSpringCables;
+		config.physicsSubsteps = physicsSubsteps;
+		if (muscleType == eConstraint)
+		{
+			// The only solver constraint cables can be added to
+			config.solverType = tgWorld::Config::eSequentialImpulse;
+		}
+		tgEmptyGround* ground = new tgEmptyGround();
+		tgWorld world(config, ground);
+
+		const double stepSize = physicsSubsteps/1000.0; // Seconds
+		const double renderRate = 1.0/60.0; // Seconds
+		tgSimView view(world, stepSize, renderRate);
+
+		tgSimulation simulation(view);
+
+		PretensionedSpineModel* myModel =
+			new PretensionedSpineModel(numSegments, muscleType);
+		simulation.addModel(myModel);
+
+		const clock_t start = clock();
+		simulation.run(numSteps / physicsSubsteps);
+		const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+		const std::vector<tgRod*> rods = myModel->find<tgRod>("rod");
+		const std::vector<tgSpringCableActuator*> muscles =
+			myModel->find<tgSpringCableActuator>("muscle");
+
+		std::cout << (batchSpringCables ? "Batched" : "Unbatched")
+		          << muscleNames[muscleType]
+		          << " spine of " << muscles.size() << " cables, "
+		          << physicsSubsteps << " substeps: "
+		          << numSteps << " steps in " << seconds << " s ("
+		          << 1.0e6 * seconds / numSteps << " us per step)"
+		          << std::endl;
+
+		SpineState state;
+		for (std::size_t i = 0; i < rods.size(); i++)
+		{
+			state.rodCenters.push_back(rods[i]->centerOfMass());
+		}
+		for (std::size_t i = 0; i < muscles.size(); i++)
+		{
+			state.tensions.push_back(muscles[i]->getTension());
+		}
+
+		const tgWorldBulletPhysicsImpl& impl =
+			(tgWorldBulletPhysicsImpl&)world.implementation();
+		const tgBulletSpringCableSolver* solver = impl.springCableSolver();
+		state.batchedCables = solver != NULL ? solver->size() : 0;
+		return state;
+	}
+
+	class SpringCableSolverTest : public ::testing::Test {
+		protected:
+
+			SpringCableSolverTest() {
+
+			}
+
+			virtual ~SpringCableSolverTest() {
+			}
+	};
+
+	TEST_F(SpringCableSolverTest, BatchedMatchesUnbatched) {
+
+				const int numSegments = 100;
+				const int numSteps = 2000;
+				// Summing impulses per body changes only the rounding
+				const double tol = 1.0e-3;
+				// Tension is length times a stiffness of 1000
+				const double tensionTol = 1.0;
+
+				const SpineState unbatched = runSpine(numSegments, numSteps, false);
+				const SpineState batched = runSpine(numSegments, numSteps, true);
+
+				ASSERT_EQ(unbatched.rodCenters.size(), batched.rodCenters.size());
+				ASSERT_EQ(unbatched.tensions.size(), batched.tensions.size());
+
+				// Otherwise both runs could be unbatched and trivially agree
+				EXPECT_EQ(0u, unbatched.batchedCables);
+				EXPECT_EQ(batched.tensions.size(), batched.batchedCables);
+
+				for (std::size_t i = 0; i < unbatched.rodCenters.size(); i++)
+				{
+					EXPECT_NEAR(unbatched.rodCenters[i].x(), batched.rodCenters[i].x(), tol);
+					EXPECT_NEAR(unbatched.rodCenters[i].y(), batched.rodCenters[i].y(), tol);
+					EXPECT_NEAR(unbatched.rodCenters[i].z(), batched.rodCenters[i].z(), tol);
+				}
+				for (std::size_t i = 0; i < unbatched.tensions.size(); i++)
+				{
+					EXPECT_NEAR(unbatched.tensions[i], batched.tensions[i], tensionTol);
+				}
+	}
+
+	TEST_F(SpringCableSolverTest, BatchesOnlyBasicActuators) {
+
+				const int numSegments = 5;
+				const int numSteps = 10;
+
+				const SpineState basic = runSpine(numSegments, numSteps, true);
+				EXPECT_EQ(6u * (numSegments - 1), basic.tensions.size());
+				EXPECT_EQ(basic.tensions.size(), basic.batchedCables);
+
+				// Kinematic actuators, and cables that subclass
+				// tgBulletSpringCable, still step themselves
+				const MuscleType others[] = {eKinematic, eContact, eConstraint};
+				for (std::size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++)
+				{
+					const SpineState state = runSpine(numSegments, numSteps, true,
+													  1, others[i]);
+					EXPECT_EQ(6u * (numSegments - 1), state.tensions.size()) << muscleNames[others[i]];
+					EXPECT_EQ(0u, state.batchedCables) << muscleNames[others[i]];
+				}
+	}
+
+	TEST_F(SpringCableSolverTest, SubstepsMatchSmallSteps) {
+
+				const int numSegments = 20;
+				const int numSteps = 2000;
+				const int physicsSubsteps = 10;
+				// Substeps apply the cables before each physics step
+				// rather than after, so the two runs are one step apart
+				const double tol = 0.1;
+				const double tensionTol = 10.0;
+
+				const SpineState small = runSpine(numSegments, numSteps, true);
+				const SpineState substeps = runSpine(numSegments, numSteps, false,
+													 physicsSubsteps);
+
+				ASSERT_EQ(small.rodCenters.size(), substeps.rodCenters.size());
+				ASSERT_EQ(small.tensions.size(), substeps.tensions.size());
+
+				for (std::size_t i = 0; i < small.rodCenters.size(); i++)
+				{
+					EXPECT_NEAR(small.rodCenters[i].x(), substeps.rodCenters[i].x(), tol);
+					EXPECT_NEAR(small.rodCenters[i].y(), substeps.rodCenters[i].y(), tol);
+					EXPECT_NEAR(small.rodCenters[i].z(), substeps.rodCenters[i].z(), tol);
+				}
+				for (std::size_t i = 0; i < small.tensions.size(); i++)
+				{
+					EXPECT_NEAR(small.tensions[i], substeps.tensions[i], tensionTol);
+				}
+	}
+
+	TEST_F(SpringCableSolverTest, KinematicSubstepsMatchSmallSteps) {
+
+				const int numSegments = 20;
+				const int numSteps = 2000;
+				const int physicsSubsteps = 10;
+				// The world steps these cables before every substep, as
+				// the solver does the batched ones
+				const double tol = 0.1;
+				const double tensionTol = 10.0;
+
+				const SpineState small = runSpine(numSegments, numSteps, false,
+												  1, eKinematic);
+				const SpineState substeps = runSpine(numSegments, numSteps, false,
+													 physicsSubsteps, eKinematic);
+
+				ASSERT_EQ(small.rodCenters.size(), substeps.rodCenters.size());
+				ASSERT_EQ(small.tensions.size(), substeps.tensions.size());
+
+				for (std::size_t i = 0; i < small.rodCenters.size(); i++)
+				{
+					EXPECT_NEAR(small.rodCenters[i].x(), substeps.rodCenters[i].x(), tol);
+					EXPECT_NEAR(small.rodCenters[i].y(), substeps.rodCenters[i].y(), tol);
+					EXPECT_NEAR(small.rodCenters[i].z(), substeps.rodCenters[i].z(), tol);
+				}
+				for (std::size_t i = 0; i < small.tensions.size(); i++)
+				{
+					EXPECT_NEAR(small.tensions[i], substeps.tensions[i], tensionTol);
+				}
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,452 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file StateRestore_test.cpp
+* @brief Checks that tgSimulation::restoreState replays a run exactly,
+* and compares its cost with tgSimulation::reset.
+* $Id$
+*/
+
+// This library
+#include "controllers/tgImpedanceController.h"
+#include "controllers/tgPIDController.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgKinematicActuator.h"
+#include "core/tgModel.h"
+#include "core/tgObserver.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationState.h"
+#include "core/tgSubject.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgBoxGround.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "examples/learningSpines/tgSCASineControl.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgKinematicActuatorInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/**
+	 * A three bar prism that falls onto the ground.
+	 */
+	class PrismModel : public tgSubject<PrismModel>, public tgModel
+	{
+	public:
+
+		PrismModel(bool kinematicMuscles = false) :
+			m_kinematicMuscles(kinematicMuscles)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			const tgRod::Config rodConfig(0.2, 1.0);
+			tgSpringCableActuator::Config muscleConfig(1000, 10, 100.0);
+			tgKinematicActuator::Config motorConfig(1000, 10, 100.0);
+
+			tgStructure s;
+
+			s.addNode(-5, 2, 0);   // 0
+			s.addNode(5, 2, 0);    // 1
+			s.addNode(0, 2, 8.66); // 2
+			s.addNode(-5, 12, 8.66); // 3
+			s.addNode(5, 12, 8.66);  // 4
+			s.addNode(0, 12, 0);     // 5
+
+			s.addPair(0, 4, "rod");
+			s.addPair(1, 5, "rod");
+			s.addPair(2, 3, "rod");
+
+			s.addPair(0, 1, "muscle");
+			s.addPair(1, 2, "muscle");
+			s.addPair(2, 0, "muscle");
+			s.addPair(3, 4, "muscle");
+			s.addPair(4, 5, "muscle");
+			s.addPair(5, 3, "muscle");
+			s.addPair(0, 3, "muscle");
+			s.addPair(1, 4, "muscle");
+			s.addPair(2, 5, "muscle");
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(rodConfig));
+			if (m_kinematicMuscles)
+			{
+				spec.addBuilder("muscle", new tgKinematicActuatorInfo(motorConfig));
+			}
+			else
+			{
+				spec.addBuilder("muscle", new tgBasicActuatorInfo(muscleConfig));
+			}
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			m_muscles = tgCast::filter<tgModel, tgBasicActuator> (getDescendants());
+			m_allMuscles = tgCast::filter<tgModel, tgSpringCableActuator> (getDescendants());
+			m_rods = tgCast::filter<tgModel, tgRod> (getDescendants());
+
+			notifySetup();
+			tgModel::setup(world);
+		}
+
+		virtual void step(double dt)
+		{
+			notifyStep(dt);
+			tgModel::step(dt);
+		}
+
+		virtual void saveState(tgSimulationState& state)
+		{
+			notifySaveState(state);
+			tgModel::saveState(state);
+		}
+
+		virtual void restoreState(tgSimulationState& state)
+		{
+			notifyRestoreState(state);
+			tgModel::restoreState(state);
+		}
+
+		virtual void teardown()
+		{
+			notifyTeardown();
+			tgModel::teardown();
+		}
+
+		std::vector<btVector3> getPositions() const
+		{
+			std::vector<btVector3> positions;
+			for (std::size_t i = 0; i < m_rods.size(); i++)
+			{
+				positions.push_back(m_rods[i]->centerOfMass());
+			}
+			return positions;
+		}
+
+		std::vector<tgBasicActuator*> m_muscles;
+
+		std::vector<tgSpringCableActuator*> m_allMuscles;
+
+	private:
+		const bool m_kinematicMuscles;
+
+		std::vector<tgRod*> m_rods;
+	};
+
+	/**
+	 * Drives the muscles with a sine wave, so that the result depends
+	 * on the time the controller has counted.
+	 */
+	class SineController : public tgObserver<PrismModel>
+	{
+	public:
+
+		SineController() :
+			m_time(0.0)
+		{
+		}
+
+		virtual void onSetup(PrismModel& subject)
+		{
+			m_time = 0.0;
+		}
+
+		virtual void onStep(PrismModel& subject, double dt)
+		{
+			m_time += dt;
+			for (std::size_t i = 0; i < subject.m_muscles.size(); i++)
+			{
+				const double start = subject.m_muscles[i]->getStartLength();
+				subject.m_muscles[i]->setControlInput(start * (0.9 + 0.05 * sin(2.0 * m_time + i)), dt);
+			}
+		}
+
+		virtual void onSaveState(PrismModel& subject, tgSimulationState& state)
+		{
+			state.write(m_time);
+		}
+
+		virtual void onRestoreState(PrismModel& subject, tgSimulationState& state)
+		{
+			m_time = state.read();
+		}
+
+	private:
+		double m_time;
+	};
+
+	class StateRestoreTest : public ::testing::Test {
+		protected:
+
+			StateRestoreTest() {
+
+			}
+
+			virtual ~StateRestoreTest() {
+			}
+	};
+
+	TEST_F(StateRestoreTest, BranchesFromSavedStateMatch) {
+
+				const int warmupSteps = 2000;
+				const int branchSteps = 3000;
+
+				const tgWorld::Config config(98.1);
+				tgBoxGround* ground = new tgBoxGround();
+				tgWorld world(config, ground);
+
+				const double stepSize = 1.0/1000.0; // Seconds
+				const double renderRate = 1.0/60.0; // Seconds
+				tgSimView view(world, stepSize, renderRate);
+
+				// Must outlive the simulation, which tears the model down
+				SineController controller;
+				tgSimulation simulation(view);
+
+				PrismModel* myModel = new PrismModel();
+				myModel->attach(&controller);
+				simulation.addModel(myModel);
+
+				simulation.run(warmupSteps);
+
+				tgSimulationState state = simulation.saveState();
+				// Start both branches from a restore, since restoring also
+				// clears Bullet's contact and solver caches
+				simulation.restoreState(state);
+				simulation.run(branchSteps);
+				const std::vector<btVector3> first = myModel->getPositions();
+
+				simulation.restoreState(state);
+				simulation.run(branchSteps);
+				const std::vector<btVector3> second = myModel->getPositions();
+
+				ASSERT_EQ(first.size(), second.size());
+				for (std::size_t i = 0; i < first.size(); i++)
+				{
+					EXPECT_NEAR(first[i].x(), second[i].x(), 1.0e-9);
+					EXPECT_NEAR(first[i].y(), second[i].y(), 1.0e-9);
+					EXPECT_NEAR(first[i].z(), second[i].z(), 1.0e-9);
+				}
+
+				// The prism should have moved away from the saved state
+				simulation.restoreState(state);
+				const std::vector<btVector3> restored = myModel->getPositions();
+				EXPECT_GT((restored[0] - first[0]).length(), 1.0e-3);
+
+				const int numResets = 100;
+				clock_t start = clock();
+				for (int i = 0; i < numResets; i++)
+				{
+					simulation.restoreState(state);
+				}
+				const double restoreSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+				start = clock();
+				for (int i = 0; i < numResets; i++)
+				{
+					simulation.reset();
+				}
+				const double resetSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+				std::cout << "restoreState: " << 1.0e6 * restoreSeconds / numResets
+				          << " us, reset: " << 1.0e6 * resetSeconds / numResets
+				          << " us, state of " << state.size() << " values" << std::endl;
+	}
+
+	/**
+	 * Records the positions of the prism's rods every recordInterval
+	 * steps, for numSteps steps.
+	 */
+	std::vector<btVector3> recordRun(tgSimulation& simulation,
+	                                 const PrismModel& model, int numSteps)
+	{
+		const int recordInterval = 100;
+		std::vector<btVector3> positions;
+		for (int i = 0; i < numSteps; i += recordInterval)
+		{
+			simulation.run(recordInterval);
+			const std::vector<btVector3> p = model.getPositions();
+			positions.insert(positions.end(), p.begin(), p.end());
+		}
+		return positions;
+	}
+
+	TEST_F(StateRestoreTest, RestoreMatchesUninterruptedRun) {
+
+				const int warmupSteps = 500;
+				const int branchSteps = 2000;
+
+				// No gravity and no ground, so nothing touches and there
+				// are no contact caches for the restore to clear. The sine
+				// wave spins the prism, so its inertia turns with it
+				const tgWorld::Config config(0.0);
+				tgWorld world(config, new tgEmptyGround());
+				tgSimView view(world, 1.0/1000.0, 1.0/60.0);
+
+				// Must outlive the simulation, which tears the model down
+				SineController controller;
+				tgSimulation simulation(view);
+
+				PrismModel* myModel = new PrismModel();
+				myModel->attach(&controller);
+				simulation.addModel(myModel);
+
+				simulation.run(warmupSteps);
+
+				// Save and keep running
+				tgSimulationState state = simulation.saveState();
+				const std::vector<btVector3> uninterrupted =
+					recordRun(simulation, *myModel, branchSteps);
+
+				// Run on elsewhere, then come back and run again
+				simulation.run(branchSteps);
+				simulation.restoreState(state);
+				const std::vector<btVector3> resumed =
+					recordRun(simulation, *myModel, branchSteps);
+
+				ASSERT_EQ(uninterrupted.size(), resumed.size());
+				for (std::size_t i = 0; i < uninterrupted.size(); i++)
+				{
+					EXPECT_NEAR(uninterrupted[i].x(), resumed[i].x(), 1.0e-9);
+					EXPECT_NEAR(uninterrupted[i].y(), resumed[i].y(), 1.0e-9);
+					EXPECT_NEAR(uninterrupted[i].z(), resumed[i].z(), 1.0e-9);
+				}
+	}
+
+	TEST_F(StateRestoreTest, PIDControlledTrajectoriesMatch) {
+
+				const int warmupSteps = 2000;
+				const int branchSteps = 3000;
+				const int recordInterval = 100;
+
+				// Sine waves through the impedance and PID controllers, so
+				// the trajectory depends on the PID's error history. These
+				// must outlive the simulation, which tears the model down
+				tgImpedanceController impedanceControl(100.0, 300.0, 10.0);
+				const tgPIDController::Config pidConfig(100.0, 10.0, 10.0, true);
+				std::vector<tgSCASineControl*> controllers;
+
+				std::vector<btVector3> first;
+				std::vector<btVector3> second;
+				std::vector<double> firstTension;
+				std::vector<double> secondTension;
+				{
+					const tgWorld::Config config(98.1);
+					tgWorld world(config, new tgBoxGround());
+					tgSimView view(world, 1.0/1000.0, 1.0/60.0);
+					tgSimulation simulation(view);
+
+					PrismModel* myModel = new PrismModel(true);
+					simulation.addModel(myModel);
+
+					for (std::size_t i = 0; i < myModel->m_allMuscles.size(); i++)
+					{
+						tgSpringCableActuator* const muscle = myModel->m_allMuscles[i];
+						tgSCASineControl* const controller =
+							new tgSCASineControl(0.01, &impedanceControl, pidConfig,
+							                     1.0, 0.5, i, 0.0,
+							                     muscle->getStartLength());
+						muscle->attach(controller);
+						controllers.push_back(controller);
+					}
+
+					simulation.run(warmupSteps);
+
+					// Save, step, restore and step again, recording both
+					// runs. The first restore only clears Bullet's caches,
+					// which the warmup filled, so both runs start alike
+					tgSimulationState state = simulation.saveState();
+					simulation.restoreState(state);
+					for (int i = 0; i < branchSteps; i += recordInterval)
+					{
+						simulation.run(recordInterval);
+						const std::vector<btVector3> positions = myModel->getPositions();
+						first.insert(first.end(), positions.begin(), positions.end());
+						firstTension.push_back(controllers[0]->getCommandedTension());
+					}
+
+					simulation.restoreState(state);
+					for (int i = 0; i < branchSteps; i += recordInterval)
+					{
+						simulation.run(recordInterval);
+						const std::vector<btVector3> positions = myModel->getPositions();
+						second.insert(second.end(), positions.begin(), positions.end());
+						secondTension.push_back(controllers[0]->getCommandedTension());
+					}
+				}
+
+				for (std::size_t i = 0; i < controllers.size(); i++)
+				{
+					delete controllers[i];
+				}
+
+				ASSERT_EQ(first.size(), second.size());
+				for (std::size_t i = 0; i < first.size(); i++)
+				{
+					EXPECT_NEAR(first[i].x(), second[i].x(), 1.0e-9);
+					EXPECT_NEAR(first[i].y(), second[i].y(), 1.0e-9);
+					EXPECT_NEAR(first[i].z(), second[i].z(), 1.0e-9);
+				}
+				ASSERT_EQ(firstTension.size(), secondTension.size());
+				for (std::size_t i = 0; i < firstTension.size(); i++)
+				{
+					EXPECT_NEAR(firstTension[i], secondTension[i], 1.0e-9);
+				}
+	}
+
+	TEST_F(StateRestoreTest, RejectsStateFromChangedSimulation) {
+
+				const tgWorld::Config config(98.1);
+				tgWorld world(config, new tgBoxGround());
+				tgSimView view(world, 1.0/1000.0, 1.0/60.0);
+				tgSimulation simulation(view);
+
+				simulation.addModel(new PrismModel());
+				tgSimulationState state = simulation.saveState();
+
+				simulation.addModel(new PrismModel());
+				EXPECT_THROW(simulation.restoreState(state), std::runtime_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
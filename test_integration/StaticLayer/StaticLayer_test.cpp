@@ -0,0 +1,200 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file StaticLayer_test.cpp
+* @brief Checks that a world with a persistent static layer keeps its
+* ground and obstacles across resets, that every episode after a reset
+* runs the same, and times resets with and without the layer.
+* $Id$
+*/
+
+// This application
+#include "helpers/DroppedRodsModel.h"
+// This library
+#include "core/tgBulletUtil.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgBoxGround.h"
+#include "core/terrain/tgHillyGround.h"
+#include "models/obstacles/tgBlockField.h"
+
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Rods dropped onto the hills and blocks. */
+	std::vector<btVector3> rodStarts()
+	{
+		std::vector<btVector3> starts;
+		for (int i = 0; i < 10; i++)
+		{
+			const double x = -9.0 + 2.0 * i;
+			const double z = (i % 3) - 1.0;
+			starts.push_back(btVector3(x - 0.5, 4.0, z));
+		}
+		return starts;
+	}
+
+	/** Hills in meters, big enough for their BVH to take a while. */
+	tgHillyGround* createHills()
+	{
+		const tgHillyGround::Config config(btVector3(0.0, 0.0, 0.0),
+										   0.8, 0.0,
+										   btVector3(0.0, 0.1, 0.0),
+										   btVector3(0.0, 0.0, 0.0),
+										   300, 300, 0.05, 0.5, 0.3, 0.0);
+		return new tgHillyGround(config);
+	}
+
+	tgBlockField* createBlocks()
+	{
+		tgBlockField::Config config(btVector3(0.0, 0.0, 0.0), 0.8, 0.0,
+									btVector3(-20.0, 0.0, -20.0),
+									btVector3(20.0, 0.0, 20.0),
+									500, 0.5, 0.5, 0.5);
+		return new tgBlockField(config);
+	}
+
+	int numCollisionObjects(tgWorld& world)
+	{
+		return tgBulletUtil::worldToDynamicsWorld(world).getNumCollisionObjects();
+	}
+
+	const double stepSize = 1.0/1000.0; // Seconds
+	const double renderRate = 1.0/60.0; // Seconds
+	const int numSteps = 2000;
+
+	class StaticLayerTest : public ::testing::Test {
+		protected:
+
+			StaticLayerTest() {
+
+			}
+
+			virtual ~StaticLayerTest() {
+			}
+	};
+
+	TEST_F(StaticLayerTest, EpisodesRepeat) {
+
+				tgWorld::Config config(9.81);
+				config.persistentStaticLayer = true;
+				tgWorld world(config, createHills());
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				DroppedRodsModel* myModel = new DroppedRodsModel(rodStarts());
+				simulation.addModel(myModel);
+				simulation.addObstacle(createBlocks());
+
+				const int numObjects = numCollisionObjects(world);
+
+				simulation.run(numSteps);
+
+				const clock_t start = clock();
+				simulation.reset();
+				std::cout << "Reset keeping the static layer in "
+				          << double(clock() - start) / CLOCKS_PER_SEC << " s"
+				          << std::endl;
+
+				// The blocks were kept, and the rods rebuilt
+				EXPECT_EQ(numObjects, numCollisionObjects(world));
+
+				// The first episode added the rods before the blocks, so
+				// compare the episodes that follow resets
+				simulation.run(numSteps);
+				const std::vector<btVector3> second = myModel->rodCenters();
+
+				simulation.reset();
+				simulation.run(numSteps);
+				const std::vector<btVector3> third = myModel->rodCenters();
+
+				ASSERT_EQ(second.size(), third.size());
+				for (std::size_t i = 0; i < second.size(); i++)
+				{
+					// Every rod must have landed rather than fallen through
+					EXPECT_GT(second[i].y(), -1.0);
+					EXPECT_DOUBLE_EQ(second[i].x(), third[i].x());
+					EXPECT_DOUBLE_EQ(second[i].y(), third[i].y());
+					EXPECT_DOUBLE_EQ(second[i].z(), third[i].z());
+				}
+	}
+
+	TEST_F(StaticLayerTest, RebuiltResetTiming) {
+
+				tgWorld::Config config(9.81);
+				tgWorld world(config, createHills());
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				simulation.addModel(new DroppedRodsModel(rodStarts()));
+				simulation.addObstacle(createBlocks());
+				simulation.run(numSteps);
+
+				// Rebuilding the world also means building the blocks again
+				const clock_t start = clock();
+				simulation.reset();
+				simulation.addObstacle(createBlocks());
+				std::cout << "Reset rebuilding the world in "
+				          << double(clock() - start) / CLOCKS_PER_SEC << " s"
+				          << std::endl;
+
+				simulation.run(numSteps);
+	}
+
+	TEST_F(StaticLayerTest, NewGroundDropsObstacles) {
+
+				tgWorld::Config config(9.81);
+				config.persistentStaticLayer = true;
+				tgWorld world(config, createHills());
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				simulation.addModel(new DroppedRodsModel(rodStarts()));
+				const int withoutBlocks = numCollisionObjects(world);
+				simulation.addObstacle(createBlocks());
+				EXPECT_LT(withoutBlocks, numCollisionObjects(world));
+
+				simulation.run(100);
+
+				// Another ground with one body, like the hills
+				simulation.reset(new tgBoxGround());
+				EXPECT_EQ(withoutBlocks, numCollisionObjects(world));
+
+				simulation.run(100);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
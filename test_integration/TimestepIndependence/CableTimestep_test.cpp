@@ -0,0 +1,307 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file CableTimestep_test.cpp
+* @brief Compares how the explicit and constraint spring cables keep
+* their accuracy as the time step grows, for a rod hanging on two stiff
+* cables.
+* $Id$
+*/
+
+// This library
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBasicConstraintCableInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Cable stiffness and damping, N/m and N*s/m */
+	const double cableStiffness = 100000.0;
+	const double cableDamping = 100.0;
+
+	const double gravity = 9.81;
+
+	/**
+	 * A rod hanging from a fixed rod by a stiff, damped cable at each
+	 * end. Its cables ring with a period of about 11 ms, so explicit
+	 * cables need steps of a few ms or less.
+	 */
+	class HangingRodModel : public tgModel
+	{
+	public:
+
+		HangingRodModel(bool constraintCables) :
+			m_constraintCables(constraintCables),
+			m_rod(NULL)
+		{
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure s;
+			s.addNode(-1.0, 10.0, 0.0);
+			s.addNode( 1.0, 10.0, 0.0);
+			s.addNode(-1.0, 5.0, 0.0);
+			s.addNode( 1.0, 5.0, 0.0);
+
+			s.addPair(0, 1, "fixed");
+			s.addPair(2, 3, "hanging");
+			s.addPair(0, 2, "cable");
+			s.addPair(1, 3, "cable");
+
+			// Zero density makes the rod static
+			const tgRod::Config fixedConfig(0.1, 0.0);
+			const tgRod::Config hangingConfig(0.1, 10.0);
+			tgBasicActuator::Config cableConfig(cableStiffness, cableDamping);
+
+			tgBuildSpec spec;
+			spec.addBuilder("fixed", new tgRodInfo(fixedConfig));
+			spec.addBuilder("hanging", new tgRodInfo(hangingConfig));
+			if (m_constraintCables)
+			{
+				spec.addBuilder("cable", new tgBasicConstraintCableInfo(cableConfig));
+			}
+			else
+			{
+				spec.addBuilder("cable", new tgBasicActuatorInfo(cableConfig));
+			}
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+
+			m_rod = find<tgRod>("hanging")[0];
+			m_heights.clear();
+		}
+
+		/** Records the hanging rod's height after every step */
+		virtual void step(double dt)
+		{
+			tgModel::step(dt);
+			m_heights.push_back(m_rod->centerOfMass().y());
+		}
+
+		const std::vector<double>& heights() const
+		{
+			return m_heights;
+		}
+
+	private:
+		const bool m_constraintCables;
+
+		tgRod* m_rod;
+
+		std::vector<double> m_heights;
+	};
+
+	/** Where the hanging rod is at the end of a run, and how it got there. */
+	struct HangingState
+	{
+		btVector3 center;
+
+		double tension;
+
+		double mass;
+
+		std::vector<double> heights;
+	};
+
+	HangingState runHangingRod(bool constraintCables, double stepSize,
+	                           double duration = 1.0)
+	{
+		tgWorld::Config config(gravity);
+		// Constraint cables need it, so the explicit ones use it too
+		config.solverType = tgWorld::Config::eSequentialImpulse;
+		tgEmptyGround* ground = new tgEmptyGround();
+		tgWorld world(config, ground);
+
+		const double renderRate = 1.0/60.0; // Seconds
+		tgSimView view(world, stepSize, renderRate);
+
+		tgSimulation simulation(view);
+
+		HangingRodModel* myModel = new HangingRodModel(constraintCables);
+		simulation.addModel(myModel);
+
+		const int numSteps = static_cast<int>(duration / stepSize + 0.5);
+		const clock_t start = clock();
+		simulation.run(numSteps);
+		const double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+		const std::vector<tgRod*> rods = myModel->find<tgRod>("hanging");
+		const std::vector<tgSpringCableActuator*> cables =
+			myModel->find<tgSpringCableActuator>("cable");
+
+		HangingState state;
+		state.center = rods[0]->centerOfMass();
+		state.tension = cables[0]->getTension();
+		state.mass = rods[0]->mass();
+		state.heights = myModel->heights();
+
+		std::cout << (constraintCables ? "Constraint" : "Explicit")
+		          << " cables, dt " << stepSize << " s: "
+		          << numSteps << " steps in " << seconds << " s, rod at "
+		          << state.center.y() << ", tension " << state.tension
+		          << std::endl;
+		return state;
+	}
+
+	/** Where the rod comes to rest: each cable carries half its weight */
+	double restingHeight(double mass)
+	{
+		return 5.0 - mass * gravity / (2.0 * cableStiffness);
+	}
+
+	/**
+	 * Measures the period of the rod's vertical ringing from the times
+	 * it crosses its resting height, interpolated between steps.
+	 * @return the time from the first crossing to the third, or a
+	 * negative number if the rod crosses fewer than three times.
+	 */
+	double ringingPeriod(const std::vector<double>& heights,
+	                     double restHeight, double stepSize)
+	{
+		std::vector<double> crossings;
+		for (std::size_t i = 1; i < heights.size(); i++)
+		{
+			const double before = heights[i - 1] - restHeight;
+			const double after = heights[i] - restHeight;
+			if ((before > 0.0) != (after > 0.0))
+			{
+				const double fraction = before / (before - after);
+				crossings.push_back(stepSize * (i + fraction));
+			}
+		}
+		return crossings.size() < 3 ? -1.0 : crossings[2] - crossings[0];
+	}
+
+	class CableTimestepTest : public ::testing::Test {
+		protected:
+
+			CableTimestepTest() {
+
+			}
+
+			virtual ~CableTimestepTest() {
+			}
+	};
+
+	TEST_F(CableTimestepTest, AccuracyVersusStep) {
+
+				// Explicit cables at a tenth of a millisecond
+				const HangingState reference = runHangingRod(false, 0.0001);
+				const double restHeight = restingHeight(reference.mass);
+
+				const double steps[] = {0.001, 0.002, 0.005, 0.01};
+				const int numStepSizes = sizeof(steps) / sizeof(steps[0]);
+
+				// The rod weighs about 6 N and sags about 31 um, so a
+				// cable with the wrong stiffness misses by far more than this
+				const double tol = 2.0e-6;
+				const double tensionTol = cableStiffness * tol;
+
+				EXPECT_NEAR(restHeight, reference.center.y(), tol);
+				EXPECT_NEAR(reference.mass * gravity / 2.0, reference.tension,
+				            tensionTol);
+
+				for (int i = 0; i < numStepSizes; i++)
+				{
+					const HangingState explicitState = runHangingRod(false, steps[i]);
+					const HangingState constraintState = runHangingRod(true, steps[i]);
+
+					std::cout << "dt " << steps[i] << " s: explicit error "
+					          << (explicitState.center - reference.center).length()
+					          << ", constraint error "
+					          << (constraintState.center - reference.center).length()
+					          << std::endl;
+
+					// Only the constraint cables must hold at every step
+					EXPECT_NEAR(reference.center.x(), constraintState.center.x(), tol);
+					EXPECT_NEAR(restHeight, constraintState.center.y(), tol);
+					EXPECT_NEAR(reference.center.z(), constraintState.center.z(), tol);
+					EXPECT_NEAR(reference.tension, constraintState.tension, tensionTol);
+				}
+	}
+
+	TEST_F(CableTimestepTest, RingingFrequency) {
+
+				const double stepSize = 0.0001;
+				const double duration = 0.05;
+
+				const HangingState explicitState =
+					runHangingRod(false, stepSize, duration);
+				const HangingState constraintState =
+					runHangingRod(true, stepSize, duration);
+
+				// Two cables in parallel on the rod's mass
+				const double mass = constraintState.mass;
+				const double naturalFrequency =
+					std::sqrt(2.0 * cableStiffness / mass);
+				const double dampingRatio =
+					cableDamping / std::sqrt(2.0 * cableStiffness * mass);
+				const double expectedPeriod = 2.0 * M_PI /
+					(naturalFrequency * std::sqrt(1.0 - dampingRatio * dampingRatio));
+
+				const double restHeight = restingHeight(mass);
+				const double explicitPeriod =
+					ringingPeriod(explicitState.heights, restHeight, stepSize);
+				const double constraintPeriod =
+					ringingPeriod(constraintState.heights, restHeight, stepSize);
+
+				std::cout << "Ringing period: expected " << expectedPeriod
+				          << " s, explicit " << explicitPeriod
+				          << " s, constraint " << constraintPeriod << " s"
+				          << std::endl;
+
+				const double periodTol = 0.02 * expectedPeriod;
+				EXPECT_NEAR(expectedPeriod, explicitPeriod, periodTol);
+				EXPECT_NEAR(expectedPeriod, constraintPeriod, periodTol);
+				EXPECT_NEAR(explicitPeriod, constraintPeriod, periodTol);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+#ifndef TEST_INTEGRATION_DROPPED_RODS_MODEL_H
+#define TEST_INTEGRATION_DROPPED_RODS_MODEL_H
+
+/**
+* @file DroppedRodsModel.h
+* @brief Loose rods for the integration tests of grounds and obstacles
+* $Id$
+*/
+
+// This library
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <vector>
+
+/**
+ * Unconnected rods, each a body of its own, to drop onto a ground.
+ * Each rod runs one unit along x and half a unit along z from where
+ * it starts, so it lands at a slant.
+ */
+class DroppedRodsModel : public tgModel
+{
+public:
+
+	/**
+	 * @param[in] starts where each rod's first end is, in the order
+	 * the rods are found
+	 */
+	DroppedRodsModel(const std::vector<btVector3>& starts) :
+		m_starts(starts)
+	{
+	}
+
+	virtual void setup(tgWorld& world)
+	{
+		tgStructure s;
+		for (std::size_t i = 0; i < m_starts.size(); i++)
+		{
+			const btVector3& start = m_starts[i];
+			const btVector3 end = start + btVector3(1.0, 0.0, 0.5);
+			s.addNode(start.x(), start.y(), start.z());
+			s.addNode(end.x(), end.y(), end.z());
+			s.addPair(2 * i, 2 * i + 1, "rod");
+		}
+
+		const tgRod::Config rodConfig(0.1, 100.0, 0.8);
+
+		tgBuildSpec spec;
+		spec.addBuilder("rod", new tgRodInfo(rodConfig));
+
+		tgStructureInfo structureInfo(s, spec);
+		structureInfo.buildInto(*this, world);
+
+		tgModel::setup(world);
+	}
+
+	/** Where the rods are now */
+	std::vector<btVector3> rodCenters()
+	{
+		const std::vector<tgRod*> rods = find<tgRod>("rod");
+		std::vector<btVector3> centers;
+		for (std::size_t i = 0; i < rods.size(); i++)
+		{
+			centers.push_back(rods[i]->centerOfMass());
+		}
+		return centers;
+	}
+
+private:
+	const std::vector<btVector3> m_starts;
+};
+
+#endif // TEST_INTEGRATION_DROPPED_RODS_MODEL_H
@@ -0,0 +1,88 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+#ifndef TEST_INTEGRATION_TETRA_SPINE_H
+#define TEST_INTEGRATION_TETRA_SPINE_H
+
+/**
+* @file TetraSpine.h
+* @brief The tetrahedral spine shared by the integration tests
+* $Id$
+*/
+
+// This library
+#include "core/tgString.h"
+#include "tgcreator/tgNodes.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgUtil.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cmath>
+#include <vector>
+
+/**
+ * Add a spine like TetraSpineLearningModel's to spine: numSegments
+ * children tagged "segment num<i>" with six "rod" pairs meeting at four
+ * nodes, and six "muscle" pairs from each segment to the next. The
+ * builders are left to the test, so it can choose the cables.
+ */
+inline void addTetraSpine(tgStructure& spine, int numSegments)
+{
+	const double edge = 38.1;
+	const double height = tgUtil::round(std::sqrt(3.0) / 2 * edge);
+
+	tgStructure tetra;
+	tetra.addNode(-edge / 2.0, 0, 0);
+	tetra.addNode( edge / 2.0, 0, 0);
+	tetra.addNode(0, height, 0);
+	tetra.addNode(0, height / 2.0, tgUtil::round(std::sqrt(3.0) / 2.0 * height));
+
+	tetra.addPair(0, 1, "rod");
+	tetra.addPair(0, 2, "rod");
+	tetra.addPair(0, 3, "rod");
+	tetra.addPair(1, 2, "rod");
+	tetra.addPair(1, 3, "rod");
+	tetra.addPair(2, 3, "rod");
+
+	const btVector3 offset(0, 0, -edge * 0.75);
+	for (int i = 0; i < numSegments; i++)
+	{
+		tgStructure* const t = new tgStructure(tetra);
+		t->addTags(tgString("segment num", i + 1));
+		t->move((i + 1) * offset);
+		spine.addChild(t);
+	}
+
+	const std::vector<tgStructure*> children = spine.getChildren();
+	for (std::size_t i = 1; i < children.size(); i++)
+	{
+		tgNodes n0 = children[i-1]->getNodes();
+		tgNodes n1 = children[i  ]->getNodes();
+
+		spine.addPair(n0[0], n1[0], "muscle");
+		spine.addPair(n0[1], n1[1], "muscle");
+		spine.addPair(n0[2], n1[2], "muscle");
+		spine.addPair(n0[0], n1[3], "muscle");
+		spine.addPair(n0[1], n1[3], "muscle");
+		spine.addPair(n0[2], n1[3], "muscle");
+	}
+}
+
+#endif // TEST_INTEGRATION_TETRA_SPINE_H